@@ -0,0 +1,259 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIAnimClip.h"
+
+
+#define BINARY_HEADER_SIZE 16
+#define BINARY_SEGMENT_SIZE 44
+
+
+namespace
+{
+	struct EaseEntry
+	{
+		const char* m_pcName;
+		pfEase m_pfEase;
+	};
+
+	// Append only, indices are stored in compiled clips
+	const EaseEntry s_atEases[] =
+	{
+		{ "Linear", Easing::Linear::EaseIn },
+		{ "Linear.EaseIn", Easing::Linear::EaseIn }, { "Linear.EaseOut", Easing::Linear::EaseOut }, { "Linear.EaseInOut", Easing::Linear::EaseInOut },
+		{ "Quartic.EaseIn", Easing::Quartic::EaseIn }, { "Quartic.EaseOut", Easing::Quartic::EaseOut }, { "Quartic.EaseInOut", Easing::Quartic::EaseInOut },
+		{ "Quintic.EaseIn", Easing::Quintic::EaseIn }, { "Quintic.EaseOut", Easing::Quintic::EaseOut }, { "Quintic.EaseInOut", Easing::Quintic::EaseInOut },
+		{ "Sinusoidal.EaseIn", Easing::Sinusoidal::EaseIn }, { "Sinusoidal.EaseOut", Easing::Sinusoidal::EaseOut }, { "Sinusoidal.EaseInOut", Easing::Sinusoidal::EaseInOut },
+		{ "Exponential.EaseIn", Easing::Exponential::EaseIn }, { "Exponential.EaseOut", Easing::Exponential::EaseOut }, { "Exponential.EaseInOut", Easing::Exponential::EaseInOut },
+		{ "Circular.EaseIn", Easing::Circular::EaseIn }, { "Circular.EaseOut", Easing::Circular::EaseOut }, { "Circular.EaseInOut", Easing::Circular::EaseInOut },
+		{ "Back.EaseIn", Easing::Back::EaseIn }, { "Back.EaseOut", Easing::Back::EaseOut }, { "Back.EaseInOut", Easing::Back::EaseInOut },
+		{ "Bounce.EaseIn", Easing::Bounce::EaseIn }, { "Bounce.EaseOut", Easing::Bounce::EaseOut }, { "Bounce.EaseInOut", Easing::Bounce::EaseInOut },
+		{ "Elastic.EaseIn", Easing::Elastic::EaseIn }, { "Elastic.EaseOut", Easing::Elastic::EaseOut }, { "Elastic.EaseInOut", Easing::Elastic::EaseInOut }
+	};
+	const unsigned int s_uiNumEases = sizeof(s_atEases) / sizeof(s_atEases[0]);
+
+	const char* s_apcProperties[GAP_COUNT] = { "position", "scale", "angles", "alpha", "color" };
+
+	int FindProperty( const char* pcName )
+	{
+		for ( int i = 0; i < GAP_COUNT; i++ )
+			if ( strcmp( s_apcProperties[i], pcName ) == 0 ) return i;
+		return -1;
+	}
+
+	// False for NaN and infinities
+	bool IsFinite( const float fValue ) { return fValue - fValue == 0.f; }
+	bool IsFinite( const hkvVec4& v4Value ) { return IsFinite( v4Value.x ) && IsFinite( v4Value.y ) && IsFinite( v4Value.z ) && IsFinite( v4Value.w ); }
+	bool IsValidTime( const float fTime ) { return fTime >= 0.f && IsFinite( fTime ); }
+
+	// Number or array of up to 4 numbers, false if malformed
+	bool ReadValue( const rapidjson::Value& value, hkvVec4& v4Value )
+	{
+		float afValue[4] = { 0.f, 0.f, 0.f, 0.f };
+		if ( value.IsNumber() )
+		{
+			afValue[0] = static_cast<float>(value.GetDouble());
+		}
+		else if ( value.IsArray() && value.Size() <= 4 )
+		{
+			for ( unsigned int i = 0; i < value.Size(); i++ )
+			{
+				if ( !value[i].IsNumber() ) return false;
+				afValue[i] = static_cast<float>(value[i].GetDouble());
+			}
+		}
+		else
+		{
+			return false;
+		}
+		v4Value.set( afValue[0], afValue[1], afValue[2], afValue[3] );
+		return IsFinite( v4Value );
+	}
+
+	// Time, value and ease of one JSON key, false if malformed
+	bool ReadKey( const rapidjson::Value& key, float& fTime, hkvVec4& v4Value, int& iEase )
+	{
+		if ( !key.IsObject() || !key.HasMember( "time" ) || !key.HasMember( "value" ) || !key["time"].IsNumber() ) return false;
+		fTime = static_cast<float>(key["time"].GetDouble());
+		if ( !IsValidTime( fTime ) || !ReadValue( key["value"], v4Value ) ) return false;
+		iEase = 0;
+		if ( !key.HasMember( "ease" ) ) return true;
+		if ( !key["ease"].IsString() ) return false;
+		iEase = GUIAnimClip::FindEase( key["ease"].GetString() );
+		return iEase >= 0;
+	}
+
+	void WriteBytes( char*& pcCursor, const void* pData, const unsigned int uiSize ) { memcpy( pcCursor, pData, uiSize ); pcCursor += uiSize; }
+	void ReadBytes( const char*& pcCursor, void* pData, const unsigned int uiSize ) { memcpy( pData, pcCursor, uiSize ); pcCursor += uiSize; }
+}
+
+
+GUIAnimClip::GUIAnimClip()
+{
+	m_aSegments.Init( Segment() );
+	m_uiNumSegments = 0;
+	m_fDuration = 0.f;
+}
+
+GUIAnimClip::~GUIAnimClip()
+{
+	m_aSegments.Reset();
+}
+
+void GUIAnimClip::Clear()
+{
+	m_uiNumSegments = 0;
+	m_fDuration = 0.f;
+}
+
+int GUIAnimClip::FindEase( const char* pcName )
+{
+	for ( unsigned int i = 0; i < s_uiNumEases; i++ )
+		if ( strcmp( s_atEases[i].m_pcName, pcName ) == 0 ) return static_cast<int>(i);
+	return -1;
+}
+
+pfEase GUIAnimClip::GetEaseMethod( const unsigned int uiEase )
+{
+	return ( uiEase < s_uiNumEases ) ? s_atEases[uiEase].m_pfEase : Easing::Linear::EaseIn;
+}
+
+void GUIAnimClip::AddSegment( const eGUIAnimProperty eProperty, const float fStartTime, const float fDuration, const hkvVec4& v4Start, const hkvVec4& v4Target, const unsigned int uiEase )
+{
+	m_aSegments.EnsureSize( m_uiNumSegments + 1 );
+	Segment& tSegment = m_aSegments.GetDataPtr()[ m_uiNumSegments++ ];
+	tSegment.m_eProperty = eProperty;
+	tSegment.m_fStartTime = fStartTime;
+	tSegment.m_fDuration = hkvMath::Max( fDuration, 0.f );
+	tSegment.m_v4Start = v4Start;
+	tSegment.m_v4Target = v4Target;
+	tSegment.m_uiEase = ( uiEase < s_uiNumEases ) ? uiEase : 0;
+	tSegment.m_pfEase = GetEaseMethod( tSegment.m_uiEase );
+	m_fDuration = hkvMath::Max( m_fDuration, fStartTime + tSegment.m_fDuration );
+}
+
+/*
+	The whole clip is rejected on malformed data: unknown property or ease, key without time or value, negative or
+	non finite time, keys of a track out of time order. Tracks with less than two keys add no segment
+*/
+bool GUIAnimClip::LoadJSON( const char* pcContent )
+{
+	Clear();
+
+	rapidjson::Document jsonDoc;
+	jsonDoc.Parse<0>( pcContent );
+	if ( jsonDoc.HasParseError() || !jsonDoc.IsObject() || !jsonDoc.HasMember( "tracks" ) ) return false;
+
+	const rapidjson::Value& tracks = jsonDoc["tracks"];
+	if ( !tracks.IsArray() ) return false;
+
+	for ( unsigned int i = 0; i < tracks.Size(); i++ )
+	{
+		const rapidjson::Value& track = tracks[i];
+		const int iProperty = ( track.IsObject() && track.HasMember( "property" ) && track["property"].IsString() ) ? FindProperty( track["property"].GetString() ) : -1;
+		if ( iProperty < 0 || !track.HasMember( "keys" ) || !track["keys"].IsArray() )
+		{
+			Clear();
+			return false;
+		}
+
+		const rapidjson::Value& keys = track["keys"];
+		float fPrevTime = 0.f;
+		hkvVec4 v4PrevValue;
+		for ( unsigned int k = 0; k < keys.Size(); k++ )
+		{
+			float fTime;
+			hkvVec4 v4Value;
+			int iEase;
+			if ( !ReadKey( keys[k], fTime, v4Value, iEase ) || ( k > 0 && fTime < fPrevTime ) )
+			{
+				Clear();
+				return false;
+			}
+			if ( k > 0 ) AddSegment( static_cast<eGUIAnimProperty>(iProperty), fPrevTime, fTime - fPrevTime, v4PrevValue, v4Value, static_cast<unsigned int>(iEase) );
+			fPrevTime = fTime;
+			v4PrevValue = v4Value;
+		}
+	}
+	return true;
+}
+
+/*
+	Same rules as the JSON form: a segment with an unknown property or ease, a negative or non finite time or a non
+	finite value rejects the whole clip
+*/
+bool GUIAnimClip::LoadBinary( const char* pcData, const unsigned int uiSize )
+{
+	Clear();
+	if ( !pcData || uiSize < BINARY_HEADER_SIZE || memcmp( pcData, "GUIC", 4 ) != 0 ) return false;
+
+	const char* pcCursor = pcData + 4;
+	unsigned int uiVersion = 0, uiNumSegments = 0;
+	float fDuration = 0.f;
+	ReadBytes( pcCursor, &uiVersion, 4 );
+	ReadBytes( pcCursor, &uiNumSegments, 4 );
+	ReadBytes( pcCursor, &fDuration, 4 );
+	// Segment count checked by division, a corrupt count could overflow the multiplication
+	if ( uiVersion != GUIANIMCLIP_BINARY_VERSION || uiNumSegments > ( uiSize - BINARY_HEADER_SIZE ) / BINARY_SEGMENT_SIZE ) return false;
+
+	m_aSegments.EnsureSize( uiNumSegments );
+	for ( unsigned int i = 0; i < uiNumSegments; i++ )
+	{
+		unsigned char aucInfo[4];
+		float fStartTime, fSegmentDuration;
+		float afStart[4], afTarget[4];
+		ReadBytes( pcCursor, aucInfo, 4 );
+		ReadBytes( pcCursor, &fStartTime, 4 );
+		ReadBytes( pcCursor, &fSegmentDuration, 4 );
+		ReadBytes( pcCursor, afStart, 16 );
+		ReadBytes( pcCursor, afTarget, 16 );
+		const hkvVec4 v4Start( afStart[0], afStart[1], afStart[2], afStart[3] );
+		const hkvVec4 v4Target( afTarget[0], afTarget[1], afTarget[2], afTarget[3] );
+		if ( aucInfo[0] >= GAP_COUNT || aucInfo[1] >= s_uiNumEases || !IsValidTime( fStartTime ) || !IsValidTime( fSegmentDuration ) || !IsFinite( v4Start ) || !IsFinite( v4Target ) )
+		{
+			Clear();
+			return false;
+		}
+		AddSegment( static_cast<eGUIAnimProperty>(aucInfo[0]), fStartTime, fSegmentDuration, v4Start, v4Target, aucInfo[1] );
+	}
+	if ( !IsValidTime( fDuration ) )
+	{
+		Clear();
+		return false;
+	}
+	m_fDuration = hkvMath::Max( m_fDuration, fDuration );
+	return true;
+}
+
+bool GUIAnimClip::SaveBinary( const std::string& sFilepath ) const
+{
+	const unsigned int uiSize = BINARY_HEADER_SIZE + m_uiNumSegments * BINARY_SEGMENT_SIZE;
+	char* pcData = new char[uiSize];
+	char* pcCursor = pcData;
+
+	const unsigned int uiVersion = GUIANIMCLIP_BINARY_VERSION;
+	WriteBytes( pcCursor, "GUIC", 4 );
+	WriteBytes( pcCursor, &uiVersion, 4 );
+	WriteBytes( pcCursor, &m_uiNumSegments, 4 );
+	WriteBytes( pcCursor, &m_fDuration, 4 );
+	for ( unsigned int i = 0; i < m_uiNumSegments; i++ )
+	{
+		const Segment& tSegment = m_aSegments.GetDataPtr()[i];
+		const unsigned char aucInfo[4] = { static_cast<unsigned char>(tSegment.m_eProperty), static_cast<unsigned char>(tSegment.m_uiEase), 0, 0 };
+		const float afStart[4] = { tSegment.m_v4Start.x, tSegment.m_v4Start.y, tSegment.m_v4Start.z, tSegment.m_v4Start.w };
+		const float afTarget[4] = { tSegment.m_v4Target.x, tSegment.m_v4Target.y, tSegment.m_v4Target.z, tSegment.m_v4Target.w };
+		WriteBytes( pcCursor, aucInfo, 4 );
+		WriteBytes( pcCursor, &tSegment.m_fStartTime, 4 );
+		WriteBytes( pcCursor, &tSegment.m_fDuration, 4 );
+		WriteBytes( pcCursor, afStart, 16 );
+		WriteBytes( pcCursor, afTarget, 16 );
+	}
+
+	bool bSaved = false;
+	IVFileOutStream* pOut = Vision::File.Create( sFilepath.c_str() );
+	if ( pOut )
+	{
+		bSaved = ( pOut->Write( pcData, uiSize ) == uiSize );
+		pOut->Close();
+	}
+	delete[] pcData;
+	return bSaved;
+}
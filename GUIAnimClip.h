@@ -0,0 +1,74 @@
+#ifndef GUIANIMCLIP_H_INCLUDED
+#define GUIANIMCLIP_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include <string>
+
+
+#define GUIANIMCLIP_JSON_EXTENSION ".json"
+#define GUIANIMCLIP_BINARY_EXTENSION ".guic"
+#define GUIANIMCLIP_BINARY_VERSION 1
+
+
+/*
+	Property keyframes and easing loaded from a file and decoded once into flat segments (one per pair of
+	consecutive keys). Playing a clip copies its segments into a timeline, no parsing nor lookup at play time.
+	Clips are loaded and cached by GUIAnimationManager, one decoded clip is shared by every element playing it.
+
+	JSON source:
+	{ "tracks": [ { "property": "alpha", "keys": [ { "time": 0, "value": 0 }, { "time": 0.3, "value": 255, "ease": "Quartic.EaseOut" } ] },
+	              { "property": "position", "keys": [ { "time": 0, "value": [0.5, 1.2] }, { "time": 0.4, "value": [0.5, 0.5] } ] } ] }
+	Properties: position (relative from top left), scale, angles, alpha, color ([r, g, b]). The ease of a key is used
+	on the way to it (linear by default).
+
+	Binary form (".guic", compiled with SaveBinary), native byte order:
+	"GUIC", uint32 version, uint32 segment count, float duration, then per segment: uint8 property, uint8 ease,
+	2 padding bytes, float start time, float duration, float start[4], float target[4]
+	Both forms fail to load as a whole on malformed data (unknown property or ease, negative, non finite or out of
+	order times, non finite values), nothing is skipped.
+*/
+class GUIAnimClip
+{
+	friend class GUIAnimationManager;
+
+public:
+	struct Segment
+	{
+		Segment() : m_eProperty(GAP_POSITION), m_fStartTime(0.f), m_fDuration(0.f), m_pfEase(0), m_uiEase(0) {}
+
+		eGUIAnimProperty m_eProperty;
+		float m_fStartTime;
+		float m_fDuration;
+		hkvVec4 m_v4Start;
+		hkvVec4 m_v4Target;
+		pfEase m_pfEase; // Resolved on load
+		unsigned int m_uiEase; // Index in the ease table, kept for the binary form
+	};
+
+	bool LoadJSON( const char* pcContent );
+	bool LoadBinary( const char* pcData, const unsigned int uiSize );
+	bool SaveBinary( const std::string& sFilepath ) const;
+
+	float GetDuration() const { return m_fDuration; }
+	unsigned int GetNumSegments() const { return m_uiNumSegments; }
+	const Segment& GetSegment( const unsigned int uiIndex ) const { return m_aSegments.GetDataPtr()[uiIndex]; }
+
+	// Built-in easing functions by name ("Linear", "Quartic.EaseOut", ...), -1 if unknown
+	static int FindEase( const char* pcName );
+	static pfEase GetEaseMethod( const unsigned int uiEase );
+
+private:
+	GUIAnimClip();
+	~GUIAnimClip();
+
+	void Clear();
+	void AddSegment( const eGUIAnimProperty eProperty, const float fStartTime, const float fDuration, const hkvVec4& v4Start, const hkvVec4& v4Target, const unsigned int uiEase );
+
+	DynArray_cl<Segment> m_aSegments;
+	unsigned int m_uiNumSegments;
+	float m_fDuration;
+};
+
+
+#endif // GUIANIMCLIP_H_INCLUDED
@@ -1,11 +1,17 @@
 #include "CutshumotoPluginPCH.h"
 #include "GUIAnimation.h"
 #include "GUIAnimationManager.h"
+#include "GUINineSlice.h"
+#include "GUIEasingCurve.h"
 #include "SoundManager.h"
 
 #include <Vision/Runtime/Base/Input/VInputTouch.hpp>
 
-GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType ) : VUserDataObj()
+#define RETARGET_VELOCITY_STEP 0.001f
+#define GUI_SPRING_MAX_STEP (1.f / 120.f)
+#define GUI_SPRING_MAX_SUBSTEPS 8
+
+GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType, const GUIAtlasHandle uiAtlas ) : VUserDataObj()
 {
 	m_iAnimFPS = 24;
 	m_iFirstFrame = iFirstFrame;
@@ -30,7 +36,20 @@ GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame,
 	m_tAnchorInfo.Init();
 	m_fInitWidth = 0;
 	m_fInitHeight = 0;
-	m_aEasingAnims.Init(0);
+	m_bInContainer = false;
+	m_bCacheCounted = false;
+	m_pCacheTexture = 0;
+	m_bCacheVisible = false;
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		m_aiEasingSlots[i] = -1;
+		m_av4AdditiveOffset[i].setZero();
+	}
+	m_aAdditiveSlots.Init(-1);
+	m_uiNumAdditive = 0;
+	m_pSprings = 0;
+	m_uiActiveSprings = 0;
+	m_uiSpringsToCommit = 0;
 	m_eOnTouchUpSound = eNoSound;
 	m_eOnEasingCompleteSound = eNoSound;
 	m_eOnEasingStartSound = eNoSound;
@@ -38,6 +57,26 @@ GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame,
 	m_fScaleY = 1.f;
 	m_fLastTouchXPos = 0.f;
 	m_fLastTouchYPos = 0.f;
+	m_bCulled = false;
+	m_bCulledByParent = false;
+	m_uiCullFrame = 0;
+	m_uiClipFrame = 0;
+	m_bClipChildren = false;
+	m_bHasClipRect = false;
+	m_tClipRect.Init();
+	m_pQuadProvider = 0;
+	m_pNineSlice = 0;
+	m_pArena = 0;
+	m_fTexelScale = 1.f;
+	m_uiAtlas = ( iNumFrames > 0 ) ? uiAtlas : GUI_INVALID_ATLAS;
+	m_aChildren.Init(0);
+	m_bLayoutChanged = false;
+	m_bRenderFrameDirty = false;
+	m_uiLayoutPass = 0;
+	m_bAwake = false;
+	m_bInTouchIndex = false;
+	m_uiUpdateFrame = 0;
+	m_uiTimeGroup = 0;
 	
 	if ( iNumFrames > 0 )
 	{ // Loads frames from spritesheet
@@ -47,10 +86,10 @@ GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame,
 
 		std::ostringstream ss;
 		ss << sBaseFilename << "_" << 0 << "." << sExtension;
-		FrameRect tMaxSize = GUIAnimationManager::Instance().GetFrame( ss.str() ); // Get the first frame
+		FrameRect tMaxSize = GUIAnimationManager::Instance().GetFrame( m_uiAtlas, ss.str() ); // Get the first frame
 		if ( !tMaxSize.IsValid() ) 
 		{ // Try to load without frame num extension
-			FrameRect tStandalone = GUIAnimationManager::Instance().GetFrame( sFilename );
+			FrameRect tStandalone = GUIAnimationManager::Instance().GetFrame( m_uiAtlas, sFilename );
 			AddFrameRect( tStandalone );
 			m_eType = GAT_NONE;
 			// Set init size
@@ -67,7 +106,7 @@ GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame,
 				ss.seekp(0);
 				// Build numbered filename
 				ss << sBaseFilename << "_" << i << "." << sExtension;
-				FrameRect tMaxToMatch = GUIAnimationManager::Instance().GetFrame( ss.str() );
+				FrameRect tMaxToMatch = GUIAnimationManager::Instance().GetFrame( m_uiAtlas, ss.str() );
 				if ( tMaxToMatch.IsValid() ) AddFrameRect( tMaxToMatch );
 				// Obtain max size
 				if ( tMaxToMatch.m_fW > tMaxSize.m_fW ) tMaxSize.m_fW = tMaxToMatch.m_fW;
@@ -86,13 +125,29 @@ GUIAnimation::GUIAnimation( const std::string& sFilename, const int iFirstFrame,
 
 GUIAnimation::~GUIAnimation()
 {
-	// Free Easing Animations
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
+	// Give back Easing Animations
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
 	{
-		if ( m_aEasingAnims[i] ) delete m_aEasingAnims[i];
-		m_aEasingAnims.Remove(i);
+		tRegistry.Release( m_aiEasingSlots[i] );
+		m_aiEasingSlots[i] = -1;
 	}
-	m_aEasingAnims.Reset();
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		tRegistry.Release( m_aAdditiveSlots[i] );
+	m_aAdditiveSlots.Reset();
+	m_uiNumAdditive = 0;
+	// Free springs
+	delete[] m_pSprings;
+	m_pSprings = 0;
+	m_uiActiveSprings = 0;
+	// Detach from the hierarchy
+	if ( m_tAnchorInfo.m_pParent ) m_tAnchorInfo.m_pParent->RemoveChild( this );
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+		if ( m_aChildren[i] ) m_aChildren[i]->m_tAnchorInfo.m_pParent = 0;
+	m_aChildren.Reset();
+	ClearNineSlice();
+	// Leave manager schedulers
+	GUIAnimationManager::Instance().OnAnimationDestroyed( this );
 	// Free rect areas
 	m_aFrameRects.Reset();
 	// Free render tex
@@ -101,14 +156,23 @@ GUIAnimation::~GUIAnimation()
 	GUIAnimationManager::Instance().GetInputMap()->UnmapInput( m_eID );
 }
 
-GUIAnimation* GUIAnimation::Create( const std::string& sSrcTextureFilepath, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType )
+GUIAnimation* GUIAnimation::Create( const std::string& sSrcTextureFilepath, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType, const GUIAtlasHandle uiAtlas, GUIArena* pArena )
 {
-	GUIAnimation* pNewAnim = new GUIAnimation( sFilename, iFirstFrame, iLastFrame, iNumFrames, eID, eType );
+	GUIAnimation* pNewAnim = new ( pArena ) GUIAnimation( sFilename, iFirstFrame, iLastFrame, iNumFrames, eID, eType, uiAtlas );
+	pNewAnim->m_pArena = GUIArena::GetOwner( pNewAnim ); // Null if the arena was full
 	// Create render tex
 	VisScreenMask_cl* pTex = new VisScreenMask_cl();
 	BOOL bTexLoaded = false;
 	if ( pNewAnim->GetNumFrames() == 0 ) bTexLoaded = pTex->LoadFromFile( (sSrcTextureFilepath + sFilename).c_str(), VTM_FLAG_NO_MIPMAPS ); // Load standalone tex
-	else bTexLoaded = pTex->LoadFromFile( (sSrcTextureFilepath + TPTEXFILE_EXTENSION).c_str(), VTM_FLAG_NO_MIPMAPS ); // Load TexAtlas
+	else
+	{ // Load TexAtlas, compressed when available
+		VTextureObject* pAtlas = GUIAnimationManager::Instance().LoadAtlasTexture( sSrcTextureFilepath );
+		if ( pAtlas )
+		{
+			pTex->SetTextureObject( pAtlas );
+			bTexLoaded = pAtlas->IsLoaded();
+		}
+	}
 	VASSERT( bTexLoaded );
 	pTex->SetTransparency( VIS_TRANSP_ALPHA );
 	// Add render tex
@@ -130,9 +194,107 @@ void GUIAnimation::InitializeSize()
 	RefreshTouchArea();
 }
 
+/*
+	New element of the same texture and frames as pSource, as if created with the same arguments (arena included). The
+	frame rects are copied and the screen mask shares the loaded texture, so there is no frame lookup nor texture load
+*/
+GUIAnimation* GUIAnimation::Clone( const GUIAnimation* pSource, const eGUIAnimID eID )
+{
+	GUIAnimation* pNewAnim = new ( pSource->m_pArena ) GUIAnimation( pSource->m_sFilename, pSource->m_iFirstFrame, pSource->m_iLastFrame, 0, eID, pSource->m_eType );
+	pNewAnim->m_pArena = GUIArena::GetOwner( pNewAnim );
+	pNewAnim->m_iNumFrames = pSource->m_iNumFrames;
+	pNewAnim->m_eType = pSource->m_eType;
+	pNewAnim->m_aFrameRects.EnsureSize( pSource->m_aFrameRects.GetValidSize() );
+	for ( unsigned int i = 0; i < pSource->m_aFrameRects.GetValidSize(); i++ )
+		pNewAnim->AddFrameRect( pSource->m_aFrameRects[i], i );
+	pNewAnim->m_fInitWidth = pSource->m_fInitWidth;
+	pNewAnim->m_fInitHeight = pSource->m_fInitHeight;
+	pNewAnim->m_sTierTexSource = pSource->m_sTierTexSource;
+	pNewAnim->m_sTierTexFilename = pSource->m_sTierTexFilename;
+	pNewAnim->m_fTexelScale = pSource->m_fTexelScale;
+	pNewAnim->m_uiAtlas = pSource->m_uiAtlas;
+
+	// Create render tex from the already loaded one
+	VisScreenMask_cl* pTex = new VisScreenMask_cl();
+	pTex->SetTextureObject( pSource->m_spTexture->GetTextureObject() );
+	pTex->SetTransparency( VIS_TRANSP_ALPHA );
+	pNewAnim->SetTextureOnce( pTex );
+	pNewAnim->SetRenderFrame( pNewAnim->m_iFirstFrame );
+	pNewAnim->InitializeSize();
+
+	return pNewAnim;
+}
+
+/*
+	Back to the state of a freshly created element, keeping texture, frames and size. Used by the manager pools
+*/
+void GUIAnimation::ResetForReuse( const eGUIAnimID eID, const eGUIAnimType eType )
+{
+	// Give back tweens and springs without callbacks
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		tRegistry.Release( m_aiEasingSlots[i] );
+		m_aiEasingSlots[i] = -1;
+		m_av4AdditiveOffset[i].setZero();
+	}
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		tRegistry.Release( m_aAdditiveSlots[i] );
+	m_uiNumAdditive = 0;
+	m_bActiveEaseAnim = false;
+	m_uiActiveSprings = 0;
+	m_uiSpringsToCommit = 0;
+
+	// Frame animation
+	Stop();
+	m_eType = eType;
+	m_iAnimFPS = 24;
+	m_fNextFrameTimer = 0.f;
+	m_bRenderFrameDirty = false;
+	SetRenderFrame( m_iFirstFrame );
+
+	// Hierarchy
+	SetParent( 0 );
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+	{
+		if ( !m_aChildren[i] ) continue;
+		m_aChildren[i]->m_tAnchorInfo.m_pParent = 0;
+		m_aChildren[i]->MarkLayoutDirty();
+	}
+	m_aChildren.Reset();
+	m_tAnchorInfo.Init();
+
+	// Input and sounds
+	m_eID = eID;
+	m_bTouchable = true;
+	m_bTouched = false;
+	m_pfOnTouchUp = 0;
+	m_pfOnTouchDown = 0;
+	m_eOnTouchUpSound = eNoSound;
+	m_eOnEasingCompleteSound = eNoSound;
+	m_eOnEasingStartSound = eNoSound;
+
+	// Visual state
+	m_spTexture->SetColor( V_RGBA_WHITE );
+	m_spTexture->SetRotationAngle( 0.f );
+	m_spTexture->SetTargetSize( m_fInitWidth, m_fInitHeight );
+	m_fScaleX = 1.f;
+	m_fScaleY = 1.f;
+	m_bCulled = false;
+	m_bCulledByParent = false;
+	m_bClipChildren = false;
+	m_bHasClipRect = false;
+	ClearNineSlice();
+	m_uiTimeGroup = 0;
+	m_bTouchAreaIsDirty = true;
+	// Pooled while culled (e.g. faded out): the engine mask is still hidden and no culling transition will show it
+	GUIAnimationManager::Instance().RefreshMaskVisibility( this );
+}
+
 void GUIAnimation::Play()
 {
 	m_bActiveFrameAnim = true;
+	Wake();
 }
 
 void GUIAnimation::Stop()
@@ -148,126 +310,357 @@ void GUIAnimation::PlayBackward()
 	m_bRewinding = true;
 	m_bActiveFrameAnim = true;
 	m_iCurrentFrame = m_iLastFrame;
+	Wake();
 }
 
 void GUIAnimation::PlayEasing( const eGUIAnimProperty eProperty ) 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-	{
-		if ( !m_aEasingAnims[i]->IsFinished() && m_aEasingAnims[i]->GetAnimProperty() == eProperty ) 
-		{
-			m_aEasingAnims[i]->Play();
-			break;
-		}
-	}
+	EasingAnimation* pEasing = GetEasing( eProperty );
+	if ( pEasing && !pEasing->IsFinished() ) pEasing->Play();
 }
 
 void GUIAnimation::PlayAllEasings() 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-		if ( !m_aEasingAnims[i]->IsFinished() ) m_aEasingAnims[i]->Play();
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+		PlayEasing( static_cast<eGUIAnimProperty>(i) );
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		if ( !tRegistry.GetTween( m_aAdditiveSlots[i] )->IsFinished() ) tRegistry.GetTween( m_aAdditiveSlots[i] )->Play();
 }
 
 void GUIAnimation::PauseEasing( const eGUIAnimProperty eProperty ) 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-	{
-		if ( !m_aEasingAnims[i]->IsFinished() && m_aEasingAnims[i]->GetAnimProperty() == eProperty ) 
-		{
-			m_aEasingAnims[i]->Pause();
-			break;
-		}
-	}
+	EasingAnimation* pEasing = GetEasing( eProperty );
+	if ( pEasing && !pEasing->IsFinished() ) pEasing->Pause();
 }
 
 void GUIAnimation::PauseAllEasings() 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-		if ( !m_aEasingAnims[i]->IsFinished() ) m_aEasingAnims[i]->Pause();
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+		PauseEasing( static_cast<eGUIAnimProperty>(i) );
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		if ( !tRegistry.GetTween( m_aAdditiveSlots[i] )->IsFinished() ) tRegistry.GetTween( m_aAdditiveSlots[i] )->Pause();
 }
 
 void GUIAnimation::StopEasing( const eGUIAnimProperty eProperty ) 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-	{
-		if ( !m_aEasingAnims[i]->IsFinished() && m_aEasingAnims[i]->GetAnimProperty() == eProperty ) 
-		{
-			m_aEasingAnims[i]->Stop();
-			break;
-		}
-	}
+	EasingAnimation* pEasing = GetEasing( eProperty );
+	if ( pEasing && !pEasing->IsFinished() ) pEasing->Stop();
 }
 
 void GUIAnimation::StopAllEasings() 
 {
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
-		if ( !m_aEasingAnims[i]->IsFinished() ) m_aEasingAnims[i]->Stop();
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+		StopEasing( static_cast<eGUIAnimProperty>(i) );
+	// Additive offsets stay where they are and are released on the next update
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		tRegistry.GetTween( m_aAdditiveSlots[i] )->Stop();
+}
+
+EasingAnimation* GUIAnimation::GetEasing( const eGUIAnimProperty eProperty ) const
+{
+	const int iSlot = m_aiEasingSlots[eProperty];
+	return ( iSlot >= 0 ) ? GUIAnimationManager::Instance().GetTweenRegistry().GetTween( iSlot ) : 0;
+}
+
+GUITweenHandle GUIAnimation::GetEasingHandle( const eGUIAnimProperty eProperty ) const
+{
+	const int iSlot = m_aiEasingSlots[eProperty];
+	return ( iSlot >= 0 ) ? GUIAnimationManager::Instance().GetTweenRegistry().GetHandle( iSlot ) : GUITweenHandle();
+}
+
+/*
+	Tween values are relative to the additive offsets of the property
+*/
+void GUIAnimation::ApplyEasingValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value )
+{
+	SetPropertyValue( eProperty, v4Value + m_av4AdditiveOffset[eProperty] );
+}
+
+/*
+	A timeline owns the property while it writes it: the tween or spring running on it is stopped, additive
+	offsets stay on top
+*/
+void GUIAnimation::ApplyTimelineValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value )
+{
+	OverrideAnimTypeIfExists( eProperty );
+	StopSpring( eProperty );
+	ApplyEasingValue( eProperty, v4Value );
+}
+
+/*
+	A new tween replaces the one running on the same property
+*/
+void GUIAnimation::OverrideAnimTypeIfExists( const eGUIAnimProperty eProperty )
+{
+	const int iSlot = m_aiEasingSlots[eProperty];
+	if ( iSlot < 0 ) return;
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	tRegistry.GetTween( iSlot )->Stop();
+	tRegistry.Release( iSlot );
+	m_aiEasingSlots[eProperty] = -1;
 }
 
 void GUIAnimation::SetVisible( const bool bIsVisible ) 
 {
 	m_spTexture->SetVisible( bIsVisible );
-	m_bTouchable = bIsVisible;
+	SetTouchable( bIsVisible );
+	GUIAnimationManager::Instance().OnTextureUseChanged( this ); // Evicted texture loaded back when shown
 	// Clean pending stuff (like easing animations flaged as finished)
 	RemoveEasingsFinished();
+	// Hidden elements leave the active list on the next update, shown ones rejoin it
+	if ( bIsVisible ) Wake();
+}
+
+void GUIAnimation::SetTouchable( bool bTouchable )
+{
+	m_bTouchable = bTouchable;
+	if ( bTouchable ) GUIAnimationManager::Instance().RegisterTouchable( this );
+	else GUIAnimationManager::Instance().UnregisterTouchable( this );
+}
+
+void GUIAnimation::SetParent( GUIAnimation* pAnimParent )
+{
+	if ( m_tAnchorInfo.m_pParent == pAnimParent ) return;
+	if ( m_tAnchorInfo.m_pParent ) m_tAnchorInfo.m_pParent->RemoveChild( this );
+	m_tAnchorInfo.m_pParent = pAnimParent;
+	if ( pAnimParent ) pAnimParent->AddChild( this );
+	MarkLayoutDirty();
+}
+
+void GUIAnimation::AddChild( GUIAnimation* pChild )
+{
+	m_aChildren[ m_aChildren.GetFreePos() ] = pChild;
+}
+
+void GUIAnimation::RemoveChild( GUIAnimation* pChild )
+{
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+		if ( m_aChildren[i] == pChild ) m_aChildren.Remove(i);
+	m_aChildren.Pack();
+}
+
+void GUIAnimation::MarkChildrenLayoutDirty()
+{
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+		if ( m_aChildren[i] ) m_aChildren[i]->MarkLayoutDirty();
+}
+
+void GUIAnimation::WakeChildren()
+{
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+		if ( m_aChildren[i] ) m_aChildren[i]->Wake();
+}
+
+/*
+	Descendants recompute their clip rect and culling on the next update, even if their own rect did not change
+*/
+void GUIAnimation::WakeSubtree()
+{
+	for ( unsigned int i = 0; i < m_aChildren.GetValidSize(); i++ )
+	{
+		if ( !m_aChildren[i] ) continue;
+		m_aChildren[i]->Wake();
+		m_aChildren[i]->WakeSubtree();
+	}
+}
+
+void GUIAnimation::SetClipChildren( const bool bClip )
+{
+	if ( m_bClipChildren == bClip ) return;
+	m_bClipChildren = bClip;
+	WakeSubtree();
+}
+
+void GUIAnimation::SetQuadProvider( IGUIQuadProvider* pProvider )
+{
+	m_pQuadProvider = pProvider;
+	// The engine mask pass cannot draw it
+	if ( m_spTexture && pProvider ) m_spTexture->SetVisibleBitmask( 0 );
+}
+
+void GUIAnimation::SetNineSlice( const float fLeft, const float fTop, const float fRight, const float fBottom )
+{
+	if ( m_pNineSlice ) 
+	{
+		m_pNineSlice->SetInsets( fLeft, fTop, fRight, fBottom );
+		return;
+	}
+	m_pNineSlice = new ( m_pArena ) GUINineSlice( fLeft, fTop, fRight, fBottom );
+	SetQuadProvider( m_pNineSlice );
+}
+
+void GUIAnimation::ClearNineSlice()
+{
+	if ( !m_pNineSlice ) return;
+	if ( m_pQuadProvider == m_pNineSlice ) 
+	{
+		m_pQuadProvider = 0;
+		GUIAnimationManager::Instance().RefreshMaskVisibility( this ); // Back to the engine mask pass if not batching
+	}
+	delete m_pNineSlice;
+	m_pNineSlice = 0;
+}
+
+/*
+	Same texture at another resolution: frame rects are rescaled to its texels, the element keeps its size
+*/
+void GUIAnimation::SwapTexture( VTextureObject* pTexture, const float fTexelScale )
+{
+	const float fRatio = fTexelScale / m_fTexelScale;
+	m_spTexture->SetTextureObject( pTexture );
+	m_fTexelScale = fTexelScale;
+	GUIAnimationManager::Instance().OnTextureUseChanged( this );
+	if ( m_aFrameRects.GetValidSize() == 0 )
+	{ // Standalone texture, whole range
+		m_spTexture->SetTextureRange( 0.f, 0.f, static_cast<float>(pTexture->GetTextureWidth()), static_cast<float>(pTexture->GetTextureHeight()) );
+		return;
+	}
+	for ( unsigned int i = 0; i < m_aFrameRects.GetValidSize(); i++ )
+	{
+		FrameRect& tFrame = m_aFrameRects[i];
+		tFrame.Set( tFrame.m_fX * fRatio, tFrame.m_fY * fRatio, tFrame.m_fW * fRatio, tFrame.m_fH * fRatio );
+	}
+	SetRenderFrame( m_iCurrentFrame );
+}
+
+/*
+	Frame rects looked up again in the manager frames (atlas JSON reloaded). Frames missing now are kept. The element
+	keeps its scale if its largest frame changed size. False if nothing changed
+*/
+bool GUIAnimation::ReloadFrames()
+{
+	if ( m_iNumFrames <= 0 || m_aFrameRects.GetValidSize() == 0 ) return false; // Standalone texture
+
+	const GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	const int iExtensionDotPos = m_sFilename.rfind( "." );
+	const std::string sExtension = m_sFilename.substr( iExtensionDotPos + 1 );
+	const std::string sBaseFilename = m_sFilename.substr( 0, iExtensionDotPos );
+
+	bool bChanged = false;
+	FrameRect tMaxSize;
+	std::ostringstream ss;
+	for ( unsigned int i = 0; i < m_aFrameRects.GetValidSize(); i++ )
+	{
+		ss.str( "" );
+		ss << sBaseFilename << "_" << i << "." << sExtension;
+		const FrameRect* pFrame = tManager.FindFrame( m_uiAtlas, ss.str() );
+		if ( !pFrame && i == 0 ) pFrame = tManager.FindFrame( m_uiAtlas, m_sFilename ); // Single frame without number
+		if ( !pFrame || !pFrame->IsValid() ) continue;
+
+		FrameRect& tFrame = m_aFrameRects[i];
+		if ( !( tFrame == *pFrame ) )
+		{
+			tFrame = *pFrame;
+			bChanged = true;
+		}
+		if ( tFrame.m_fW > tMaxSize.m_fW ) tMaxSize.m_fW = tFrame.m_fW;
+		if ( tFrame.m_fH > tMaxSize.m_fH ) tMaxSize.m_fH = tFrame.m_fH;
+	}
+	if ( !bChanged ) return false;
+
+	SetRenderFrame( m_iCurrentFrame );
+	if ( tMaxSize.m_fW > 0.f && tMaxSize.m_fH > 0.f && !m_pQuadProvider )
+	{ // Texts and nine-slices keep their own size
+		m_fInitWidth = tMaxSize.m_fW / m_fTexelScale;
+		m_fInitHeight = tMaxSize.m_fH / m_fTexelScale;
+		SetSize( m_fInitWidth * m_fScaleX, m_fInitHeight * m_fScaleY );
+	}
+	return true;
+}
+
+bool GUIAnimation::IsTouchPointInside( const float fX, const float fY ) const
+{
+	if ( !m_tTouchArea.IsValid() || !m_tTouchArea.IsInside( fX, fY ) ) return false;
+	return !m_bHasClipRect || m_tClipRect.IsInside( fX, fY );
+}
+
+/*
+	Joins the manager active list so the element is updated until it is idle again
+*/
+void GUIAnimation::Wake()
+{
+	if ( m_bAwake ) return;
+	GUIAnimationManager::Instance().WakeAnimation( this );
 }
 
 void GUIAnimation::RemoveEasingsFinished() 
 {
-	bool bRemoved = false;
-	for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	bool bAnyLeft = false;
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
 	{
-		if ( m_aEasingAnims[i] && m_aEasingAnims[i]->IsFinished() ) 
+		const int iSlot = m_aiEasingSlots[i];
+		if ( iSlot < 0 ) continue;
+		if ( tRegistry.GetTween( iSlot )->IsFinished() ) 
 		{
-			bRemoved = true;
-			delete m_aEasingAnims[i];
-			m_aEasingAnims.Remove(i);
+			tRegistry.Release( iSlot );
+			m_aiEasingSlots[i] = -1;
+		}
+		else
+		{
+			bAnyLeft = true;
 		}
 	}
-	if ( bRemoved ) m_aEasingAnims.Pack();
-	// If no ease animations left then set false activeEaseAnim
-	if ( m_aEasingAnims.GetValidSize() == 0 ) m_bActiveEaseAnim = false;
+	// If no ease animations left then set false activeEaseAnim (finished additive ones are released on commit)
+	if ( !bAnyLeft && m_uiNumAdditive == 0 ) m_bActiveEaseAnim = false;
 }
 
 void GUIAnimation::Update( float fDeltaTime )
 {
 	m_bRunning = true;
+	m_uiUpdateFrame = GUIAnimationManager::Instance().m_uiFrame;
 
-	// Update touch area if dirty
-	if ( m_bTouchAreaIsDirty ) RefreshTouchArea();
+	// Update touch area if dirty (culled elements skip layout until they come back)
+	if ( m_bTouchAreaIsDirty && !m_bCulled ) RefreshTouchArea();
 	// Update animations
 	if ( IsActiveAnim() ) UpdateAnimation( fDeltaTime );
 }
 
 void GUIAnimation::UpdateAnimation( const float fDeltaTime )
+{
+	EvaluateAnimation( fDeltaTime );
+	CommitAnimation();
+}
+
+/*
+	Advances easing and frame animations without touching the screen mask nor calling callbacks.
+	Safe to run in parallel for different elements
+*/
+void GUIAnimation::EvaluateAnimation( const float fDeltaTime )
 {
 	if ( m_bActiveEaseAnim ) 
 	{ // Perfom ease animation
-		for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) 
+		for ( int i = 0; i < GAP_COUNT; i++ ) 
 		{
-			if ( m_aEasingAnims[i] ) 
-			{
-				if ( !m_aEasingAnims[i]->IsFinished() ) 
-				{ // Update
-					m_aEasingAnims[i]->Update( fDeltaTime );
-				}
-			}
+			EasingAnimation* pEasing = GetEasing( static_cast<eGUIAnimProperty>(i) );
+			if ( pEasing && !pEasing->IsFinished() ) pEasing->Evaluate( fDeltaTime );
+		}
+		const GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+		for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+		{
+			EasingAnimation* pEasing = tRegistry.GetTween( m_aAdditiveSlots[i] );
+			if ( !pEasing->IsFinished() ) pEasing->Evaluate( fDeltaTime );
 		}
-		RemoveEasingsFinished();
 	}
 
+	if ( m_uiActiveSprings ) EvaluateSprings( fDeltaTime );
+
 	if ( m_bActiveFrameAnim ) 
 	{ // Perfom frame animation
 		if ( m_aFrameRects.GetValidSize() <= 1 || m_eType == GAT_NONE ) return;
 			
+		// Advance as many frames as the elapsed time covers, so large (fast-forwarded) deltas stay exact
 		m_fNextFrameTimer += m_iAnimFPS * fDeltaTime;
-		if ( m_fNextFrameTimer > 1 )
+		while ( m_fNextFrameTimer >= 1.f )
 		{
 			if ( m_bRewinding )
 				m_iCurrentFrame--;
 			else
 				m_iCurrentFrame++;
-			m_fNextFrameTimer = 0;
+			m_fNextFrameTimer -= 1.f;
 
 			if ( m_iCurrentFrame > m_iLastFrame )
 				m_iCurrentFrame = m_iFirstFrame;
@@ -298,10 +691,155 @@ void GUIAnimation::UpdateAnimation( const float fDeltaTime )
 				break;
 			}
 
-			// Set texture offset
-			SetRenderFrame( m_iCurrentFrame );
+			// Set texture offset on commit
+			m_bRenderFrameDirty = true;
+		}
+	}
+}
+
+/*
+	Applies the evaluated values to the screen mask and fires callbacks and sounds
+*/
+void GUIAnimation::CommitAnimation()
+{
+	if ( m_bActiveEaseAnim ) 
+	{
+		for ( int i = 0; i < GAP_COUNT; i++ ) 
+		{ // Completion callbacks may start a new tween on the same property, look the slot up each time
+			EasingAnimation* pEasing = GetEasing( static_cast<eGUIAnimProperty>(i) );
+			if ( pEasing ) pEasing->Commit();
 		}
+		if ( m_uiNumAdditive > 0 ) ApplyAdditiveEasings();
+		RemoveEasingsFinished();
 	}
+
+	if ( m_uiSpringsToCommit ) CommitSprings();
+
+	if ( m_bRenderFrameDirty )
+	{
+		m_bRenderFrameDirty = false;
+		SetRenderFrame( m_iCurrentFrame );
+	}
+}
+
+/*
+	Computes once per manager frame whether the element is off-screen, fully transparent or has a culled parent.
+	Parents are resolved first so the result does not depend on the update order. The transition is applied here
+	because a parent can be resolved through its child before the manager visits it.
+*/
+bool GUIAnimation::UpdateCulling( const unsigned int uiFrame )
+{
+	if ( m_uiCullFrame == uiFrame ) return m_bCulled;
+	m_uiCullFrame = uiFrame;
+
+	const bool bWasCulled = m_bCulled;
+	ComputeCulling( uiFrame, bWasCulled );
+	if ( m_bCulled != bWasCulled )
+	{
+		GUIAnimationManager::Instance().RefreshMaskVisibility( this );
+		GUIAnimationManager::Instance().OnTextureUseChanged( this );
+		WakeChildren(); // Children culling depends on this one
+	}
+	return m_bCulled;
+}
+
+void GUIAnimation::ComputeCulling( const unsigned int uiFrame, const bool bWasCulled )
+{
+	m_bCulled = false;
+	m_bCulledByParent = false;
+
+	// Culled parent hides the whole subtree
+	if ( m_tAnchorInfo.m_pParent )
+	{
+		if ( m_tAnchorInfo.m_pParent->UpdateCulling( uiFrame ) )
+		{
+			m_bCulled = true;
+			m_bCulledByParent = true;
+			return;
+		}
+		// Layout was skipped while culled, so the rect relative to the parent is stale
+		if ( bWasCulled && m_bTouchAreaIsDirty ) RefreshTouchArea();
+	}
+
+	UpdateClipRect( uiFrame );
+
+	// Fully transparent
+	if ( m_spTexture->GetColor().a == 0 )
+	{
+		m_bCulled = true;
+		return;
+	}
+
+	// Resolved rect against the screen rect
+	float fX, fY, fW, fH;
+	m_spTexture->GetPos( fX, fY );
+	m_spTexture->GetTargetSize( fW, fH );
+	if ( m_spTexture->GetRotationAngle() != 0.f )
+	{ // Use the circumscribed square of the rotated quad
+		const float fRadius = hkvMath::sqrt( fW * fW + fH * fH ) / 2.f;
+		fX += fW / 2.f - fRadius;
+		fY += fH / 2.f - fRadius;
+		fW = fH = fRadius * 2.f;
+	}
+	const float fScreenW = static_cast<float>(Vision::Video.GetXRes());
+	const float fScreenH = static_cast<float>(Vision::Video.GetYRes());
+	m_bCulled = ( fX + fW <= 0.f || fY + fH <= 0.f || fX >= fScreenW || fY >= fScreenH );
+	// Fully clipped
+	if ( !m_bCulled && m_bHasClipRect )
+	{
+		m_bCulled = ( m_tClipRect.m_fW <= 0.f || m_tClipRect.m_fH <= 0.f
+			|| fX + fW <= m_tClipRect.m_fX || fY + fH <= m_tClipRect.m_fY
+			|| fX >= m_tClipRect.m_fX + m_tClipRect.m_fW || fY >= m_tClipRect.m_fY + m_tClipRect.m_fH );
+	}
+}
+
+/*
+	Clip rect of the ancestors, narrowed by the parent rect if it clips its children. Computed once per manager frame,
+	with culling disabled too (drawing and touch clipping use it)
+*/
+void GUIAnimation::UpdateClipRect( const unsigned int uiFrame )
+{
+	if ( m_uiClipFrame == uiFrame ) return;
+	m_uiClipFrame = uiFrame;
+
+	m_bHasClipRect = false;
+	if ( !m_tAnchorInfo.m_pParent ) return;
+	GUIAnimation* pParent = m_tAnchorInfo.m_pParent;
+	pParent->UpdateClipRect( uiFrame );
+	if ( pParent->m_bHasClipRect )
+	{
+		m_tClipRect = pParent->m_tClipRect;
+		m_bHasClipRect = true;
+	}
+	if ( pParent->m_bClipChildren )
+	{
+		const FrameRect& tParentRect = pParent->m_tTouchArea;
+		if ( !m_bHasClipRect ) m_tClipRect = tParentRect;
+		const float fX0 = hkvMath::Max( m_tClipRect.m_fX, tParentRect.m_fX );
+		const float fY0 = hkvMath::Max( m_tClipRect.m_fY, tParentRect.m_fY );
+		const float fX1 = hkvMath::Min( m_tClipRect.m_fX + m_tClipRect.m_fW, tParentRect.m_fX + tParentRect.m_fW );
+		const float fY1 = hkvMath::Min( m_tClipRect.m_fY + m_tClipRect.m_fH, tParentRect.m_fY + tParentRect.m_fH );
+		m_tClipRect.Set( fX0, fY0, hkvMath::Max( fX1 - fX0, 0.f ), hkvMath::Max( fY1 - fY0, 0.f ) );
+		m_bHasClipRect = true;
+	}
+}
+
+bool GUIAnimation::IsPointerDown()
+{
+	#if defined(_VISION_MOBILE) // Mobile
+
+	IVMultiTouchInput& inputDevice = static_cast<IVMultiTouchInput&>(VInputDeviceManager::GetInputDevice( INPUT_DEVICE_TOUCHSCREEN ));
+	return inputDevice.GetNumberOfTouchPoints() > 0;
+
+	#elif defined(SUPPORTS_MOUSE) // Win
+
+	return Vision::Mouse.IsLeftButtonPressed() ? true : false;
+
+	#else
+
+	return false;
+
+	#endif
 }
 
 void GUIAnimation::UpdateInput()
@@ -312,7 +850,7 @@ void GUIAnimation::UpdateInput()
 	if ( inputDevice.GetNumberOfTouchPoints() > 0 ) 
 	{
 		const IVMultiTouchInput::VTouchPoint& touch = inputDevice.GetTouch(0);
-		if ( m_tTouchArea.IsValid() && m_tTouchArea.IsInside( touch.fXAbsolute, touch.fYAbsolute ) ) 
+		if ( IsTouchPointInside( touch.fXAbsolute, touch.fYAbsolute ) ) 
 		{
 			if ( !m_bTouched ) 
 				OnTouchDown();
@@ -348,7 +886,7 @@ void GUIAnimation::UpdateInput()
 	Vision::Mouse.GetPosition( fMouseX, fMouseY );
 	if ( Vision::Mouse.IsLeftButtonPressed() ) // Check action button pressed
 	{
-		if ( m_tTouchArea.IsValid() && m_tTouchArea.IsInside( fMouseX, fMouseY ) )
+		if ( IsTouchPointInside( fMouseX, fMouseY ) )
 		{
 			if ( !m_bTouched ) 
 				OnTouchDown();
@@ -402,14 +940,20 @@ void GUIAnimation::SetOrder( const int iPos )
 	}
 }
 
+/*
+	Every size change goes through here (scale, tweens, springs, texts, nine-slices): containers are told about it
+*/
 void GUIAnimation::SetSize( const float fWidth, const float fHeight )
 {
 	if ( m_spTexture )
 	{
+		float fOldWidth, fOldHeight;
+		m_spTexture->GetTargetSize( fOldWidth, fOldHeight );
 		// Set size
 		m_spTexture->SetTargetSize( fWidth, fHeight );
 		// Update touch area
 		RefreshTouchArea(); // FIXME: Use bTouchAreaIsDirty
+		if ( m_bInContainer && ( fWidth != fOldWidth || fHeight != fOldHeight ) ) GUIAnimationManager::Instance().OnAnimationResized( this );
 	}
 }
 
@@ -498,6 +1042,90 @@ void GUIAnimation::SetRenderFrame( const unsigned int iFramePos )
 	m_spTexture->SetTextureRange( tFrame.m_fX, tFrame.m_fY, tFrame.m_fX + tFrame.m_fW, tFrame.m_fY + tFrame.m_fH );
 }
 
+hkvVec4 GUIAnimation::GetPropertyValue( const eGUIAnimProperty eProperty ) const
+{
+	hkvVec4 v4Value( 0.f, 0.f, 0.f, 0.f );
+	if ( !m_spTexture ) return v4Value;
+
+	switch ( eProperty ) 
+	{
+	case GAP_POSITION:
+		{
+			GetRelativePostition( v4Value.x, v4Value.y );
+			break;
+		}
+	case GAP_SCALE:
+		{
+			v4Value.x = GetSize().x / m_fInitWidth;
+			break;
+		}
+	case GAP_ANGLES:
+		{
+			v4Value.x = m_spTexture->GetRotationAngle();
+			break;
+		}
+	case GAP_ALPHA:
+		{
+			v4Value.x = m_spTexture->GetColor().a;
+			break;
+		}
+	case GAP_COLOR:
+		{
+			const VColorRef& tColor = m_spTexture->GetColor();
+			v4Value.set( tColor.r, tColor.g, tColor.b, 0.f );
+			break;
+		}
+	default:
+		break;
+	}
+	return v4Value;
+}
+
+/*
+	Color channels are clamped so overshooting curves (Back, Elastic) dont wrap around
+*/
+void GUIAnimation::SetPropertyValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value )
+{
+	if ( !m_spTexture ) return;
+
+	switch ( eProperty ) 
+	{
+	case GAP_POSITION:
+		{
+			PositionFromTopLeft( v4Value.y, v4Value.x );
+			break;
+		}
+	case GAP_SCALE:
+		{
+			SetScale( v4Value.x, v4Value.x );
+			break;
+		}
+	case GAP_ANGLES:
+		{
+			SetRotationAngle( v4Value.x );
+			break;
+		}
+	case GAP_ALPHA:
+		{
+			VColorRef tColor = m_spTexture->GetColor();
+			tColor.a = static_cast<UBYTE>( hkvMath::clamp( v4Value.x, 0.f, 255.f ) );
+			SetColor( tColor );
+			break;
+		}
+	case GAP_COLOR:
+		{
+			VColorRef tColor = m_spTexture->GetColor(); // Keep current alpha value
+			tColor.r = static_cast<UBYTE>( hkvMath::clamp( v4Value.x, 0.f, 255.f ) );
+			tColor.g = static_cast<UBYTE>( hkvMath::clamp( v4Value.y, 0.f, 255.f ) );
+			tColor.b = static_cast<UBYTE>( hkvMath::clamp( v4Value.z, 0.f, 255.f ) );
+			SetColor( tColor );
+			break;
+		}
+	default:
+		break;
+	}
+}
+
 void GUIAnimation::PositionFromCenter( const float fPercentFromTop, const float fPercentFromLeft )
 {
 	PositionFromCenter( fPercentFromTop, fPercentFromLeft, UYA_CENTER, UXA_CENTER );
@@ -573,6 +1201,21 @@ void GUIAnimation::PositionFromTopLeft( const float fPercentFromTop, const float
 	RefreshPosition();
 }
 
+void GUIAnimation::PixelPositionFromTopLeft( const float fPixelsFromTop, const float fPixelsFromLeft )
+{
+	// Update anchor information
+	m_tAnchorInfo.m_eParentUIxAnchor = UXA_LEFT;
+	m_tAnchorInfo.m_eParentUIyAnchor = UYA_TOP;
+	m_tAnchorInfo.m_eUIxAnchor = UXA_LEFT;
+	m_tAnchorInfo.m_eUIyAnchor = UYA_TOP;
+	m_tAnchorInfo.m_fOffsetX = fPixelsFromLeft;
+	m_tAnchorInfo.m_fOffsetY = fPixelsFromTop;
+	m_tAnchorInfo.m_eUIPrecision = UIP_PIXEL;
+
+	// Refresh position
+	RefreshPosition();
+}
+
 void GUIAnimation::PositionFromTopRight( const float fPercentFromTop, const float fPercentFromRight, const eUIyAnchor eYAnchor, const eUIxAnchor eXAnchor )
 {
 	// Update anchor information
@@ -700,8 +1343,23 @@ void GUIAnimation::PositionFromRight( const float fPercentFromTop, const float f
 
 void GUIAnimation::RefreshPosition()
 {
-	m_bTouchAreaIsDirty = true;
+	// Resolved once at the end of a manager build
+	if ( !GUIAnimationManager::Instance().IsBuilding() ) ResolvePosition();
+	// Touch area follows on the next update
+	MarkLayoutDirty();
+}
+
+void GUIAnimation::ResolvePosition()
+{
+	const hkvVec2 v2Position = ComputePosition();
+	m_spTexture->SetPos( v2Position.x, v2Position.y );
+}
 
+/*
+	Position from the anchor info, the current size and the parent rect. Reads no screen mask state
+*/
+hkvVec2 GUIAnimation::ComputePosition() const
+{
 	// Get parent anchor position
 	hkvVec2 v2Position = ParentAnchorPosition();
 
@@ -712,16 +1370,20 @@ void GUIAnimation::RefreshPosition()
 		v2Position.y += UIRelative::YPercentFrom( m_tAnchorInfo.m_eUIyAnchor, ParentHeight(), m_tAnchorInfo.m_fOffsetY );
 	}
 	else
-	{
-
+	{ // Offsets in pixels, flipped like percentages for right and bottom anchors
+		v2Position.x += ( m_tAnchorInfo.m_eUIxAnchor == UXA_RIGHT ) ? -m_tAnchorInfo.m_fOffsetX : m_tAnchorInfo.m_fOffsetX;
+		v2Position.y += ( m_tAnchorInfo.m_eUIyAnchor == UYA_BOTTOM ) ? -m_tAnchorInfo.m_fOffsetY : m_tAnchorInfo.m_fOffsetY;
 	}
 
+	// Live additive position tweens, fractions of the parent size
+	v2Position.x += m_av4AdditiveOffset[GAP_POSITION].x * ParentWidth();
+	v2Position.y += m_av4AdditiveOffset[GAP_POSITION].y * ParentHeight();
+
 	// Adjust for anchor offset
 	v2Position.x -= UIRelative::XAnchorAdjustment( m_tAnchorInfo.m_eUIxAnchor, m_tTouchArea.m_fW, m_tAnchorInfo.m_eOriginUIxAnchor );
 	v2Position.y += UIRelative::YAnchorAdjustment( m_tAnchorInfo.m_eUIyAnchor, m_tTouchArea.m_fH, m_tAnchorInfo.m_eOriginUIyAnchor );
 
-	// Set new position
-	m_spTexture->SetPos( v2Position.x, v2Position.y );
+	return v2Position;
 }
 
 hkvVec2 GUIAnimation::ParentAnchorPosition() const
@@ -764,26 +1426,57 @@ float GUIAnimation::ParentHeight() const
 
 void GUIAnimation::RefreshTouchArea()
 {
+	if ( GUIAnimationManager::Instance().IsBuilding() ) 
+	{ // Laid out at the end of the build
+		MarkLayoutDirty();
+		return;
+	}
 	// Update parent position if exists and is dirty
 	if ( m_tAnchorInfo.m_pParent && m_tAnchorInfo.m_pParent->IsTouchAreaDirty() ) m_tAnchorInfo.m_pParent->DemandRefreshTouchArea();
-	if ( m_tAnchorInfo.m_pParent && m_bTouchAreaIsDirty ) RefreshPosition(); // FIXME: Not optimal, elements with parent are refreshed twice
 
-	// Get tex pos and size
-	float fTexPosX, fTexPosY, fTexW, fTexH;
-	m_spTexture->GetPos( fTexPosX, fTexPosY );
+	ResolveLayout();
+	CommitLayout();
+}
+
+/*
+	Computes the new touch area from the texture size and the parent rect without writing the screen mask.
+	Safe to run in parallel for elements whose parents are already resolved
+*/
+void GUIAnimation::ResolveLayout()
+{
+	const FrameRect tPrevTouchArea = m_tTouchArea;
+	// Get tex size first, anchor adjustments depend on it
+	float fTexW, fTexH;
 	m_spTexture->GetTargetSize( fTexW, fTexH );
-	// Update touch area
-	m_tTouchArea.Set( fTexPosX, fTexPosY, fTexW, fTexH );
+	m_tTouchArea.m_fW = fTexW;
+	m_tTouchArea.m_fH = fTexH;
+	// Update position
+	const hkvVec2 v2Position = ComputePosition();
+	m_tTouchArea.m_fX = v2Position.x;
+	m_tTouchArea.m_fY = v2Position.y;
+
+	m_bLayoutChanged = !( m_tTouchArea == tPrevTouchArea );
+}
+
+/*
+	Writes the resolved touch area to the screen mask
+*/
+void GUIAnimation::CommitLayout()
+{
+	// Set new position
+	m_spTexture->SetPos( m_tTouchArea.m_fX, m_tTouchArea.m_fY );
 	// Update trigger area
 	GUIAnimation::SetMapTouchArea( m_tTouchArea.m_fX, m_tTouchArea.m_fY, m_tTouchArea.m_fW, m_tTouchArea.m_fH, m_eID );
 	// Re-center the rotation anchor
 	m_spTexture->SetRotationCenter( m_tTouchArea.m_fW / 2.f, m_tTouchArea.m_fH / 2.f );
 
-	// Update position
-	RefreshPosition();
-	
-	// FIXME:
-	//m_bTouchAreaIsDirty = false;
+	m_bTouchAreaIsDirty = false;
+
+	// Children are positioned from this rect
+	if ( m_bLayoutChanged ) MarkChildrenLayoutDirty();
+	// and clipped by it
+	if ( m_bLayoutChanged && m_bClipChildren ) WakeSubtree();
+	m_bLayoutChanged = false;
 }
 
 
@@ -813,62 +1506,62 @@ void GUIAnimation::TryPlayOnEasingStartSound() const
 	if ( m_eOnEasingStartSound != eNoSound ) SoundManager::Instance()->PlaySound( m_eOnEasingStartSound, Vision::Camera.GetMainCamera()->GetPosition(), false );
 }
 
-EasingAnimation* GUIAnimation::AlphaTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AlphaTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return To( fStartTimeOut, fDuration, GAP_ALPHA, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::AlphaFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AlphaFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return From( fStartTimeOut, fDuration, GAP_ALPHA, fStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::AlphaFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AlphaFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return FromTo( fStartTimeOut, fDuration, GAP_ALPHA, fStart, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ColorTo( const float fStartTimeOut, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ColorTo( const float fStartTimeOut, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return To( fStartTimeOut, fDuration, GAP_COLOR, tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ColorFrom( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ColorFrom( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return From( fStartTimeOut, fDuration, GAP_COLOR, tStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ColorFromTo( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ColorFromTo( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return FromTo( fStartTimeOut, fDuration, GAP_COLOR, tStart, tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::AnglesTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AnglesTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return To( fStartTimeOut, fDuration, GAP_ANGLES, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::AnglesFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AnglesFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return From( fStartTimeOut, fDuration, GAP_ANGLES, fStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::AnglesFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::AnglesFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return FromTo( fStartTimeOut, fDuration, GAP_ANGLES, fStart, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ScaleTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ScaleTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return To( fStartTimeOut, fDuration, GAP_SCALE, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ScaleFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ScaleFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return From( fStartTimeOut, fDuration, GAP_SCALE, fStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::ScaleFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::ScaleFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return FromTo( fStartTimeOut, fDuration, GAP_SCALE, fStart, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
@@ -876,7 +1569,7 @@ EasingAnimation* GUIAnimation::ScaleFromTo( const float fStartTimeOut, const flo
 /*
 	Position given in relative (normalized) measures from top left anchor
 */
-EasingAnimation* GUIAnimation::PositionTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::PositionTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return To( fStartTimeOut, fDuration, GAP_POSITION, v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
@@ -884,7 +1577,7 @@ EasingAnimation* GUIAnimation::PositionTo( const float fStartTimeOut, const floa
 /*
 	Position given in relative (normalized) measures from top left anchor
 */
-EasingAnimation* GUIAnimation::PositionFrom( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::PositionFrom( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return From( fStartTimeOut, fDuration, GAP_POSITION, v2Start, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
@@ -892,58 +1585,64 @@ EasingAnimation* GUIAnimation::PositionFrom( const float fStartTimeOut, const fl
 /*
 	Position given in relative (normalized) measures from top left anchor
 */
-EasingAnimation* GUIAnimation::PositionFromTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::PositionFromTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return FromTo( fStartTimeOut, fDuration, GAP_POSITION, v2Start, v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( true, fStartTimeOut, fDuration, eProperty, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( true, fStartTimeOut, fDuration, eProperty, tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( true, fStartTimeOut, fDuration, eProperty, v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( false, fStartTimeOut, fDuration, eProperty, fStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( false, fStartTimeOut, fDuration, eProperty, tStart, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( false, fStartTimeOut, fDuration, eProperty, v2Start, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( fStartTimeOut, fDuration, eProperty, fStart, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( fStartTimeOut, fDuration, eProperty, tStart, tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
 	return Animate( fStartTimeOut, fDuration, eProperty, v2Start, v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
+	if ( bAnimateTo ) 
+	{ // Keep the running tween if any
+		GUITweenHandle tRetargeted = RetargetEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( fTarget, 0.f, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+		if ( tRetargeted.IsValid() ) return tRetargeted;
+	}
+
 	// Play sound event
 	TryPlayOnEasingStartSound();
 
@@ -970,6 +1669,7 @@ EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStar
 	default:
 		break;
 	}
+	fCurrent -= m_av4AdditiveOffset[eProperty].x; // Base value
 
 	float fStart = ( bAnimateTo ) ? fCurrent : fTarget;
 
@@ -980,46 +1680,19 @@ EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStar
 	return Animate( fStartTimeOut, fDuration, eProperty, fStart, _fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
-	OverrideAnimTypeIfExists( eProperty );
-
-	// Set the start value
-	switch ( eProperty ) 
-	{
-	case GAP_ALPHA:
-		{
-			if ( m_spTexture ) 
-			{
-				VColorRef tStartColor = m_spTexture->GetColor();
-				tStartColor.a = static_cast<UBYTE>(fStart);
-				m_spTexture->SetColor( tStartColor );
-			}
-			break;
-		}
-	case GAP_ANGLES:
-		{
-			SetRotationAngle( fStart );
-			break;
-		}
-	case GAP_SCALE:
-		{
-			SetScale( fStart, fStart );
-			break;
-		}
-	default:
-		break;
-	}
-
-	m_bActiveEaseAnim = true;
-	EasingAnimation* pEasingAnim = new EasingAnimation( this, fStartTimeOut, fDuration, eProperty, fStart, fTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
-	m_aEasingAnims[ m_aEasingAnims.GetFreePos() ] = pEasingAnim;
-
-	return pEasingAnim;
+	return StartEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( fStart, 0.f, 0.f, 0.f ), hkvVec4( fTarget, 0.f, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
+	if ( bAnimateTo ) 
+	{ // Keep the running tween if any
+		GUITweenHandle tRetargeted = RetargetEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( tTarget.r, tTarget.g, tTarget.b, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+		if ( tRetargeted.IsValid() ) return tRetargeted;
+	}
+
 	// Play sound event
 	TryPlayOnEasingStartSound();
 
@@ -1034,28 +1707,27 @@ EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStar
 	return Animate( fStartTimeOut, fDuration, eProperty, tStart, _tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
-	OverrideAnimTypeIfExists( eProperty );
-
-	// Set the start value
-	if ( m_spTexture ) m_spTexture->SetColor( tStart );
-
-	m_bActiveEaseAnim = true;
-	EasingAnimation* pEasingAnim = new EasingAnimation( this, fStartTimeOut, fDuration, eProperty, tStart, tTarget, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
-	m_aEasingAnims[ m_aEasingAnims.GetFreePos() ] = pEasingAnim;
-
-	return pEasingAnim;
+	return StartEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( tStart.r, tStart.g, tStart.b, 0.f ), hkvVec4( tTarget.r, tTarget.g, tTarget.b, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
 {
+	if ( bAnimateTo ) 
+	{ // Keep the running tween if any
+		GUITweenHandle tRetargeted = RetargetEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+		if ( tRetargeted.IsValid() ) return tRetargeted;
+	}
+
 	// Play sound event
 	TryPlayOnEasingStartSound();
 
 	hkvVec2 v2Current( 0.f, 0.f );
-	// Grab the current value
+	// Grab the current value (without additive offsets)
 	GetRelativePostition( v2Current.x, v2Current.y );
+	v2Current.x -= m_av4AdditiveOffset[eProperty].x;
+	v2Current.y -= m_av4AdditiveOffset[eProperty].y;
 	const hkvVec2& v2Start = ( bAnimateTo ) ? v2Current : v2Target;
 
 	// If we are doing a 'from', the target is our current position
@@ -1065,18 +1737,223 @@ EasingAnimation* GUIAnimation::Animate( const bool bAnimateTo, const float fStar
 	return Animate( fStartTimeOut, fDuration, eProperty, v2Start, _v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
 }
 
-EasingAnimation* GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+GUITweenHandle GUIAnimation::Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale ) 
+{
+	return StartEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( v2Start.x, v2Start.y, 0.f, 0.f ), hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+}
+
+/*
+	Sets the start value and takes a tween from the registry for the property
+*/
+GUITweenHandle GUIAnimation::StartEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale )
 {
 	OverrideAnimTypeIfExists( eProperty );
+	StopSpring( eProperty );
 
 	// Set the start value
-	PositionFromTopLeft( v2Start.y, v2Start.x );
+	ApplyEasingValue( eProperty, v4Start );
+
+	m_bActiveEaseAnim = true;
+	Wake();
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	const int iSlot = tRegistry.Acquire();
+	tRegistry.GetTween( iSlot )->Init( this, fStartTimeOut, fDuration, eProperty, v4Start, v4Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+	m_aiEasingSlots[eProperty] = iSlot;
+
+	return tRegistry.GetHandle( iSlot );
+}
+
+/*
+	Sends the running tween of the property to a new target without restarting it: same slot and handle, and
+	the motion keeps its current velocity. Returns an invalid handle when there is nothing to retarget
+	(no tween, delayed start requested, tween not started yet or driven by another clock)
+*/
+GUITweenHandle GUIAnimation::RetargetEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale )
+{
+	if ( fStartTimeOut > 0.f ) return GUITweenHandle();
+	EasingAnimation* pEasing = GetEasing( eProperty );
+	if ( !pEasing || pEasing->IsFinished() || !pEasing->HasStarted() || pEasing->IsAffectedByTimeScale() != bAffectedByTimeScale ) return GUITweenHandle();
+
+	if ( !pEasing->Retarget( v4Target, fDuration, pfEaseMethod ) ) return GUITweenHandle();
+	pEasing->SetCallback( pfOnComplete );
+	return GetEasingHandle( eProperty );
+}
+
+GUITweenHandle GUIAnimation::AdditiveFromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale )
+{
+	return StartAdditiveEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( fStart, 0.f, 0.f, 0.f ), hkvVec4( fTarget, 0.f, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+}
+
+/*
+	Offset given in relative (normalized) measures
+*/
+GUITweenHandle GUIAnimation::AdditiveFromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale )
+{
+	return StartAdditiveEasing( fStartTimeOut, fDuration, eProperty, hkvVec4( v2Start.x, v2Start.y, 0.f, 0.f ), hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+}
+
+GUITweenHandle GUIAnimation::StartAdditiveEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale )
+{
+	TryPlayOnEasingStartSound();
 
 	m_bActiveEaseAnim = true;
-	EasingAnimation* pEasingAnim = new EasingAnimation( this, fStartTimeOut, fDuration, eProperty, v2Start, v2Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
-	m_aEasingAnims[ m_aEasingAnims.GetFreePos() ] = pEasingAnim;
+	Wake();
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	const int iSlot = tRegistry.Acquire();
+	EasingAnimation* pEasing = tRegistry.GetTween( iSlot );
+	pEasing->Init( this, fStartTimeOut, fDuration, eProperty, v4Start, v4Target, pfEaseMethod, pfOnComplete, bAffectedByTimeScale );
+	pEasing->SetAdditive( true );
+	m_aAdditiveSlots[ m_uiNumAdditive++ ] = iSlot;
+
+	return tRegistry.GetHandle( iSlot );
+}
+
+/*
+	Writes base value + sum of additive tweens for every property they touch. Finished additive tweens leave their
+	last offset in the base value and are released
+*/
+void GUIAnimation::ApplyAdditiveEasings()
+{
+	GUITweenRegistry& tRegistry = GUIAnimationManager::Instance().GetTweenRegistry();
+	hkvVec4 av4Live[GAP_COUNT];
+	hkvVec4 av4Baked[GAP_COUNT];
+	bool abTouched[GAP_COUNT];
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		av4Live[i].setZero();
+		av4Baked[i].setZero();
+		abTouched[i] = false;
+	}
+
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumAdditive; i++ ) 
+	{
+		const int iSlot = m_aAdditiveSlots[i];
+		const EasingAnimation* pEasing = tRegistry.GetTween( iSlot );
+		const eGUIAnimProperty eProperty = pEasing->GetAnimProperty();
+		abTouched[eProperty] = true;
+		if ( pEasing->IsFinished() ) 
+		{
+			av4Baked[eProperty] += pEasing->GetValue();
+			tRegistry.Release( iSlot );
+			continue;
+		}
+		av4Live[eProperty] += pEasing->GetValue();
+		m_aAdditiveSlots[ uiNumKept++ ] = iSlot;
+	}
+	m_uiNumAdditive = uiNumKept;
+
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		if ( !abTouched[i] ) continue;
+		const eGUIAnimProperty eProperty = static_cast<eGUIAnimProperty>(i);
+		if ( eProperty == GAP_POSITION )
+		{ // Anchor offsets are the base: live offsets are added by ComputePosition, finished ones folded into the offsets
+			const bool bBaked = av4Baked[i].x != 0.f || av4Baked[i].y != 0.f;
+			if ( bBaked )
+			{
+				float fDX = av4Baked[i].x;
+				float fDY = av4Baked[i].y;
+				if ( m_tAnchorInfo.m_eUIPrecision != UIP_PERCENTAGE )
+				{
+					fDX *= ParentWidth();
+					fDY *= ParentHeight();
+				}
+				m_tAnchorInfo.m_fOffsetX += ( m_tAnchorInfo.m_eUIxAnchor == UXA_RIGHT ) ? -fDX : fDX;
+				m_tAnchorInfo.m_fOffsetY += ( m_tAnchorInfo.m_eUIyAnchor == UYA_BOTTOM ) ? -fDY : fDY;
+			}
+			if ( bBaked || av4Live[i] != m_av4AdditiveOffset[i] )
+			{
+				m_av4AdditiveOffset[i] = av4Live[i];
+				RefreshPosition();
+			}
+			continue;
+		}
+		const hkvVec4 v4Displayed = av4Live[i] + av4Baked[i];
+		if ( v4Displayed != m_av4AdditiveOffset[i] ) 
+			SetPropertyValue( eProperty, GetPropertyValue( eProperty ) - m_av4AdditiveOffset[i] + v4Displayed );
+		m_av4AdditiveOffset[i] = av4Live[i];
+	}
+}
+
+void GUIAnimation::SpringTo( const eGUIAnimProperty eProperty, const float fTarget, const float fStiffness, const float fDamping, const float fRestEpsilon )
+{
+	StartSpring( eProperty, hkvVec4( fTarget, 0.f, 0.f, 0.f ), fStiffness, fDamping, fRestEpsilon );
+}
+
+/*
+	Target given in relative (normalized) measures
+*/
+void GUIAnimation::SpringTo( const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const float fStiffness, const float fDamping, const float fRestEpsilon )
+{
+	StartSpring( eProperty, hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), fStiffness, fDamping, fRestEpsilon );
+}
+
+void GUIAnimation::SetSpringVelocity( const eGUIAnimProperty eProperty, const hkvVec2& v2Velocity )
+{
+	if ( !IsSpringActive( eProperty ) ) return;
+	m_pSprings[eProperty].m_v4Velocity.set( v2Velocity.x, v2Velocity.y, 0.f, 0.f );
+}
+
+/*
+	The property keeps the value reached so far
+*/
+void GUIAnimation::StopSpring( const eGUIAnimProperty eProperty )
+{
+	m_uiActiveSprings &= ~(1u << eProperty);
+	m_uiSpringsToCommit &= ~(1u << eProperty);
+}
+
+/*
+	A moving spring only gets its target and constants changed. A new one replaces the tween of the property and
+	starts at rest from the current value
+*/
+GUISpring* GUIAnimation::StartSpring( const eGUIAnimProperty eProperty, const hkvVec4& v4Target, const float fStiffness, const float fDamping, const float fRestEpsilon )
+{
+	const float fCriticalDamping = 2.f * hkvMath::sqrt( fStiffness );
+	const float fFinalDamping = ( fDamping < 0.f ) ? fCriticalDamping : fDamping;
+	const float fFinalEpsilon = ( fRestEpsilon < 0.f ) ? GUISpring::GetDefaultRestEpsilon( eProperty ) : fRestEpsilon;
+	if ( IsSpringActive( eProperty ) ) 
+	{
+		GUISpring& tSpring = m_pSprings[eProperty];
+		tSpring.m_v4Target = v4Target;
+		tSpring.m_fStiffness = fStiffness;
+		tSpring.m_fDamping = fFinalDamping;
+		tSpring.m_fRestEpsilon = fFinalEpsilon;
+		return &tSpring;
+	}
+
+	OverrideAnimTypeIfExists( eProperty );
+	if ( !m_pSprings ) m_pSprings = new ( m_pArena ) GUISpring[GAP_COUNT];
+	GUISpring& tSpring = m_pSprings[eProperty];
+	tSpring.Init( GetPropertyValue( eProperty ) - m_av4AdditiveOffset[eProperty], v4Target, fStiffness, fFinalDamping, fFinalEpsilon );
+	m_uiActiveSprings |= (1u << eProperty);
+	Wake();
+	return &tSpring;
+}
+
+/*
+	Safe to run in parallel for different elements, values are applied on commit
+*/
+void GUIAnimation::EvaluateSprings( const float fDeltaTime )
+{
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		const unsigned int uiBit = 1u << i;
+		if ( !( m_uiActiveSprings & uiBit ) ) continue;
+		if ( m_pSprings[i].Integrate( fDeltaTime ) ) m_uiActiveSprings &= ~uiBit; // Sleep
+		m_uiSpringsToCommit |= uiBit;
+	}
+}
 
-	return pEasingAnim;
+void GUIAnimation::CommitSprings()
+{
+	for ( int i = 0; i < GAP_COUNT; i++ ) 
+	{
+		if ( m_uiSpringsToCommit & (1u << i) ) 
+			ApplyEasingValue( static_cast<eGUIAnimProperty>(i), m_pSprings[i].m_v4Value );
+	}
+	m_uiSpringsToCommit = 0;
 }
 
 
@@ -1415,70 +2292,61 @@ float Easing::Elastic::EaseInOut( const float fT )
 }
 
 // EasingAnimation member functions
-EasingAnimation::EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const hkvVec2 v2Start, const hkvVec2 v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback, const bool bAffectedByTimeScale )
+EasingAnimation::EasingAnimation()
 {
-	m_pGUIObject = pGUIObject;
-	m_fDuration = fDuration;
-	m_eAnimProperty = eProperty;
-	m_pfCallback = pfCallback;
-	m_pfEase = pfEaseMethod;
-	m_bAffectedByTimeScale = bAffectedByTimeScale;
-	m_v2Start = v2Start;
-	m_v2Target = v2Target;
+	m_pfCallback = 0;
+	m_pfEase = 0;
+	m_uiEaseToken = 0;
+	m_pGUIObject = 0;
+	m_eAnimProperty = GAP_POSITION;
+	m_fStartTime = 0.f;
+	m_fDuration = 0.f;
+	m_bRunning = false;
+	m_bFinished = true;
+	m_bAffectedByTimeScale = true;
 	m_bAutoreverse = false;
-	// Also init other property variables
-	m_fStart = 0.f; m_fTarget = 0.f;
-	m_tStart.SetRGBA( 0, 0, 0, 0 ); m_tTarget.SetRGBA( 0, 0, 0, 0 );
-
-	m_bFinished = false;
-	m_bRunning = true;
-	// Store out start time
-	m_fStartTime = bAffectedByTimeScale ? Vision::GetTimer()->GetTime() : Vision::GetTimer()->GetCurrentTime();
-	m_fStartTime += fStartTimeOut;
+	m_bJustFinished = false;
+	m_bAdditive = false;
+	m_v4Start.setZero(); m_v4Target.setZero();
+	m_v4CarryVelocity.setZero();
+	m_bHasPending = false;
+	m_v4Pending.setZero();
 }
 
-EasingAnimation::EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback, const bool bAffectedByTimeScale )
+/*
+	Resets the tween for a new use. Called by GUIAnimation when taken from the registry
+*/
+void EasingAnimation::Init( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback, const bool bAffectedByTimeScale )
 {
 	m_pGUIObject = pGUIObject;
 	m_fDuration = fDuration;
 	m_eAnimProperty = eProperty;
 	m_pfCallback = pfCallback;
 	m_pfEase = pfEaseMethod;
+	m_uiEaseToken = GUIEasingCurve::GetEaseToken( pfEaseMethod );
 	m_bAffectedByTimeScale = bAffectedByTimeScale;
-	m_fStart = fStart;
-	m_fTarget = fTarget;
+	m_v4Start = v4Start;
+	m_v4Target = v4Target;
+	m_v4CarryVelocity.setZero();
 	m_bAutoreverse = false;
-	// Also init other property variables
-	m_v2Start = hkvVec2::ZeroVector(); m_v2Target = hkvVec2::ZeroVector();
-	m_tStart.SetRGBA( 0, 0, 0, 0 ); m_tTarget.SetRGBA( 0, 0, 0, 0 );
+	m_bAdditive = false;
 
 	m_bFinished = false;
+	m_bJustFinished = false;
 	m_bRunning = true;
+	m_bHasPending = false;
+	m_v4Pending.setZero();
 	// Store out start time
-	m_fStartTime = bAffectedByTimeScale ? Vision::GetTimer()->GetTime() : Vision::GetTimer()->GetCurrentTime();
+	m_fStartTime = GetClockTime();
 	m_fStartTime += fStartTimeOut;
 }
 
-EasingAnimation::EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const VColorRef tStart, const VColorRef tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback, const bool bAffectedByTimeScale )
+/*
+	Scaled time of the object's time group or real time, from the GUI clock
+*/
+float EasingAnimation::GetClockTime() const
 {
-	m_pGUIObject = pGUIObject;
-	m_fDuration = fDuration;
-	m_eAnimProperty = eProperty;
-	m_pfCallback = pfCallback;
-	m_pfEase = pfEaseMethod;
-	m_bAffectedByTimeScale = bAffectedByTimeScale;
-	m_tStart = tStart;
-	m_tTarget = tTarget;
-	m_bAutoreverse = false;
-	// Also init other property variables
-	m_fStart = 0.f; m_fTarget = 0.f;
-	m_v2Start = hkvVec2::ZeroVector(); m_v2Target = hkvVec2::ZeroVector();
-
-	m_bFinished = false;
-	m_bRunning = true;
-	// Store out start time
-	m_fStartTime = bAffectedByTimeScale ? Vision::GetTimer()->GetTime() : Vision::GetTimer()->GetCurrentTime();
-	m_fStartTime += fStartTimeOut;
+	return GUIAnimationManager::Instance().GetClock().GetTime( m_pGUIObject->GetTimeGroup(), m_bAffectedByTimeScale );
 }
 
 EasingAnimation::~EasingAnimation()
@@ -1489,54 +2357,23 @@ EasingAnimation::~EasingAnimation()
 }
 
 void EasingAnimation::Update( const float fDeltaTime )
+{
+	Evaluate( fDeltaTime );
+	Commit();
+}
+
+/*
+	Computes the eased value into the pending slot. Writes nothing outside this object
+*/
+void EasingAnimation::Evaluate( const float fDeltaTime )
 {
 	if ( m_bRunning ) 
 	{
-		float fCurrentTime = m_bAffectedByTimeScale ? Vision::GetTimer()->GetTime() : Vision::GetTimer()->GetCurrentTime();
+		float fCurrentTime = GetClockTime();
 		if ( m_fStartTime > fCurrentTime ) return;
-		// Get our easing position
-		float fEasePos = hkvMath::clamp( (fCurrentTime - m_fStartTime) / m_fDuration, 0.f, 1.f );
-		fEasePos = m_pfEase( fEasePos );
-
-		// Set the proper property
-		switch ( m_eAnimProperty ) 
-		{
-		case GAP_POSITION:
-			{
-				hkvVec2 v2Pos( 0.f , 0.f );
-				v2Pos.setInterpolate( m_v2Start, m_v2Target, fEasePos );
-				m_pGUIObject->PositionFromTopLeft( v2Pos.y, v2Pos.x );
-				break;
-			}
-		case GAP_SCALE:
-			{
-				float fScale = hkvMath::interpolate( m_fStart, m_fTarget, fEasePos );
-				m_pGUIObject->SetScale( fScale, fScale );
-				break;
-			}
-		case GAP_ANGLES:
-			{
-				m_pGUIObject->SetRotationAngle( hkvMath::interpolate( m_fStart, m_fTarget, fEasePos ) );
-				break;
-			}
-		case GAP_ALPHA:
-			{
-				VColorRef tColor = m_pGUIObject->GetTexture()->GetColor();
-				tColor.a = static_cast<UBYTE>(hkvMath::interpolate( m_fStart, m_fTarget, fEasePos ));
-				m_pGUIObject->SetColor( tColor );
-				break;
-			}
-		case GAP_COLOR:
-			{
-				VColorRef tColor( 0, 0, 0, 0 );
-				tColor.Lerp( m_tStart, m_tTarget, fEasePos );
-				tColor.a = m_pGUIObject->GetTexture()->GetColor().a; // Set current alpha value
-				m_pGUIObject->SetColor( tColor );
-				break;
-			}
-		default:
-			break;
-		}
+		// Store the value
+		m_v4Pending = ValueAt( fCurrentTime );
+		m_bHasPending = true;
 	
 		// See if we are done with our animation yet
 		if ( (m_fStartTime + m_fDuration) <= fCurrentTime ) 
@@ -1547,17 +2384,10 @@ void EasingAnimation::Update( const float fDeltaTime )
 				m_bAutoreverse = false; // Make sure this only happens once
 
 				// Flip out start and target
-				hkvVec2 v2Temp = m_v2Start;
-				m_v2Start = m_v2Target;
-				m_v2Target = v2Temp;
-				// Flip alpha variables
-				float fTemp = m_fStart;
-				m_fStart = m_fTarget;
-				m_fTarget = fTemp;
-				// Flip color variables
-				VColorRef tTemp = m_tStart;
-				m_tStart = m_tTarget;
-				m_tTarget = tTemp;
+				hkvVec4 v4Temp = m_v4Start;
+				m_v4Start = m_v4Target;
+				m_v4Target = v4Temp;
+				m_v4CarryVelocity.setZero();
 				// Reset the start time
 				m_fStartTime = fCurrentTime;
 			}
@@ -1565,17 +2395,136 @@ void EasingAnimation::Update( const float fDeltaTime )
 			{
 				m_bRunning = false;
 				m_bFinished = true;
+				m_bJustFinished = true;
 			}
 		}
-	} // End while
+	}
+}
+
+/*
+	Applies the pending value to the GUI object and notifies completion
+*/
+void EasingAnimation::Commit()
+{
+	if ( m_bHasPending )
+	{
+		m_bHasPending = false;
+		// Additive values are summed by the owner after every tween committed
+		if ( !m_bAdditive ) m_pGUIObject->ApplyEasingValue( m_eAnimProperty, m_v4Pending );
+	}
+
+	if ( m_bJustFinished ) 
+	{
+		m_bJustFinished = false;
+		OnFinished();
+	}
+}
+
+hkvVec4 EasingAnimation::ValueAt( const float fTime ) const
+{
+	// Get our easing position
+	const float fT = ( m_fDuration > 0.f ) ? hkvMath::clamp( (fTime - m_fStartTime) / m_fDuration, 0.f, 1.f ) : 1.f;
+	hkvVec4 v4Value;
+	v4Value.setInterpolate( m_v4Start, m_v4Target, GUIEasingCurve::Resolve( m_pfEase, m_uiEaseToken )( fT ) );
+	// Retarget velocity: Hermite t(1-t)^2 term, slope 1 at the start and zero at both ends
+	v4Value += m_v4CarryVelocity * ( m_fDuration * fT * (1.f - fT) * (1.f - fT) );
+	return v4Value;
+}
+
+/*
+	Heads to a new target from the value reached so far, keeping the tween slot. The velocity at the retarget
+	instant is preserved: the initial slope of the curve is compensated by a term that fades out along the tween.
+	Finished tweens are about to be released and cannot be retargeted. Play state is not changed
+*/
+bool EasingAnimation::Retarget( const hkvVec4& v4Target, const float fDuration, const pfEase pfEaseMethod )
+{
+	if ( m_bFinished ) return false;
 
-	if ( m_bFinished ) OnFinished();
+	if ( pfEaseMethod ) 
+	{
+		m_pfEase = pfEaseMethod;
+		m_uiEaseToken = GUIEasingCurve::GetEaseToken( pfEaseMethod );
+	}
+	const float fCurrentTime = GetClockTime();
+	if ( fCurrentTime < m_fStartTime ) 
+	{ // Not started, keep the delay
+		m_v4Target = v4Target;
+		m_fDuration = fDuration;
+		return true;
+	}
+
+	const hkvVec4 v4Value = ValueAt( fCurrentTime );
+	hkvVec4 v4Velocity( 0.f, 0.f, 0.f, 0.f );
+	if ( m_bRunning ) v4Velocity = ( v4Value - ValueAt( fCurrentTime - RETARGET_VELOCITY_STEP ) ) * ( 1.f / RETARGET_VELOCITY_STEP );
+
+	m_v4Start = v4Value;
+	m_v4Target = v4Target;
+	m_fDuration = hkvMath::Max( fDuration, 0.f );
+	m_fStartTime = fCurrentTime;
+	m_v4CarryVelocity.setZero();
+	if ( m_fDuration > 0.f ) 
+	{
+		const pfEase pfCurrentEase = GUIEasingCurve::Resolve( m_pfEase, m_uiEaseToken );
+		const float fEaseSlope = ( pfCurrentEase( RETARGET_VELOCITY_STEP ) - pfCurrentEase( 0.f ) ) / RETARGET_VELOCITY_STEP;
+		m_v4CarryVelocity = v4Velocity - ( m_v4Target - m_v4Start ) * ( fEaseSlope / m_fDuration );
+	}
+	m_pGUIObject->Wake();
+	return true;
 }
 
 void EasingAnimation::OnFinished()
 {
-	m_pGUIObject->TryPlayOnEasingCompleteSound();
+	// The callback may start a new tween that reuses this object, dont touch members after it
+	GUIAnimation* pGUIObject = m_pGUIObject;
+	const pfGUIEasingAnimationCallback pfCallback = m_pfCallback;
+	const eGUIAnimProperty eProperty = m_eAnimProperty;
+
+	pGUIObject->TryPlayOnEasingCompleteSound();
+
+	if ( pfCallback )
+		pfCallback( pGUIObject, eProperty );
+}
+
+
+// GUISpring member functions
+void GUISpring::Init( const hkvVec4& v4Value, const hkvVec4& v4Target, const float fStiffness, const float fDamping, const float fRestEpsilon )
+{
+	m_v4Value = v4Value;
+	m_v4Velocity.setZero();
+	m_v4Target = v4Target;
+	m_fStiffness = fStiffness;
+	m_fDamping = fDamping;
+	m_fRestEpsilon = fRestEpsilon;
+}
+
+float GUISpring::GetDefaultRestEpsilon( const eGUIAnimProperty eProperty )
+{
+	static const float s_afRestEpsilon[GAP_COUNT] = { 0.0005f, 0.001f, 0.05f, 0.5f, 0.5f };
+	return s_afRestEpsilon[eProperty];
+}
+
+/*
+	Semi-implicit Euler in fixed substeps so stiff springs stay stable on long frames
+*/
+bool GUISpring::Integrate( const float fDeltaTime )
+{
+	if ( fDeltaTime <= 0.f ) return false;
+
+	const int iNumSteps = hkvMath::Min( static_cast<int>( hkvMath::ceil( fDeltaTime / GUI_SPRING_MAX_STEP ) ), GUI_SPRING_MAX_SUBSTEPS );
+	const float fStep = fDeltaTime / iNumSteps;
+	for ( int i = 0; i < iNumSteps; i++ ) 
+	{
+		const hkvVec4 v4Accel = ( m_v4Target - m_v4Value ) * m_fStiffness - m_v4Velocity * m_fDamping;
+		m_v4Velocity += v4Accel * fStep;
+		m_v4Value += m_v4Velocity * fStep;
+	}
 
-	if ( m_pfCallback )
-		m_pfCallback( m_pGUIObject, m_eAnimProperty );
+	// Still moving if any component is away from the target or fast enough to move the epsilon within a 60 fps frame
+	const hkvVec4 v4Offset = m_v4Target - m_v4Value;
+	const float fOffset = hkvMath::Max( hkvMath::Max( hkvMath::Abs( v4Offset.x ), hkvMath::Abs( v4Offset.y ) ), hkvMath::Max( hkvMath::Abs( v4Offset.z ), hkvMath::Abs( v4Offset.w ) ) );
+	const float fSpeed = hkvMath::Max( hkvMath::Max( hkvMath::Abs( m_v4Velocity.x ), hkvMath::Abs( m_v4Velocity.y ) ), hkvMath::Max( hkvMath::Abs( m_v4Velocity.z ), hkvMath::Abs( m_v4Velocity.w ) ) );
+	if ( fOffset > m_fRestEpsilon || fSpeed * (1.f / 60.f) > m_fRestEpsilon ) return false;
+	m_v4Value = m_v4Target;
+	m_v4Velocity.setZero();
+	return true;
 }
@@ -2,12 +2,16 @@
 #define GUIANIMATION_H_INCLUDED
 
 #include "GlobalTypes.h"
+#include "GUITweenRegistry.h"
+#include "GUIArena.h"
 #include <string>
 #include <sstream>
 
 
 class GUIAnimationManager;
 class GUIAnimation;
+class IGUIQuadProvider;
+class GUINineSlice;
 
 
 enum eGUIAnimProperty 
@@ -16,7 +20,8 @@ enum eGUIAnimProperty
 	GAP_SCALE, 
 	GAP_ANGLES, 
 	GAP_ALPHA, 
-	GAP_COLOR
+	GAP_COLOR, 
+	GAP_COUNT
 };
 
 enum eGUIAnimOrder 
@@ -37,6 +42,11 @@ typedef void (*pfGUITouchAnimationCallback)(GUIAnimation* pSender);
 typedef void (*pfGUIEasingAnimationCallback)(GUIAnimation* pSender,eGUIAnimProperty eProperty);
 // Easing function type
 typedef float (*pfEase)(const float fT);
+// Loaded TexturePacker atlas (GUIAnimationManager::LoadAtlas), handles are never reused
+typedef unsigned int GUIAtlasHandle;
+#define GUI_INVALID_ATLAS 0u
+
+#define GUI_SPRING_DEFAULT_STIFFNESS 170.f
 
 
 // Helper classes
@@ -128,28 +138,47 @@ namespace Easing
 	};
 };
 
+/*
+	Tween of one property. Instances are pooled by the tween registry and reinitialized with Init, user code
+	refers to them through GUITweenHandle. Values are packed like GUIAnimation::GetPropertyValue
+*/
 class EasingAnimation 
 {
 public:
-	EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const hkvVec2 v2Start, const hkvVec2 v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, eGUIAnimProperty eProperty, const VColorRef tStart, const VColorRef tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback = 0, const bool bAffectedByTimeScale = true );
+	EasingAnimation();
 	~EasingAnimation();
 
+	void Init( GUIAnimation* pGUIObject, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfCallback = 0, const bool bAffectedByTimeScale = true );
 
 	void Update( const float fDeltaTime );
+	void Evaluate( const float fDeltaTime );
+	void Commit();
 	void OnFinished();
+	bool Retarget( const hkvVec4& v4Target, const float fDuration, const pfEase pfEaseMethod = 0 );
+	hkvVec4 ValueAt( const float fTime ) const;
 
 	void Play() { m_bRunning = true; }
 	void Pause() { m_bRunning = false; }
 	void Stop() { m_bRunning = false; m_bFinished = true; }
 	bool IsFinished() const { return m_bFinished; }
+	bool HasStarted() const { return GetClockTime() >= m_fStartTime; }
 	eGUIAnimProperty GetAnimProperty() const { return m_eAnimProperty; }
+	GUIAnimation* GetGUIObject() const { return m_pGUIObject; }
 	void SetAutoreverse( const bool bAutoreverse ) { m_bAutoreverse = bAutoreverse; }
+	void SetCallback( const pfGUIEasingAnimationCallback pfCallback ) { m_pfCallback = pfCallback; }
+	bool IsAffectedByTimeScale() const { return m_bAffectedByTimeScale; }
+	// Additive tweens animate an offset that the owner sums to the property instead of writing it
+	void SetAdditive( const bool bAdditive ) { m_bAdditive = bAdditive; }
+	bool IsAdditive() const { return m_bAdditive; }
+	// Last evaluated value (zero before the tween starts)
+	const hkvVec4& GetValue() const { return m_v4Pending; }
 
 private:
+	float GetClockTime() const;
+
 	pfGUIEasingAnimationCallback m_pfCallback;
 	pfEase m_pfEase;
+	unsigned int m_uiEaseToken; // Designer curve behind the ease (GUIEasingCurve), 0 if none
 
 	GUIAnimation* m_pGUIObject;
 	eGUIAnimProperty m_eAnimProperty;
@@ -159,18 +188,54 @@ private:
 	bool m_bFinished;
 	bool m_bAffectedByTimeScale;
 	bool m_bAutoreverse;
+	bool m_bJustFinished; // Completion notified on commit
+	bool m_bAdditive;
+
+	hkvVec4 m_v4Start, m_v4Target;
+	hkvVec4 m_v4CarryVelocity; // Velocity kept from a retarget, fades out along the tween
 
-	hkvVec2 m_v2Start, m_v2Target;
-	float m_fStart, m_fTarget;
-	VColorRef m_tStart, m_tTarget;
+	// Value evaluated and waiting to be applied
+	bool m_bHasPending;
+	hkvVec4 m_v4Pending;
+};
+
+
+/*
+	Damped spring pulling one property towards a target, integrated with the element delta time. Meant for values
+	whose target changes every frame (follow the finger, scroll snapping): moving the target costs nothing.
+	Damping of 2 * sqrt(stiffness) is critical, the fastest approach without overshoot
+*/
+struct GUISpring
+{
+	GUI_DECLARE_ARENA_NEW
+
+	void Init( const hkvVec4& v4Value, const hkvVec4& v4Target, const float fStiffness, const float fDamping, const float fRestEpsilon );
+	// True once at rest: value snapped to the target and velocity zeroed
+	bool Integrate( const float fDeltaTime );
+	// Smallest change that shows on the property: relative position, scale, degrees, alpha and color channels
+	static float GetDefaultRestEpsilon( const eGUIAnimProperty eProperty );
+
+	hkvVec4 m_v4Value;
+	hkvVec4 m_v4Velocity; // Units per second
+	hkvVec4 m_v4Target;
+	float m_fStiffness;
+	float m_fDamping;
+	float m_fRestEpsilon; // At rest once both the distance to the target and the move within a 60 fps frame are below it
 };
 
 
 class GUIAnimation : public VUserDataObj
 {
 	friend class GUIAnimationManager;
+	friend class EasingAnimation;
+	friend class GUIText;
+	friend class GUITimeline;
+	friend class GUIContainer;
+	friend class GUITextureCache;
 
 public:
+	GUI_DECLARE_ARENA_NEW
+
 	struct FrameRect
 	{
 		FrameRect()
@@ -274,10 +339,14 @@ public:
 
 
 private:
-	GUIAnimation( const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType );
+	GUIAnimation( const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType, const GUIAtlasHandle uiAtlas = GUI_INVALID_ATLAS );
 
 
 	void RefreshPosition();
+	void ResolvePosition();
+	hkvVec2 ComputePosition() const;
+	void ResolveLayout();
+	void CommitLayout();
 	void PositionFromCenter( const float fPercentFromTop, const float fPercentFromLeft, const eUIyAnchor eYAnchor, const eUIxAnchor eXAnchor );
 	void PositionFromTopLeft( const float fPercentFromTop, const float fPercentFromLeft, const eUIyAnchor eYAnchor, const eUIxAnchor eXAnchor );
 	void PositionFromTopRight( const float fPercentFromTop, const float fPercentFromRight, const eUIyAnchor eYAnchor, const eUIxAnchor eXAnchor );
@@ -291,32 +360,61 @@ private:
 	float ParentWidth() const;
 	float ParentHeight() const;
 
-	EasingAnimation* To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true  );
-	EasingAnimation* To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-
-	EasingAnimation* Animate( const bool bAnimateTo, const float fStartTimeOut,  const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& fStart, const VColorRef& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
-	EasingAnimation* Animate(const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& fStart, const hkvVec2& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true  );
+	GUITweenHandle To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle To( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle From( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle FromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+
+	GUITweenHandle Animate( const bool bAnimateTo, const float fStartTimeOut,  const float fDuration, const eGUIAnimProperty eProperty, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle Animate( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const VColorRef& fStart, const VColorRef& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle Animate( const bool bAnimateTo, const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
+	GUITweenHandle Animate(const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& fStart, const hkvVec2& fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale = true );
 
 	void UpdateInput();
 	void UpdateAnimation( const float fDeltaTime );
-
-	void OverrideAnimTypeIfExists( const eGUIAnimProperty eProperty ) { for ( unsigned int i = 0; i < m_aEasingAnims.GetValidSize(); i++ ) if ( m_aEasingAnims[i]->GetAnimProperty() == eProperty && !m_aEasingAnims[i]->IsFinished() ) m_aEasingAnims[i]->Stop(); }
+	void EvaluateAnimation( const float fDeltaTime );
+	void CommitAnimation();
+
+	bool UpdateCulling( const unsigned int uiFrame );
+	void ComputeCulling( const unsigned int uiFrame, const bool bWasCulled );
+	void UpdateClipRect( const unsigned int uiFrame );
+	bool CanSleep() const { return !IsActiveAnim() && ( !m_bTouchAreaIsDirty || m_bCulled ); }
+	void AddChild( GUIAnimation* pChild );
+	void RemoveChild( GUIAnimation* pChild );
+	void MarkChildrenLayoutDirty();
+	void WakeChildren();
+	void WakeSubtree();
+	void SwapTexture( VTextureObject* pTexture, const float fTexelScale );
+	bool ReloadFrames();
+	static bool IsPointerDown();
+	void ResetForReuse( const eGUIAnimID eID, const eGUIAnimType eType );
+	static GUIAnimation* Clone( const GUIAnimation* pSource, const eGUIAnimID eID );
+
+	GUITweenHandle StartEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale );
+	GUITweenHandle RetargetEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale );
+	GUITweenHandle StartAdditiveEasing( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec4& v4Start, const hkvVec4& v4Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete, const bool bAffectedByTimeScale );
+	void ApplyAdditiveEasings();
+	void OverrideAnimTypeIfExists( const eGUIAnimProperty eProperty );
+	EasingAnimation* GetEasing( const eGUIAnimProperty eProperty ) const;
+	void ApplyEasingValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value );
+	hkvVec4 GetBaseValue( const eGUIAnimProperty eProperty ) const { return GetPropertyValue( eProperty ) - m_av4AdditiveOffset[eProperty]; }
+	void ApplyTimelineValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value );
+	GUISpring* StartSpring( const eGUIAnimProperty eProperty, const hkvVec4& v4Target, const float fStiffness, const float fDamping, const float fRestEpsilon );
+	void EvaluateSprings( const float fDeltaTime );
+	void CommitSprings();
 
 public:
 	virtual ~GUIAnimation();
 
-	static GUIAnimation* Create( const std::string& sSrcTextureFilepath, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType = GAT_ONCE );
+	// Frames are looked up in uiAtlas, in every loaded atlas if invalid. Allocated from pArena, the heap if null
+	static GUIAnimation* Create( const std::string& sSrcTextureFilepath, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const eGUIAnimType eType = GAT_ONCE, const GUIAtlasHandle uiAtlas = GUI_INVALID_ATLAS, GUIArena* pArena = 0 );
 	static void SetMapTouchArea( const float fX, const float fY, const float fWidth, const float fHeight, eGUIAnimID eID );
 
 
@@ -333,8 +431,12 @@ public:
 	int GetNumFrames() const { return m_iNumFrames; }
 	bool IsActiveFrameAnim() const { return m_bActiveFrameAnim; }
 	bool IsActiveEaseAnim() const { return m_bActiveEaseAnim; }
-	bool IsActiveAnim() const { return m_bActiveFrameAnim || m_bActiveEaseAnim; }
+	bool IsActiveSpring() const { return m_uiActiveSprings != 0; }
+	bool IsActiveAnim() const { return m_bActiveFrameAnim || m_bActiveEaseAnim || m_uiActiveSprings != 0; }
 	bool IsRunning() const { return m_bRunning; }
+	// Time group of the GUI clock driving easing and frame animations
+	void SetTimeGroup( const unsigned int uiGroup ) { m_uiTimeGroup = uiGroup; }
+	unsigned int GetTimeGroup() const { return m_uiTimeGroup; }
 
 	void Play();
 	void Stop();
@@ -347,6 +449,8 @@ public:
 	void StopEasing( const eGUIAnimProperty eProperty );
 	void StopAllEasings();
 	void RemoveEasingsFinished();
+	// Tween currently animating the property, invalid if none
+	GUITweenHandle GetEasingHandle( const eGUIAnimProperty eProperty ) const;
 
 	void SetRenderFrame( const unsigned int iFramePos );
 	void AddFrameRect( const FrameRect& tFrame ) { m_aFrameRects[ m_aFrameRects.GetFreePos() ] = tFrame; }
@@ -365,20 +469,45 @@ public:
 	void SetOnTouchUpSound( const eSounds eSound ) { m_eOnTouchUpSound = eSound; }
 	void SetOnEasingCompleteSound( const eSounds eSound ) { m_eOnEasingCompleteSound = eSound; }
 	void SetOnEasingStartSound( const eSounds eSound ) { m_eOnEasingStartSound = eSound; }
-	void SetTouchable( bool bTouchable ) { m_bTouchable = bTouchable; }
+	void SetTouchable( bool bTouchable );
 	bool IsTouchable() const { return m_bTouchable; }
 	BOOL IsVisible() const { return m_spTexture->IsVisible(); }
 	bool IsTouched() const { return m_bTouched; }
+	bool IsCulled() const { return m_bCulled; }
+	// Descendants are trimmed to this element rect (batched rendering), culled when fully outside and only touchable inside it
+	void SetClipChildren( const bool bClip );
+	bool IsClippingChildren() const { return m_bClipChildren; }
+	// Intersection of the clipping ancestors rects in screen pixels, updated with the culling state
+	bool HasClipRect() const { return m_bHasClipRect; }
+	const FrameRect& GetClipRect() const { return m_tClipRect; }
+	bool IsTouchPointInside( const float fX, const float fY ) const;
+	// Draws the element in place of its screen mask quad, always through the sprite batch
+	void SetQuadProvider( IGUIQuadProvider* pProvider );
+	IGUIQuadProvider* GetQuadProvider() const { return m_pQuadProvider; }
+	// Draws the current frame stretched as a panel of the element size, border insets in texels
+	void SetNineSlice( const float fLeft, const float fTop, const float fRight, const float fBottom );
+	void ClearNineSlice();
+	GUINineSlice* GetNineSlice() const { return m_pNineSlice; }
+	// Arena the element and its springs and nine-slice come from, null for the heap
+	GUIArena* GetArena() const { return m_pArena; }
+	// Texture texels per layout pixel, below 1 while a lower texture tier is loaded
+	float GetTexelScale() const { return m_fTexelScale; }
+	GUIAtlasHandle GetAtlas() const { return m_uiAtlas; }
 
 	void DemandRefreshTouchArea() { RefreshTouchArea(); }
 	bool IsTouchAreaDirty() const { return m_bTouchAreaIsDirty; }
 	UIAnchorInfo& GetAnchorInfo() { return m_tAnchorInfo; }
 	const UIAnchorInfo& GetAnchorInfo() const { return m_tAnchorInfo; }
-	void SetParent( GUIAnimation* pAnimParent ) { m_tAnchorInfo.m_pParent = pAnimParent; m_bTouchAreaIsDirty = true; }
+	void SetParent( GUIAnimation* pAnimParent );
+	// PositionFrom functions take percentages, switch to pixel offsets after calling them
+	void SetPositionPrecision( const eUIPrecision ePrecision ) { m_tAnchorInfo.m_eUIPrecision = ePrecision; RefreshPosition(); }
+	void MarkLayoutDirty() { m_bTouchAreaIsDirty = true; Wake(); }
+	void Wake();
+	bool IsAwake() const { return m_bAwake; }
 	void GetPosition( float& fX, float& fY ) const { fX = m_tTouchArea.m_fX; fY = m_tTouchArea.m_fY; } // FIXME: Return pos from actual current anchor
 	void GetRelativePostition( float& fRelX, float& fRelY ) const;
 	void GetRelativeSize( float& fRelW, float& fRelH ) const;
-	void SetRotationAngle( const float fAngle ) { if ( m_spTexture ) m_spTexture->SetRotationAngle( fAngle ); }
+	void SetRotationAngle( const float fAngle ) { if ( m_spTexture ) { m_spTexture->SetRotationAngle( fAngle ); Wake(); } }
 	void InitializeSize();
 	void SetSize( const float fWidth, const float fHeight );
 	void SetRelativeSize( const float fNormWidth, const float fNormHeight );
@@ -387,7 +516,10 @@ public:
 	hkvVec2 GetScale() const { float fScaleX, fScaleY; GetScale( fScaleX, fScaleY ); return hkvVec2( fScaleX, fScaleY ); }
 	void GetSize( float& fWidth, float& fHeight ) const { fWidth = m_tTouchArea.m_fW; fHeight = m_tTouchArea.m_fH; }
 	const hkvVec2 GetSize() const { return hkvVec2( m_tTouchArea.m_fW, m_tTouchArea.m_fH ); }
-	void SetColor( const VColorRef& tColor ) { if ( m_spTexture ) m_spTexture->SetColor( tColor ); }
+	void SetColor( const VColorRef& tColor ) { if ( m_spTexture ) { m_spTexture->SetColor( tColor ); Wake(); } }
+	// Any animatable property packed in a vector: position (x, y relative from top left), scale, angle and alpha (x), color (x, y, z as r, g, b)
+	hkvVec4 GetPropertyValue( const eGUIAnimProperty eProperty ) const;
+	void SetPropertyValue( const eGUIAnimProperty eProperty, const hkvVec4& v4Value );
 	
 	void RefreshTouchArea();
 	void PositionFromCenter( const float fPercentFromTop, const float fPercentFromLeft );
@@ -403,6 +535,8 @@ public:
 	void PositionFromLeft( const float fPercentFromTop, const float fPercentFromLeft );
 	void PositionFromRight( const float fPercentFromRight );
 	void PositionFromRight( const float fPercentFromTop, const float fPercentFromRight );
+	// Pixel offsets from the parent top left corner in a single position refresh, used by containers
+	void PixelPositionFromTopLeft( const float fPixelsFromTop, const float fPixelsFromLeft );
 
 	void TryPlayOnEasingCompleteSound() const;
 	void TryPlayOnEasingStartSound() const;
@@ -415,22 +549,36 @@ public:
 	void OnTouchUp();
 	void OnTouchDown();
 
-	// Transform Animation functions
-	EasingAnimation* AlphaTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* AlphaFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* AlphaFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ColorTo( const float fStartTimeOut, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ColorFrom( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ColorFromTo( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* AnglesTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* AnglesFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* AnglesFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ScaleTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ScaleFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* ScaleFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* PositionTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* PositionFrom( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
-	EasingAnimation* PositionFromTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	// Transform Animation functions. A 'To' without delay on a property already tweening retargets that tween in place,
+	// keeping its handle and current velocity
+	GUITweenHandle AlphaTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AlphaFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AlphaFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ColorTo( const float fStartTimeOut, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ColorFrom( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ColorFromTo( const float fStartTimeOut, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AnglesTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AnglesFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AnglesFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ScaleTo( const float fStartTimeOut, const float fDuration, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ScaleFrom( const float fStartTimeOut, const float fDuration, const float fStart, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle ScaleFromTo( const float fStartTimeOut, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle PositionTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle PositionFrom( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle PositionFromTo( const float fStartTimeOut, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	// Additive animation functions: the tween animates an offset summed on top of the property (e.g. a shake over a slide).
+	// Several can run on the same property at once, together with a regular tween. The final offset stays applied
+	GUITweenHandle AdditiveFromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const float fStart, const float fTarget, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	GUITweenHandle AdditiveFromTo( const float fStartTimeOut, const float fDuration, const eGUIAnimProperty eProperty, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod, const pfGUIEasingAnimationCallback pfOnComplete = 0, const bool bAffectedByTimeScale = true );
+	// Spring animation functions. Calling them every frame only moves the target, the spring keeps its velocity.
+	// A negative damping means critical damping, a negative rest epsilon the default of the property (GUISpring::GetDefaultRestEpsilon).
+	// Starting a tween on the property stops its spring and vice versa
+	void SpringTo( const eGUIAnimProperty eProperty, const float fTarget, const float fStiffness = GUI_SPRING_DEFAULT_STIFFNESS, const float fDamping = -1.f, const float fRestEpsilon = -1.f );
+	void SpringTo( const eGUIAnimProperty eProperty, const hkvVec2& v2Target, const float fStiffness = GUI_SPRING_DEFAULT_STIFFNESS, const float fDamping = -1.f, const float fRestEpsilon = -1.f );
+	// Kick, e.g. the release velocity of a fling (units per second)
+	void SetSpringVelocity( const eGUIAnimProperty eProperty, const hkvVec2& v2Velocity );
+	void StopSpring( const eGUIAnimProperty eProperty );
+	bool IsSpringActive( const eGUIAnimProperty eProperty ) const { return ( m_uiActiveSprings & (1u << eProperty) ) != 0; }
 
 private:
 	int m_iAnimFPS;
@@ -448,7 +596,13 @@ private:
 	VSmartPtr<VisScreenMask_cl> m_spTexture;
 	eGUIAnimID m_eID;
 	bool m_bRunning;
-	DynArray_cl<EasingAnimation*> m_aEasingAnims;
+	int m_aiEasingSlots[GAP_COUNT]; // Tween registry slot per property, -1 if none
+	DynArray_cl<int> m_aAdditiveSlots; // Registry slots of additive tweens
+	unsigned int m_uiNumAdditive;
+	hkvVec4 m_av4AdditiveOffset[GAP_COUNT]; // Sum of additive tweens currently included in each property (position: added by ComputePosition, anchor offsets untouched)
+	GUISpring* m_pSprings; // One per property, allocated on the first spring
+	unsigned int m_uiActiveSprings; // Bit per property with a moving spring
+	unsigned int m_uiSpringsToCommit; // Bit per property evaluated and waiting to be applied
 
 	float m_fLastTouchXPos, m_fLastTouchYPos;
 	bool m_bTouchable;
@@ -465,6 +619,36 @@ private:
 
 	float m_fScaleX, m_fScaleY;
 	float m_fInitWidth, m_fInitHeight;
+	bool m_bInContainer; // Item or host of a container at some point, size changes are reported to the manager
+	// What the texture cache counted the element as, so removals and changes undo exactly that
+	bool m_bCacheCounted;
+	const VTextureObject* m_pCacheTexture;
+	bool m_bCacheVisible;
+
+	bool m_bCulled; // Off-screen or fully transparent: not drawn nor touchable, tweens keep running
+	bool m_bCulledByParent;
+	unsigned int m_uiCullFrame; // Manager frame the culling state was computed for
+	unsigned int m_uiClipFrame; // Manager frame the clip rect was computed for
+	bool m_bClipChildren;
+	bool m_bHasClipRect;
+	FrameRect m_tClipRect;
+	IGUIQuadProvider* m_pQuadProvider;
+	GUINineSlice* m_pNineSlice; // Owned, installed as quad provider
+	GUIArena* m_pArena;
+	std::string m_sTierTexSource; // Atlas or texture folder without tier extension, reloadable at another tier if set
+	std::string m_sTierTexFilename; // Standalone texture without tier extension, empty for atlases
+	float m_fTexelScale;
+	GUIAtlasHandle m_uiAtlas; // Atlas of the frames, invalid for standalone textures and frames found in any atlas
+
+	DynArray_cl<GUIAnimation*> m_aChildren; // Elements anchored to this one, relaid out when its rect changes
+	bool m_bLayoutChanged; // Resolved touch area differs from the committed one
+	bool m_bRenderFrameDirty; // Frame animation advanced, texture range pending
+	unsigned int m_uiLayoutPass; // Manager frame the element joined the parallel layout pass
+	bool m_bAwake; // In the manager active list
+	bool m_bInTouchIndex; // In the manager touch candidates list
+	unsigned int m_uiUpdateFrame; // Manager frame of the last Update
+	unsigned int m_uiTimeGroup;
+	std::string m_sPoolKey; // Manager pool the element returns to when recycled, empty if not spawned from one
 };
 
 
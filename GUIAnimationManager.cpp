@@ -2,6 +2,10 @@
 #include "GUIAnimationManager.h"
 #include "../CutshumotoPlugin/CutshumotoUtilities.h"
 #include <algorithm>
+#include <ctime>
+
+
+#define PARALLEL_UPDATE_CHUNK 32
 
 
 namespace 
@@ -16,30 +20,83 @@ GUIAnimationManager::GUIAnimationManager()
 	m_aAnimations.Init(0);
 	m_pInputMap = new VInputMap( GAI_COUNT, 4 );
 	m_bIsValid = false;
+	m_uiNextAtlasHandle = GUI_INVALID_ATLAS + 1;
 	m_sHDExtension = "2x";
 	m_bIsHD = false;
+	m_eLayoutTier = GTT_SD;
+	m_eTextureTier = GTT_SD;
+	m_uiTextureMemoryBudget = 0;
+	m_bTextureUsageChanged = false;
+	m_eTextureCompression = GUITextureCompression::GetPlatformDefault();
 	m_pTouchHandler = 0;
 	m_bAnimsArrayIsDirty = true;
+	m_bBatchedRendering = false;
+	m_bCullingEnabled = true;
+	m_uiFrame = 0;
+	m_tCullingStats.Init();
+	m_aTimelines.Init(0);
+	m_uiNumTimelines = 0;
+	m_bUpdatingTimelines = false;
+	m_aContainers.Init(0);
+	m_uiNumContainers = 0;
+	m_aVirtualLists.Init(0);
+	m_uiNumVirtualLists = 0;
+	m_aTexts.Init(0);
+	m_uiNumTexts = 0;
+	m_aActiveAnimations.Init(0);
+	m_uiNumActive = 0;
+	m_bUpdatingActive = false;
+	m_aTouchables.Init(0);
+	m_uiNumTouchables = 0;
+	m_bParallelUpdate = false;
+	m_uiParallelMinElements = 0;
+	m_aParallelWork.Init(0);
+	m_uiNumParallelWork = 0;
+	m_aLayoutPass.Init( LayoutPassEntry() );
+	m_uiNumLayoutPass = 0;
+	m_uiLayoutLevelBegin = 0;
+	m_tParallelStats.Init();
+	m_bBuilding = false;
+	m_aBuildElements.Init(0);
+	m_uiNumBuildElements = 0;
+	m_tBuildStartClock = 0;
+	m_tBuildStats.Init();
+	m_uiPoolCapacity = 64;
+	m_tPoolStats.Init();
 
-	if ( AUTO_LOAD_HD_TEX )
-	{
-		float fScreenW, fScreenH;
-		fScreenW = static_cast<float>(Vision::Video.GetXRes());
-		fScreenH = static_cast<float>(Vision::Video.GetYRes());
-		if ( fScreenW >= MAX_W_OR_H_HD || fScreenH >= MAX_W_OR_H_HD ) 
-		{
-			m_bIsHD = true;
-			m_sHDExtension = "4x";
-		} 
-		else if ( fScreenW >= MAX_W_OR_H_SD || fScreenH >= MAX_W_OR_H_SD ) 
-		{
-			m_bIsHD = true;
-		}
-	}
+	if ( AUTO_LOAD_HD_TEX ) SelectTextureTiers();
 }
 
 GUIAnimationManager::~GUIAnimationManager()
 {
+	for ( unsigned int i = 0; i < m_uiNumTimelines; i++ )
+		delete m_aTimelines[i];
+	m_aTimelines.Reset();
+	m_uiNumTimelines = 0;
+	UnloadAnimClips();
+	ClearPools();
+	for ( unsigned int i = 0; i < m_uiNumContainers; i++ )
+		delete m_aContainers[i];
+	m_aContainers.Reset();
+	m_uiNumContainers = 0;
+	for ( unsigned int i = 0; i < m_uiNumVirtualLists; i++ )
+		delete m_aVirtualLists[i];
+	m_aVirtualLists.Reset();
+	m_uiNumVirtualLists = 0;
+	for ( unsigned int i = 0; i < m_uiNumTexts; i++ )
+		delete m_aTexts[i];
+	m_aTexts.Reset();
+	m_uiNumTexts = 0;
+	UnloadFonts();
+
+	// Drop schedulers first so destroyed elements dont have to leave them one by one
+	for ( unsigned int i = 0; i < m_uiNumActive; i++ ) if ( m_aActiveAnimations[i] ) m_aActiveAnimations[i]->m_bAwake = false;
+	for ( unsigned int i = 0; i < m_uiNumTouchables; i++ ) m_aTouchables[i]->m_bInTouchIndex = false;
+	m_aActiveAnimations.Reset();
+	m_uiNumActive = 0;
+	m_aTouchables.Reset();
+	m_uiNumTouchables = 0;
+
 	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ ) 
 	{
 		if ( m_aAnimations[i] ) 
@@ -49,7 +106,7 @@ GUIAnimationManager::~GUIAnimationManager()
 		}
 	}
 	m_aAnimations.Reset();
-	m_hDecodedTexturePackerJSON.clear();
+	m_hAtlases.clear();
 	// Free TriggerMaps
 	if ( m_pInputMap ) 
 	{
@@ -59,37 +116,267 @@ GUIAnimationManager::~GUIAnimationManager()
 	m_pTouchHandler = 0;
 }
 
-GUIAnimation* GUIAnimationManager::CreateAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType )
+GUIAnimation* GUIAnimationManager::CreateAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType, GUIArena* pArena )
 {
 	if ( iNumFrames > 0 && !m_bIsValid ) return 0;
 
+	const GUIAtlasHandle uiAtlas = ( iNumFrames > 0 ) ? FindAtlasByTexture( sSrcTexFilepathWithoutExtension ) : GUI_INVALID_ATLAS;
+	Atlas* pAtlas = GetAtlas( uiAtlas );
+	const eGUITextureTier eTier = pAtlas ? pAtlas->m_eTier : m_eTextureTier;
+
 	std::string sSrcTexFilepath = sSrcTexFilepathWithoutExtension;
 	std::string sFilename = _sFilename;
-	if ( m_bIsHD )
+	if ( pAtlas ) sSrcTexFilepath += GetTierExtension( eTier ); // Page of the atlas tier, Create adds the file format
+	else if ( m_bIsHD )
 	{ // Load hd textures
-		if ( iNumFrames == 0 )
-		{ // Standalone texture
-			int iExtensionDotPos = _sFilename.rfind( "." );
-			std::string sExtension = _sFilename.substr( iExtensionDotPos + 1 );
-			std::string sBaseFilename = _sFilename.substr( 0, iExtensionDotPos );
-			sFilename = sBaseFilename + m_sHDExtension;
-			sFilename += "." + sExtension; // Filename with hd extension and file format
+		if ( iNumFrames == 0 ) sFilename = GetTierFilename( _sFilename, m_eTextureTier ); // Standalone texture
+		else sSrcTexFilepath += m_sHDExtension; // Texture atlas, Create adds the file format
+	}
+
+	GUIAnimation* pNewAnim = GUIAnimation::Create( sSrcTexFilepath, sFilename, iFirstFrame, iLastFrame, iNumFrames, eID, eType, uiAtlas, pArena );
+	if ( pAtlas && !pAtlas->m_spTexture ) pAtlas->m_spTexture = pNewAnim->GetTexture()->GetTextureObject();
+	// Remembered to reload another tier in place
+	pNewAnim->m_sTierTexSource = sSrcTexFilepathWithoutExtension;
+	if ( iNumFrames == 0 ) pNewAnim->m_sTierTexFilename = _sFilename;
+	if ( eTier != m_eLayoutTier )
+	{ // Texels of the loaded tier, size in layout pixels
+		pNewAnim->m_fTexelScale = GetTexelScale( eTier );
+		pNewAnim->m_fInitWidth /= pNewAnim->m_fTexelScale;
+		pNewAnim->m_fInitHeight /= pNewAnim->m_fTexelScale;
+		pNewAnim->InitializeSize();
+	}
+	if ( m_bBatchedRendering ) pNewAnim->GetTexture()->SetVisibleBitmask( 0 ); // Drawn by the sprite batch
+	AddAnimation( pNewAnim );
+
+	return pNewAnim;
+}
+
+GUIAnimation* GUIAnimationManager::CreateNineSlice( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sFilename, const float fLeft, const float fTop, const float fRight, const float fBottom, const float fWidth, const float fHeight, const eGUIAnimID eID, GUIArena* pArena )
+{
+	GUIAnimation* pAnim = CreateAnimation( sSrcTexFilepathWithoutExtension, sFilename, 0, 0, 1, eID, GUIAnimation::GAT_NONE, pArena );
+	if ( !pAnim ) return 0;
+	pAnim->SetNineSlice( fLeft, fTop, fRight, fBottom );
+	// Panel size is the unscaled size, SetScale and scale tweens work from it
+	pAnim->m_fInitWidth = fWidth;
+	pAnim->m_fInitHeight = fHeight;
+	pAnim->SetSize( fWidth, fHeight );
+	return pAnim;
+}
+
+unsigned int GUIAnimationManager::CreateAnimations( const AnimationTemplate& tTemplate, const unsigned int uiCount, const hkvVec2* pOffsets, GUIAnimation** ppOutAnimations )
+{
+	if ( uiCount == 0 ) return 0;
+
+	// Nested in an ongoing build (e.g. a layout) the outer one lays the items out
+	const bool bOwnBuild = !m_bBuilding;
+	if ( bOwnBuild ) BeginBuild();
+
+	// Reserve once
+	const unsigned int uiNumAnimations = m_aAnimations.GetValidSize();
+	m_aAnimations.EnsureSize( uiNumAnimations + uiCount );
+	m_aActiveAnimations.EnsureSize( m_uiNumActive + uiCount );
+	if ( tTemplate.m_bTouchable ) m_aTouchables.EnsureSize( m_uiNumTouchables + uiCount );
+	m_aBuildElements.EnsureSize( m_uiNumBuildElements + uiCount );
+
+	// Texture and frames resolved by the first item only
+	GUIAnimation* pSource = 0;
+	unsigned int uiNumCreated = 0;
+	for ( unsigned int i = 0; i < uiCount; i++ )
+	{
+		GUIAnimation* pAnim = 0;
+		if ( !pSource ) 
+		{
+			pAnim = CreateAnimation( tTemplate.m_sSrcTexFilepathWithoutExtension, tTemplate.m_sFilename, tTemplate.m_iFirstFrame, tTemplate.m_iLastFrame, tTemplate.m_iNumFrames, tTemplate.m_eID, tTemplate.m_eType, tTemplate.m_pArena );
+			if ( !pAnim ) break;
+			pSource = pAnim;
 		}
 		else
-		{ // Texture atlas
-			sSrcTexFilepath += m_sHDExtension + TPTEXFILE_EXTENSION; // Filepath with hd extension and file format
+		{
+			pAnim = GUIAnimation::Clone( pSource, tTemplate.m_eID );
+			if ( m_bBatchedRendering ) pAnim->GetTexture()->SetVisibleBitmask( 0 ); // Drawn by the sprite batch
+			pAnim->m_bTouchable = tTemplate.m_bTouchable; // Before joining the touch index
+			AddAnimation( pAnim );
+		}
+
+		GUIAnimation::UIAnchorInfo& tAnchorInfo = pAnim->GetAnchorInfo();
+		tAnchorInfo = tTemplate.m_tAnchorInfo;
+		tAnchorInfo.m_pParent = 0;
+		pAnim->SetParent( tTemplate.m_tAnchorInfo.m_pParent );
+		if ( pOffsets )
+		{
+			tAnchorInfo.m_fOffsetX = pOffsets[i].x;
+			tAnchorInfo.m_fOffsetY = pOffsets[i].y;
 		}
+		pAnim->MarkLayoutDirty();
+		pAnim->SetOrder( tTemplate.m_iOrder );
+		if ( pAnim == pSource && !tTemplate.m_bTouchable ) pAnim->SetTouchable( false );
+
+		if ( ppOutAnimations ) ppOutAnimations[i] = pAnim;
+		uiNumCreated++;
 	}
 
-	GUIAnimation* pNewAnim = GUIAnimation::Create( sSrcTexFilepath, sFilename, iFirstFrame, iLastFrame, iNumFrames, eID, eType );
-	AddAnimation( pNewAnim );
+	if ( bOwnBuild ) EndBuild();
+	return uiNumCreated;
+}
 
-	return pNewAnim;
+std::string GUIAnimationManager::GetPoolKey( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames )
+{
+	std::ostringstream ss;
+	ss << sSrcTexFilepathWithoutExtension << "|" << sFilename << "|" << iFirstFrame << "|" << iLastFrame << "|" << iNumFrames;
+	return ss.str();
+}
+
+GUIAnimation* GUIAnimationManager::SpawnAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType )
+{
+	m_tPoolStats.m_uiSpawned++;
+	const std::string sKey = GetPoolKey( sSrcTexFilepathWithoutExtension, _sFilename, iFirstFrame, iLastFrame, iNumFrames );
+	std::map< std::string, AnimationPool* >::iterator it = m_hPools.find( sKey );
+	if ( it != m_hPools.end() && it->second->m_uiNumFree > 0 )
+	{ // Reuse
+		AnimationPool* pPool = it->second;
+		GUIAnimation* pAnim = pPool->m_aFree[ --pPool->m_uiNumFree ];
+		m_tPoolStats.m_uiReused++;
+		m_tPoolStats.m_uiPooled--;
+		pAnim->m_eID = eID;
+		pAnim->m_eType = eType;
+		pAnim->GetTexture()->SetVisible( true );
+		AddAnimation( pAnim );
+		return pAnim;
+	}
+
+	GUIAnimation* pAnim = CreateAnimation( sSrcTexFilepathWithoutExtension, _sFilename, iFirstFrame, iLastFrame, iNumFrames, eID, eType );
+	if ( pAnim ) pAnim->m_sPoolKey = sKey;
+	return pAnim;
+}
+
+/*
+	The element leaves the draw, update and touch lists until spawned again
+*/
+void GUIAnimationManager::RecycleAnimation( GUIAnimation* pAnim )
+{
+	if ( !pAnim ) return;
+
+	std::map< std::string, AnimationPool* >::iterator it = m_hPools.end();
+	if ( !pAnim->m_sPoolKey.empty() )
+	{
+		it = m_hPools.find( pAnim->m_sPoolKey );
+		if ( it == m_hPools.end() ) it = m_hPools.insert( std::make_pair( pAnim->m_sPoolKey, new AnimationPool() ) ).first;
+	}
+	// Arena elements are never pooled, the pools would keep the screen memory in use
+	if ( it == m_hPools.end() || it->second->m_uiNumFree >= m_uiPoolCapacity || pAnim->GetArena() )
+	{
+		if ( it != m_hPools.end() ) m_tPoolStats.m_uiDiscarded++;
+		RemoveAnimation( pAnim );
+		delete pAnim;
+		return;
+	}
+
+	pAnim->ResetForReuse( pAnim->GetAnimID(), pAnim->GetAnimType() );
+	pAnim->GetTexture()->SetVisible( false );
+	RemoveAnimation( pAnim );
+
+	AnimationPool* pPool = it->second;
+	pPool->m_aFree[ pPool->m_uiNumFree++ ] = pAnim;
+	m_tPoolStats.m_uiRecycled++;
+	m_tPoolStats.m_uiPooled++;
+}
+
+void GUIAnimationManager::PrewarmPool( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const unsigned int uiCount )
+{
+	const std::string sKey = GetPoolKey( sSrcTexFilepathWithoutExtension, _sFilename, iFirstFrame, iLastFrame, iNumFrames );
+	std::map< std::string, AnimationPool* >::iterator it = m_hPools.find( sKey );
+	const unsigned int uiNumFree = ( it != m_hPools.end() ) ? it->second->m_uiNumFree : 0;
+	for ( unsigned int i = uiNumFree; i < uiCount && i < m_uiPoolCapacity; i++ )
+	{
+		GUIAnimation* pAnim = CreateAnimation( sSrcTexFilepathWithoutExtension, _sFilename, iFirstFrame, iLastFrame, iNumFrames, static_cast<eGUIAnimID>(0) ); // ID given on spawn
+		if ( !pAnim ) return;
+		pAnim->m_sPoolKey = sKey;
+		RecycleAnimation( pAnim );
+		m_tPoolStats.m_uiRecycled--; // Not a recycle from the game
+	}
+}
+
+void GUIAnimationManager::ClearPools()
+{
+	for ( std::map< std::string, AnimationPool* >::iterator it = m_hPools.begin(); it != m_hPools.end(); ++it )
+	{
+		AnimationPool* pPool = it->second;
+		for ( unsigned int i = 0; i < pPool->m_uiNumFree; i++ )
+			delete pPool->m_aFree[i];
+		pPool->m_aFree.Reset();
+		delete pPool;
+	}
+	m_hPools.clear();
+	m_tPoolStats.m_uiPooled = 0;
 }
 
 void GUIAnimationManager::AddAnimation( GUIAnimation* guiAnimation )
 {
 	m_aAnimations[ m_aAnimations.GetFreePos() ] = guiAnimation;
+	m_bAnimsArrayIsDirty = true;
+	if ( guiAnimation->IsTouchable() ) RegisterTouchable( guiAnimation );
+	m_tTextureCache.AddElement( guiAnimation, m_sTextureOwnerTag );
+	m_bTextureUsageChanged = true;
+	guiAnimation->Wake();
+	if ( m_bBuilding ) m_aBuildElements[ m_uiNumBuildElements++ ] = guiAnimation;
+}
+
+void GUIAnimationManager::SortAnimations()
+{
+	m_bAnimsArrayIsDirty = false;
+	// Update order of elements in array
+	unsigned int uiAnimationsCount = m_aAnimations.GetValidSize();
+	GUIAnimation** ppEndIterator = m_aAnimations.GetDataPtr();
+	ppEndIterator += uiAnimationsCount;
+	// Order guianimations by Order attribute in ASC way
+	std::sort( m_aAnimations.GetDataPtr(), ppEndIterator, CompareAnimationOrder );
+	// Touch candidates share the same order (front first)
+	std::sort( m_aTouchables.GetDataPtr(), m_aTouchables.GetDataPtr() + m_uiNumTouchables, CompareAnimationOrder );
+}
+
+/*
+	Until EndBuild positioning and resizing only mark the layout dirty, so a whole screen is laid out once
+*/
+void GUIAnimationManager::BeginBuild()
+{
+	if ( m_bBuilding ) return;
+	m_bBuilding = true;
+	m_uiNumBuildElements = 0;
+	m_tBuildStats.Init();
+	m_tBuildStartClock = clock();
+}
+
+/*
+	Single sort of the draw and touch order, then every element created since BeginBuild is laid out parents first
+*/
+void GUIAnimationManager::EndBuild()
+{
+	if ( !m_bBuilding ) return;
+	m_bBuilding = false;
+
+	SortAnimations();
+
+	for ( unsigned int i = 0; i < m_uiNumBuildElements; i++ )
+	{
+		GUIAnimation* pAnim = m_aBuildElements[i];
+		LayoutPassEntry& tEntry = m_aLayoutPass[i];
+		tEntry.m_pAnim = pAnim;
+		tEntry.m_uiSeq = i;
+		tEntry.m_uiDepth = 0;
+		for ( const GUIAnimation* pAncestor = pAnim->GetAnchorInfo().m_pParent; pAncestor; pAncestor = pAncestor->GetAnchorInfo().m_pParent ) 
+			tEntry.m_uiDepth++;
+	}
+	std::sort( m_aLayoutPass.GetDataPtr(), m_aLayoutPass.GetDataPtr() + m_uiNumBuildElements, CompareLayoutPassEntries );
+	for ( unsigned int i = 0; i < m_uiNumBuildElements; i++ )
+	{
+		GUIAnimation* pAnim = m_aLayoutPass[i].m_pAnim;
+		pAnim->ResolveLayout();
+		pAnim->CommitLayout();
+	}
+
+	m_tBuildStats.m_uiElements = m_uiNumBuildElements;
+	m_tBuildStats.m_fBuildTime = static_cast<float>( clock() - m_tBuildStartClock ) * 1000.f / CLOCKS_PER_SEC;
+	m_uiNumBuildElements = 0;
 }
 
 void GUIAnimationManager::RemoveAnimation( GUIAnimation* guiAnimation )
@@ -97,6 +384,38 @@ void GUIAnimationManager::RemoveAnimation( GUIAnimation* guiAnimation )
 	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
 		if ( m_aAnimations[i] == guiAnimation ) m_aAnimations.Remove(i);
 	m_aAnimations.Pack();
+	OnAnimationDestroyed( guiAnimation );
+}
+
+bool GUIAnimationManager::ReleaseArena( GUIArena* pArena )
+{
+	if ( !pArena ) return false;
+	VASSERT( !m_bBuilding );
+
+	// Texts first, they delete their element. A text on the heap is dropped with an element of the arena too
+	for ( unsigned int i = m_uiNumTexts; i > 0; i-- )
+	{
+		GUIText* pText = m_aTexts[i - 1];
+		if ( GUIArena::GetOwner( pText ) == pArena || ( pText->GetAnimation() && GUIArena::GetOwner( pText->GetAnimation() ) == pArena ) )
+			DestroyText( pText );
+	}
+
+	// Out of the list in one pass, deleted after: the destructors detach parents and children in any order
+	DynArray_cl<GUIAnimation*> aReleased( 0 );
+	unsigned int uiNumReleased = 0;
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		if ( !m_aAnimations[i] || GUIArena::GetOwner( m_aAnimations[i] ) != pArena ) continue;
+		aReleased[ uiNumReleased++ ] = m_aAnimations[i];
+		m_aAnimations.Remove(i);
+	}
+	m_aAnimations.Pack();
+	for ( unsigned int i = 0; i < uiNumReleased; i++ )
+	{
+		OnAnimationDestroyed( aReleased[i] );
+		delete aReleased[i];
+	}
+	return pArena->Reset();
 }
 
 GUIAnimation* GUIAnimationManager::GetAnimation( unsigned int eAnimID )
@@ -108,60 +427,1004 @@ GUIAnimation* GUIAnimationManager::GetAnimation( unsigned int eAnimID )
 
 void GUIAnimationManager::Update( float fDeltaTime )
 {
-	if ( m_bAnimsArrayIsDirty ) 
+	if ( m_bAnimsArrayIsDirty ) SortAnimations();
+
+	m_uiFrame++;
+	m_tTextureCache.SetFrame( m_uiFrame );
+	m_tClock.Advance( fDeltaTime );
+	m_tCullingStats.Init();
+	m_tHotReload.Update( m_tClock.GetRealDeltaTime() );
+
+	// Update input event
+	UpdateInput();
+
+	// Timelines write their targets before the elements update, so layout and culling see this frame values
+	UpdateTimelines();
+	// Containers place their items after timelines and text changes moved or resized them
+	UpdateTexts();
+	UpdateContainers();
+	UpdateVirtualLists();
+
+	m_tParallelStats.Init();
+	if ( m_bParallelUpdate && m_uiNumActive >= m_uiParallelMinElements ) UpdateParallel();
+
+	// Only awake elements are visited, idle ones leave the list. Elements woken meanwhile are appended and visited this frame too
+	// Callbacks may destroy elements of the list meanwhile, their slots are nulled and dropped after the loop
+	unsigned int uiNumKept = 0;
+	m_bUpdatingActive = true;
+	for ( unsigned int i = 0; i < m_uiNumActive; i++ )
 	{
-		m_bAnimsArrayIsDirty = false;
-		// Update order of elements in array
-		unsigned int uiAnimationsCount = m_aAnimations.GetValidSize();
-		GUIAnimation** ppEndIterator = m_aAnimations.GetDataPtr();
-		ppEndIterator += uiAnimationsCount;
-		// Order guianimations by Order attribute in ASC way
-		std::sort( m_aAnimations.GetDataPtr(), ppEndIterator, CompareAnimationOrder );
+		GUIAnimation* pAnim = m_aActiveAnimations[i];
+		if ( !pAnim ) continue;
+		if ( !pAnim->IsVisible() ) 
+		{ // Hidden elements sleep until SetVisible( true )
+			pAnim->m_bAwake = false;
+			continue;
+		}
+
+		if ( pAnim->m_uiUpdateFrame != m_uiFrame )
+		{
+			UpdateCulling( pAnim );
+			// Update position and animation (tweens keep advancing while culled)
+			pAnim->Update( m_tClock.GetDeltaTime( pAnim->GetTimeGroup() ) );
+			if ( m_aActiveAnimations[i] != pAnim ) continue; // Destroyed by its own callback
+		}
+
+		if ( pAnim->CanSleep() ) 
+		{
+			pAnim->m_bAwake = false;
+			continue;
+		}
+		m_aActiveAnimations[ uiNumKept++ ] = pAnim;
 	}
+	m_bUpdatingActive = false;
+	// Kept elements destroyed by a later callback
+	unsigned int uiNumAlive = 0;
+	for ( unsigned int i = 0; i < uiNumKept; i++ )
+		if ( m_aActiveAnimations[i] ) m_aActiveAnimations[ uiNumAlive++ ] = m_aActiveAnimations[i];
+	m_uiNumActive = uiNumAlive;
 
-	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	// Textures loaded by the elements created since the last check
+	if ( m_bTextureUsageChanged && m_uiTextureMemoryBudget > 0 ) EnforceTextureBudget();
+	// Textures needed again were reloaded by the hooks, evict down to the cap if the counts changed
+	m_tTextureCache.Refresh();
+}
+
+const GUITextureCache& GUIAnimationManager::GetTextureCache()
+{
+	m_tTextureCache.Refresh();
+	return m_tTextureCache;
+}
+
+GUITimeline* GUIAnimationManager::CreateTimeline()
+{
+	GUITimeline* pTimeline = new GUITimeline();
+	m_aTimelines[ m_uiNumTimelines++ ] = pTimeline;
+	return pTimeline;
+}
+
+void GUIAnimationManager::DestroyTimeline( GUITimeline* pTimeline )
+{
+	if ( !pTimeline ) return;
+	if ( m_bUpdatingTimelines )
+	{ // Destroyed from its own callback, freed when the update loop ends
+		pTimeline->m_bPendingDestroy = true;
+		pTimeline->Pause();
+		return;
+	}
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumTimelines; i++ )
+		if ( m_aTimelines[i] != pTimeline ) m_aTimelines[ uiNumKept++ ] = m_aTimelines[i];
+	m_uiNumTimelines = uiNumKept;
+	delete pTimeline;
+}
+
+GUIContainer* GUIAnimationManager::CreateContainer( const eGUIContainerType eType, GUIAnimation* pHost )
+{
+	GUIContainer* pContainer = new GUIContainer( eType, pHost );
+	m_aContainers[ m_uiNumContainers++ ] = pContainer;
+	return pContainer;
+}
+
+/*
+	Items are left where they were placed
+*/
+void GUIAnimationManager::DestroyContainer( GUIContainer* pContainer )
+{
+	if ( !pContainer ) return;
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumContainers; i++ )
+		if ( m_aContainers[i] != pContainer ) m_aContainers[ uiNumKept++ ] = m_aContainers[i];
+	m_uiNumContainers = uiNumKept;
+	delete pContainer;
+}
+
+void GUIAnimationManager::UpdateContainers()
+{
+	for ( unsigned int i = 0; i < m_uiNumContainers; i++ )
+		if ( m_aContainers[i]->IsDirty() ) m_aContainers[i]->Relayout();
+}
+
+GUIVirtualList* GUIAnimationManager::CreateVirtualList( const AnimationTemplate& tRowTemplate, GUIAnimation* pHost, const float fRowHeight, const float fViewportHeight, const unsigned int uiNumItems )
+{
+	GUIVirtualList* pList = new GUIVirtualList( pHost, fRowHeight, fViewportHeight );
+	if ( pHost ) pHost->SetClipChildren( true ); // Rows crossing the viewport edges are trimmed
+	// Enough rows to cover the viewport at any offset
+	const unsigned int uiNumRows = static_cast<unsigned int>( hkvMath::ceil( pList->GetViewportHeight() / pList->GetRowHeight() ) ) + 1;
+
+	AnimationTemplate tTemplate = tRowTemplate;
+	tTemplate.m_tAnchorInfo.m_pParent = pHost;
+	GUIAnimation** ppRows = new GUIAnimation*[uiNumRows];
+	const unsigned int uiNumCreated = CreateAnimations( tTemplate, uiNumRows, 0, ppRows );
+	pList->SetRows( ppRows, uiNumCreated );
+	delete[] ppRows;
+	if ( uiNumCreated == 0 )
 	{
-		if ( !m_aAnimations[i]->IsVisible() ) continue;
-		// Update input event
-		if ( m_pTouchHandler ) 
-			if ( m_pTouchHandler->IsTouchable() ) m_pTouchHandler->UpdateInput(); // The control already being touched
-			else m_pTouchHandler = 0; // The control cant handle input events nevermore since is untouchable
-		else 
-			if ( m_aAnimations[i]->IsTouchable() ) m_aAnimations[i]->UpdateInput(); // Looking for touch handler
-		// Update position and animation
-		m_aAnimations[i]->Update( fDeltaTime );
+		delete pList;
+		return 0;
+	}
+
+	pList->SetNumItems( uiNumItems );
+	m_aVirtualLists[ m_uiNumVirtualLists++ ] = pList;
+	return pList;
+}
+
+void GUIAnimationManager::DestroyVirtualList( GUIVirtualList* pList )
+{
+	if ( !pList ) return;
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumVirtualLists; i++ )
+		if ( m_aVirtualLists[i] != pList ) m_aVirtualLists[ uiNumKept++ ] = m_aVirtualLists[i];
+	m_uiNumVirtualLists = uiNumKept;
+
+	for ( unsigned int i = 0; i < pList->GetNumRows(); i++ )
+	{
+		GUIAnimation* pRow = pList->GetRow(i);
+		if ( !pRow ) continue;
+		RemoveAnimation( pRow );
+		delete pRow;
 	}
+	delete pList;
 }
 
-bool GUIAnimationManager::LoadTexturePackerJSON( const std::string& sFilenameWithoutExtension, const std::string& sPath )
+void GUIAnimationManager::UpdateVirtualLists()
 {
-	std::string sFilename = sFilenameWithoutExtension;
-	if ( m_bIsHD )
-		sFilename += m_sHDExtension;
-	sFilename += ".json";
+	for ( unsigned int i = 0; i < m_uiNumVirtualLists; i++ )
+	{
+		GUIVirtualList* pList = m_aVirtualLists[i];
+		pList->Update( m_tClock.GetDeltaTime( pList->m_pHost ? pList->m_pHost->GetTimeGroup() : 0 ) );
+	}
+}
+
+const GUIFont* GUIAnimationManager::LoadBMFont( const std::string& sFilenameWithoutExtension, const std::string& sPath )
+{
+	// Layout tier, glyph metrics are layout pixels. Not swapped by SetTextureTier
+	std::string sFilename = sFilenameWithoutExtension + GetTierExtension( m_eLayoutTier ) + ".fnt";
+	const std::string sKey = sPath + sFilename;
+	std::map< std::string, GUIFont* >::const_iterator it = m_hFonts.find( sKey );
+	if ( it != m_hFonts.end() ) return it->second;
 
 	char pcFileContent[MAX_TPJSONFILE_SIZE];
-	bool bFileLoaded = CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() );
+	if ( !CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() ) ) return 0;
+	GUIFont* pFont = new GUIFont();
+	if ( !pFont->LoadBMFont( pcFileContent ) )
+	{
+		delete pFont;
+		return 0;
+	}
+	pFont->SetTexturePath( sPath );
+	m_hFonts[sKey] = pFont;
+	return pFont;
+}
+
+const GUIFont* GUIAnimationManager::LoadAtlasFont( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sGlyphPrefix, const char* pcCharset )
+{
+	const std::string sKey = sSrcTexFilepathWithoutExtension + ":" + sGlyphPrefix + ":" + pcCharset;
+	std::map< std::string, GUIFont* >::const_iterator it = m_hFonts.find( sKey );
+	if ( it != m_hFonts.end() ) return it->second;
+
+	GUIFont* pFont = new GUIFont();
+	if ( !pFont->LoadFromAtlas( FindAtlasByTexture( sSrcTexFilepathWithoutExtension ), sGlyphPrefix, pcCharset ) )
+	{
+		delete pFont;
+		return 0;
+	}
+	pFont->SetTexturePath( sSrcTexFilepathWithoutExtension );
+	m_hFonts[sKey] = pFont;
+	return pFont;
+}
+
+/*
+	Texts must be destroyed first
+*/
+void GUIAnimationManager::UnloadFonts()
+{
+	for ( std::map< std::string, GUIFont* >::iterator it = m_hFonts.begin(); it != m_hFonts.end(); ++it )
+		delete it->second;
+	m_hFonts.clear();
+}
+
+GUIText* GUIAnimationManager::CreateText( const GUIFont* pFont, const eGUIAnimID eID, const char* pcText, GUIArena* pArena )
+{
+	if ( !pFont ) return 0;
+
+	GUIAnimation* pAnim = 0;
+	if ( pFont->IsAtlasFont() )
+	{ // Atlas holding the glyphs, HD path resolved as for any atlas element
+		pAnim = CreateAnimation( pFont->GetTexturePath(), pFont->GetTextureFile(), 0, 0, 1, eID, GUIAnimation::GAT_NONE, pArena );
+	}
+	else
+	{ // BMFont page, already the HD one when the font is
+		pAnim = GUIAnimation::Create( pFont->GetTexturePath(), pFont->GetTextureFile(), 0, 0, 0, eID, GUIAnimation::GAT_NONE, GUI_INVALID_ATLAS, pArena );
+		AddAnimation( pAnim );
+	}
+	if ( !pAnim || !pAnim->GetTexture() || !pAnim->GetTexture()->GetTextureObject() )
+	{
+		if ( pAnim )
+		{
+			RemoveAnimation( pAnim );
+			delete pAnim;
+		}
+		return 0;
+	}
+
+	GUIText* pText = new ( pAnim->GetArena() ) GUIText( pFont, pAnim );
+	pText->SetText( pcText );
+	pText->Layout();
+	m_aTexts[ m_uiNumTexts++ ] = pText;
+	return pText;
+}
+
+void GUIAnimationManager::DestroyText( GUIText* pText )
+{
+	if ( !pText ) return;
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumTexts; i++ )
+		if ( m_aTexts[i] != pText ) m_aTexts[ uiNumKept++ ] = m_aTexts[i];
+	m_uiNumTexts = uiNumKept;
+
+	GUIAnimation* pAnim = pText->GetAnimation();
+	delete pText;
+	if ( pAnim )
+	{
+		RemoveAnimation( pAnim );
+		delete pAnim;
+	}
+}
+
+void GUIAnimationManager::UpdateTexts()
+{
+	for ( unsigned int i = 0; i < m_uiNumTexts; i++ )
+	{
+		GUIText* pText = m_aTexts[i];
+		if ( pText->IsDirty() ) pText->Layout(); // New extents reach the containers through SetSize
+	}
+}
+
+/*
+	Items that changed size move the next items of their containers, hosts may change the grid columns
+*/
+void GUIAnimationManager::OnAnimationResized( GUIAnimation* pAnim )
+{
+	for ( unsigned int i = 0; i < m_uiNumContainers; i++ )
+	{
+		GUIContainer* pContainer = m_aContainers[i];
+		if ( pContainer->GetHost() == pAnim ) pContainer->OnHostResized();
+		else pContainer->MarkItemDirty( pAnim );
+	}
+}
+
+const GUIAnimClip* GUIAnimationManager::LoadAnimClip( const std::string& sFilename, const std::string& sPath )
+{
+	const std::string sKey = sPath + sFilename;
+	std::map< std::string, GUIAnimClip* >::const_iterator it = m_hAnimClips.find( sKey );
+	if ( it != m_hAnimClips.end() ) return it->second;
+
+	GUIAnimClip* pClip = new GUIAnimClip();
+	bool bLoaded = false;
+	const std::string sBinaryExtension = GUIANIMCLIP_BINARY_EXTENSION;
+	if ( sFilename.size() > sBinaryExtension.size() && sFilename.compare( sFilename.size() - sBinaryExtension.size(), sBinaryExtension.size(), sBinaryExtension ) == 0 )
+	{ // Compiled clip
+		IVFileInStream* pIn = Vision::File.Open( sKey.c_str() );
+		if ( pIn )
+		{
+			const unsigned int uiSize = static_cast<unsigned int>(pIn->GetSize());
+			char* pcData = new char[uiSize];
+			bLoaded = ( pIn->Read( pcData, uiSize ) == uiSize ) && pClip->LoadBinary( pcData, uiSize );
+			pIn->Close();
+			delete[] pcData;
+		}
+	}
+	else
+	{
+		char pcFileContent[MAX_TPJSONFILE_SIZE];
+		bLoaded = CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() ) && pClip->LoadJSON( pcFileContent );
+	}
+
+	if ( !bLoaded )
+	{
+		delete pClip;
+		return 0;
+	}
+	m_hAnimClips[sKey] = pClip;
+	return pClip;
+}
+
+GUITimeline* GUIAnimationManager::PlayAnimClip( const GUIAnimClip* pClip, GUIAnimation* pTarget )
+{
+	if ( !pClip || !pTarget ) return 0;
+
+	GUITimeline* pTimeline = CreateTimeline();
+	pTimeline->AddClip( pClip, pTarget );
+	pTimeline->SetTimeGroup( pTarget->GetTimeGroup() );
+	pTimeline->SetAutoDestroy( true );
+	pTimeline->Play();
+	return pTimeline;
+}
+
+void GUIAnimationManager::UnloadAnimClips()
+{
+	for ( std::map< std::string, GUIAnimClip* >::iterator it = m_hAnimClips.begin(); it != m_hAnimClips.end(); ++it )
+		delete it->second;
+	m_hAnimClips.clear();
+}
+
+void GUIAnimationManager::UpdateTimelines()
+{
+	if ( m_uiNumTimelines == 0 ) return;
+
+	m_bUpdatingTimelines = true;
+	bool bPendingDestroy = false;
+	for ( unsigned int i = 0; i < m_uiNumTimelines; i++ )
+	{
+		GUITimeline* pTimeline = m_aTimelines[i];
+		if ( pTimeline->IsPlaying() && !pTimeline->m_bPendingDestroy )
+		{
+			const float fDeltaTime = pTimeline->m_bAffectedByTimeScale ? m_tClock.GetDeltaTime( pTimeline->GetTimeGroup() ) : m_tClock.GetRealDeltaTime();
+			pTimeline->Advance( fDeltaTime );
+			if ( pTimeline->IsFinished() && pTimeline->m_bAutoDestroy ) pTimeline->m_bPendingDestroy = true;
+		}
+		bPendingDestroy |= pTimeline->m_bPendingDestroy;
+	}
+	m_bUpdatingTimelines = false;
+	if ( !bPendingDestroy ) return;
+
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumTimelines; i++ )
+	{
+		if ( m_aTimelines[i]->m_bPendingDestroy ) delete m_aTimelines[i];
+		else m_aTimelines[ uiNumKept++ ] = m_aTimelines[i];
+	}
+	m_uiNumTimelines = uiNumKept;
+}
+
+void GUIAnimationManager::UpdateCulling( GUIAnimation* pAnim )
+{
+	m_tCullingStats.m_uiVisited++;
+
+	// Transitions refresh the mask and wake the children inside, parents resolved through a child included
+	const bool bCulled = m_bCullingEnabled && pAnim->UpdateCulling( m_uiFrame );
+	if ( !m_bCullingEnabled ) pAnim->UpdateClipRect( m_uiFrame ); // Computed by the culling otherwise
+	if ( bCulled )
+	{
+		m_tCullingStats.m_uiCulled++;
+		if ( pAnim->m_bCulledByParent ) m_tCullingStats.m_uiCulledByParent++;
+	}
+}
+
+void GUIAnimationManager::SetParallelUpdate( const bool bEnabled, const unsigned int uiNumWorkers, const unsigned int uiMinElements )
+{
+	m_bParallelUpdate = bEnabled;
+	m_uiParallelMinElements = uiMinElements;
+	if ( !bEnabled ) 
+	{
+		m_tJobPool.SetNumWorkers( 0 );
+		return;
+	}
+	// By default one worker per engine thread, the calling thread also takes work
+	m_tJobPool.SetNumWorkers( uiNumWorkers > 0 ? uiNumWorkers : static_cast<unsigned int>(Vision::GetThreadManager()->GetThreadCount()) );
+}
+
+/*
+	Parallel version of the active elements update. Tween and frame animations are evaluated across workers, then
+	applied in a single-threaded commit (screen mask writes, callbacks, sounds) in active list order. Dirty layouts
+	are then resolved level by level (parents before children) across workers and committed single-threaded too,
+	so the result does not depend on thread timing.
+*/
+void GUIAnimationManager::UpdateParallel()
+{
+	// Culling needs parents resolved first, keep it serial
+	m_uiNumParallelWork = 0;
+	const unsigned int uiNumActive = m_uiNumActive;
+	for ( unsigned int i = 0; i < uiNumActive; i++ )
+	{
+		GUIAnimation* pAnim = m_aActiveAnimations[i];
+		if ( !pAnim->IsVisible() || pAnim->m_uiUpdateFrame == m_uiFrame ) continue;
+		UpdateCulling( pAnim );
+		pAnim->m_bRunning = true;
+		pAnim->m_uiUpdateFrame = m_uiFrame;
+		m_aParallelWork[ m_uiNumParallelWork++ ] = pAnim;
+	}
+	m_tParallelStats.m_uiEvaluated = m_uiNumParallelWork;
+
+	// Evaluate animations in parallel
+	m_tJobPool.ParallelFor( m_uiNumParallelWork, PARALLEL_UPDATE_CHUNK, EvaluateAnimationsJob, this );
+
+	// Commit animations. Elements destroyed by a callback are nulled in the batch (OnAnimationDestroyed)
+	for ( unsigned int i = 0; i < m_uiNumParallelWork; i++ )
+		if ( m_aParallelWork[i] ) m_aParallelWork[i]->CommitAnimation();
+
+	// Collect dirty layouts with their dirty ancestors and their subtrees
+	m_uiNumLayoutPass = 0;
+	for ( unsigned int i = 0; i < m_uiNumParallelWork; i++ )
+	{
+		GUIAnimation* pAnim = m_aParallelWork[i];
+		if ( pAnim && pAnim->IsTouchAreaDirty() && !pAnim->IsCulled() ) AddToLayoutPass( pAnim );
+	}
+	m_uiNumParallelWork = 0;
+	m_tParallelStats.m_uiLayoutResolved = m_uiNumLayoutPass;
+	if ( m_uiNumLayoutPass == 0 ) return;
+	std::sort( m_aLayoutPass.GetDataPtr(), m_aLayoutPass.GetDataPtr() + m_uiNumLayoutPass, CompareLayoutPassEntries );
+
+	// Resolve one depth level at a time
+	unsigned int uiLevelBegin = 0;
+	for ( unsigned int i = 1; i <= m_uiNumLayoutPass; i++ )
+	{
+		if ( i < m_uiNumLayoutPass && m_aLayoutPass[i].m_uiDepth == m_aLayoutPass[uiLevelBegin].m_uiDepth ) continue;
+		m_uiLayoutLevelBegin = uiLevelBegin;
+		m_tJobPool.ParallelFor( i - uiLevelBegin, PARALLEL_UPDATE_CHUNK, ResolveLayoutsJob, this );
+		m_tParallelStats.m_uiLayoutLevels++;
+		uiLevelBegin = i;
+	}
+
+	// Commit layouts, parents first
+	for ( unsigned int i = 0; i < m_uiNumLayoutPass; i++ )
+		if ( m_aLayoutPass[i].m_pAnim ) m_aLayoutPass[i].m_pAnim->CommitLayout();
+	m_uiNumLayoutPass = 0;
+}
+
+void GUIAnimationManager::AddToLayoutPass( GUIAnimation* pAnim )
+{
+	if ( pAnim->m_uiLayoutPass == m_uiFrame ) return;
+
+	// Dirty ancestors are resolved before
+	GUIAnimation* pParent = pAnim->GetAnchorInfo().m_pParent;
+	if ( pParent && pParent->IsTouchAreaDirty() ) AddToLayoutPass( pParent );
+
+	pAnim->m_uiLayoutPass = m_uiFrame;
+	LayoutPassEntry& tEntry = m_aLayoutPass[ m_uiNumLayoutPass ];
+	tEntry.m_pAnim = pAnim;
+	tEntry.m_uiSeq = m_uiNumLayoutPass;
+	tEntry.m_uiDepth = 0;
+	for ( const GUIAnimation* pAncestor = pParent; pAncestor; pAncestor = pAncestor->GetAnchorInfo().m_pParent ) 
+		tEntry.m_uiDepth++;
+	m_uiNumLayoutPass++;
+
+	// Children are positioned from this rect
+	for ( unsigned int i = 0; i < pAnim->m_aChildren.GetValidSize(); i++ )
+	{
+		GUIAnimation* pChild = pAnim->m_aChildren[i];
+		if ( pChild && pChild->IsVisible() && !pChild->IsCulled() ) AddToLayoutPass( pChild );
+	}
+}
+
+bool GUIAnimationManager::CompareLayoutPassEntries( const LayoutPassEntry& tEntry0, const LayoutPassEntry& tEntry1 )
+{
+	if ( tEntry0.m_uiDepth != tEntry1.m_uiDepth ) return tEntry0.m_uiDepth < tEntry1.m_uiDepth;
+	return tEntry0.m_uiSeq < tEntry1.m_uiSeq;
+}
+
+void GUIAnimationManager::EvaluateAnimationsJob( void* pUserData, const unsigned int uiBegin, const unsigned int uiEnd )
+{
+	GUIAnimationManager* pManager = static_cast<GUIAnimationManager*>(pUserData);
+	for ( unsigned int i = uiBegin; i < uiEnd; i++ )
+	{
+		GUIAnimation* pAnim = pManager->m_aParallelWork[i];
+		if ( pAnim->IsActiveAnim() ) pAnim->EvaluateAnimation( pManager->m_tClock.GetDeltaTime( pAnim->GetTimeGroup() ) );
+	}
+}
 
-	if ( !bFileLoaded ) return false;
+void GUIAnimationManager::ResolveLayoutsJob( void* pUserData, const unsigned int uiBegin, const unsigned int uiEnd )
+{
+	GUIAnimationManager* pManager = static_cast<GUIAnimationManager*>(pUserData);
+	for ( unsigned int i = uiBegin; i < uiEnd; i++ )
+	{
+		GUIAnimation* pAnim = pManager->m_aLayoutPass[ pManager->m_uiLayoutLevelBegin + i ].m_pAnim;
+		if ( pAnim ) pAnim->ResolveLayout();
+	}
+}
+
+void GUIAnimationManager::UpdateInput()
+{
+	if ( m_pTouchHandler ) 
+	{
+		if ( m_pTouchHandler->IsTouchable() && !m_pTouchHandler->IsCulled() ) 
+		{ // The control already being touched
+			m_pTouchHandler->UpdateInput();
+		}
+		else 
+		{ // The control cant handle input events nevermore since is untouchable or culled, drop the touch silently
+			m_pTouchHandler->m_bTouched = false;
+			m_pTouchHandler = 0;
+		}
+		return;
+	}
+
+	if ( !GUIAnimation::IsPointerDown() ) return;
+
+	// Looking for touch handler, front-most first
+	for ( unsigned int i = 0; i < m_uiNumTouchables; i++ )
+	{
+		GUIAnimation* pAnim = m_aTouchables[i];
+		if ( !pAnim->IsVisible() || pAnim->IsCulled() ) continue;
+		pAnim->UpdateInput();
+		if ( m_pTouchHandler ) break;
+	}
+}
+
+void GUIAnimationManager::WakeAnimation( GUIAnimation* pAnim )
+{
+	if ( pAnim->m_bAwake ) return;
+	pAnim->m_bAwake = true;
+	m_aActiveAnimations[ m_uiNumActive++ ] = pAnim;
+}
+
+void GUIAnimationManager::RegisterTouchable( GUIAnimation* pAnim )
+{
+	if ( pAnim->m_bInTouchIndex ) return;
+	pAnim->m_bInTouchIndex = true;
+	m_aTouchables[ m_uiNumTouchables++ ] = pAnim;
+	m_bAnimsArrayIsDirty = true;
+}
+
+void GUIAnimationManager::UnregisterTouchable( GUIAnimation* pAnim )
+{
+	if ( !pAnim->m_bInTouchIndex ) return;
+	pAnim->m_bInTouchIndex = false;
+	// Keep the front to back order
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumTouchables; i++ )
+		if ( m_aTouchables[i] != pAnim ) m_aTouchables[ uiNumKept++ ] = m_aTouchables[i];
+	m_uiNumTouchables = uiNumKept;
+}
+
+void GUIAnimationManager::OnAnimationDestroyed( GUIAnimation* pAnim )
+{
+	m_tTextureCache.RemoveElement( pAnim ); // Its texture is released if it was the last user
+	if ( m_pTouchHandler == pAnim ) m_pTouchHandler = 0;
+	UnregisterTouchable( pAnim );
+	if ( m_bBuilding )
+	{
+		unsigned int uiNumKept = 0;
+		for ( unsigned int i = 0; i < m_uiNumBuildElements; i++ )
+			if ( m_aBuildElements[i] != pAnim ) m_aBuildElements[ uiNumKept++ ] = m_aBuildElements[i];
+		m_uiNumBuildElements = uiNumKept;
+	}
+	for ( unsigned int i = 0; i < m_uiNumTimelines; i++ )
+		m_aTimelines[i]->RemoveTarget( pAnim );
+	for ( unsigned int i = 0; i < m_uiNumContainers; i++ )
+	{
+		GUIContainer* pContainer = m_aContainers[i];
+		if ( pContainer->GetHost() == pAnim ) pContainer->OnHostDestroyed();
+		else pContainer->Remove( pAnim );
+	}
+	for ( unsigned int i = 0; i < m_uiNumVirtualLists; i++ )
+	{
+		GUIVirtualList* pList = m_aVirtualLists[i];
+		if ( pList->m_pHost == pAnim ) pList->OnHostDestroyed();
+		else pList->OnRowDestroyed( pAnim );
+	}
+	if ( pAnim->GetQuadProvider() )
+	{
+		for ( unsigned int i = 0; i < m_uiNumTexts; i++ )
+			if ( m_aTexts[i]->GetAnimation() == pAnim ) m_aTexts[i]->OnAnimationDestroyed();
+	}
+	// Parallel update batch being committed
+	for ( unsigned int i = 0; i < m_uiNumParallelWork; i++ )
+		if ( m_aParallelWork[i] == pAnim ) m_aParallelWork[i] = 0;
+	for ( unsigned int i = 0; i < m_uiNumLayoutPass; i++ )
+		if ( m_aLayoutPass[i].m_pAnim == pAnim ) m_aLayoutPass[i].m_pAnim = 0;
+	if ( pAnim->m_bAwake )
+	{
+		pAnim->m_bAwake = false;
+		if ( m_bUpdatingActive )
+		{ // Update is walking the list, compacted when it ends
+			for ( unsigned int i = 0; i < m_uiNumActive; i++ )
+				if ( m_aActiveAnimations[i] == pAnim ) m_aActiveAnimations[i] = 0;
+			return;
+		}
+		unsigned int uiNumKept = 0;
+		for ( unsigned int i = 0; i < m_uiNumActive; i++ )
+			if ( m_aActiveAnimations[i] != pAnim ) m_aActiveAnimations[ uiNumKept++ ] = m_aActiveAnimations[i];
+		m_uiNumActive = uiNumKept;
+	}
+}
+
+void GUIAnimationManager::SetCullingEnabled( const bool bEnabled )
+{
+	m_bCullingEnabled = bEnabled;
+	if ( bEnabled ) return;
+	// Restore every culled element
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		if ( !m_aAnimations[i]->IsCulled() ) continue;
+		m_aAnimations[i]->m_bCulled = false;
+		m_aAnimations[i]->m_bCulledByParent = false;
+		RefreshMaskVisibility( m_aAnimations[i] );
+		OnTextureUseChanged( m_aAnimations[i] );
+	}
+}
+
+void GUIAnimationManager::RefreshMaskVisibility( GUIAnimation* pAnim ) const
+{
+	if ( !pAnim->GetTexture() ) return;
+	// Batched elements are never drawn by the engine mask pass, culled ones are not drawn at all
+	const bool bDrawnByEngine = !m_bBatchedRendering && !pAnim->IsCulled() && !pAnim->GetQuadProvider();
+	pAnim->GetTexture()->SetVisibleBitmask( bDrawnByEngine ? 0xFFFFFFFF : 0 );
+}
+
+/*
+	Draws every visible element through the sprite batch. Call it once per frame from a render hook
+	(e.g. OnRenderHook with VRH_GUI). Without batched rendering only elements with a quad provider (text) are drawn.
+*/
+void GUIAnimationManager::Render()
+{
+	m_tSpriteBatch.Begin();
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		if ( !m_aAnimations[i]->IsVisible() || m_aAnimations[i]->IsCulled() ) continue;
+		if ( !m_bBatchedRendering && !m_aAnimations[i]->GetQuadProvider() ) continue;
+		m_tSpriteBatch.AddElement( m_aAnimations[i] );
+	}
+	m_tSpriteBatch.End();
+}
+
+void GUIAnimationManager::SetBatchedRendering( const bool bBatched, const bool bHeadless )
+{
+	m_bBatchedRendering = bBatched;
+	m_tSpriteBatch.SetHeadless( bHeadless );
+	// Screen masks are kept for state but hidden from the engine's own mask rendering while batching
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+		RefreshMaskVisibility( m_aAnimations[i] );
+}
+
+/*
+	A loaded atlas is read again at its own tier, a new one at the texture tier
+*/
+GUIAtlasHandle GUIAnimationManager::LoadAtlas( const std::string& sFilenameWithoutExtension, const std::string& sPath )
+{
+	GUIAtlasHandle uiAtlas = FindAtlas( sFilenameWithoutExtension, sPath );
+	const Atlas* pLoaded = GetAtlas( uiAtlas );
+	const eGUITextureTier eTier = pLoaded ? pLoaded->m_eTier : m_eTextureTier;
+	std::map< std::string, GUIAnimation::FrameRect > hFrames;
+	if ( !ReadAtlasFrames( sFilenameWithoutExtension, sPath, eTier, hFrames ) ) return GUI_INVALID_ATLAS;
+
+	if ( uiAtlas == GUI_INVALID_ATLAS ) uiAtlas = m_uiNextAtlasHandle++;
+	Atlas& tAtlas = m_hAtlases[uiAtlas];
+	tAtlas.m_sName = sFilenameWithoutExtension;
+	tAtlas.m_sPath = sPath;
+	tAtlas.m_eTier = eTier;
+	tAtlas.m_hFrames.swap( hFrames ); // Reload: frames removed from the file are gone
+	m_bIsValid = true;
+	return uiAtlas;
+}
+
+bool GUIAnimationManager::ReadAtlasFrames( const std::string& sFilenameWithoutExtension, const std::string& sPath, const eGUITextureTier eTier, std::map< std::string, GUIAnimation::FrameRect >& hFrames )
+{
+	const std::string sFilename = sFilenameWithoutExtension + GetTierExtension( eTier ) + ".json";
+	char pcFileContent[MAX_TPJSONFILE_SIZE];
+	if ( !CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() ) ) return false;
 
 	rapidjson::Document jsonDoc;
 	jsonDoc.Parse<0>( pcFileContent );
+	if ( jsonDoc.HasParseError() || !jsonDoc.IsObject() || !jsonDoc.HasMember( "frames" ) ) return false;
 
 	const rapidjson::Value& frames = jsonDoc["frames"];
 	if ( !frames.IsArray() ) return false;
-
 	for ( unsigned int i = 0; i < frames.Size(); i++ )
 	{
 		if ( frames[i].HasMember( "filename" ) && frames[i].HasMember( "frame" ) )
 		{
-			m_hDecodedTexturePackerJSON[frames[i]["filename"].GetString()] = GUIAnimation::FrameRect( 
+			hFrames[frames[i]["filename"].GetString()] = GUIAnimation::FrameRect( 
 				static_cast<float>(frames[i]["frame"]["x"].GetInt()), 
 				static_cast<float>(frames[i]["frame"]["y"].GetInt()), 
 				static_cast<float>(frames[i]["frame"]["w"].GetInt()), 
 				static_cast<float>(frames[i]["frame"]["h"].GetInt()) );
 		}
 	}
-	m_bIsValid = true;
 	return true;
 }
+
+bool GUIAnimationManager::AtlasTextureExists( const std::string& sFilepathWithoutExtension ) const
+{
+	if ( m_eTextureCompression != GTC_NONE && Vision::File.Exists( GUITextureCompression::GetFilepath( sFilepathWithoutExtension, m_eTextureCompression ).c_str() ) ) return true;
+	return Vision::File.Exists( ( sFilepathWithoutExtension + TPTEXFILE_EXTENSION ).c_str() ) != 0;
+}
+
+eGUITextureTier GUIAnimationManager::GetAtlasTier( const GUIAtlasHandle hAtlas ) const
+{
+	const Atlas* pAtlas = GetAtlas( hAtlas );
+	return pAtlas ? pAtlas->m_eTier : m_eTextureTier;
+}
+
+unsigned int GUIAnimationManager::UnloadAtlas( const GUIAtlasHandle hAtlas )
+{
+	std::map< GUIAtlasHandle, Atlas >::iterator itAtlas = m_hAtlases.find( hAtlas );
+	if ( itAtlas == m_hAtlases.end() ) return 0;
+
+	// Live elements look their frames up under the handle (frame changes, tier and hot reloads): kept until they are destroyed
+	unsigned int uiNumUsers = 0;
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+		if ( m_aAnimations[i] && m_aAnimations[i]->m_uiAtlas == hAtlas ) uiNumUsers++;
+	if ( uiNumUsers > 0 ) return uiNumUsers;
+
+	// Pooled elements only wait to be spawned again
+	for ( std::map< std::string, AnimationPool* >::iterator it = m_hPools.begin(); it != m_hPools.end(); ++it )
+	{
+		AnimationPool* pPool = it->second;
+		unsigned int uiNumKept = 0;
+		for ( unsigned int i = 0; i < pPool->m_uiNumFree; i++ )
+		{
+			GUIAnimation* pAnim = pPool->m_aFree[i];
+			if ( pAnim->m_uiAtlas != hAtlas ) pPool->m_aFree[ uiNumKept++ ] = pAnim;
+			else delete pAnim;
+		}
+		m_tPoolStats.m_uiPooled -= pPool->m_uiNumFree - uiNumKept;
+		pPool->m_uiNumFree = uiNumKept;
+	}
+
+	if ( itAtlas->second.m_spTexture ) itAtlas->second.m_spTexture->EnsureUnloaded();
+	m_hAtlases.erase( itAtlas );
+	m_bIsValid = !m_hAtlases.empty();
+	return 0;
+}
+
+GUIAtlasHandle GUIAnimationManager::FindAtlas( const std::string& sFilenameWithoutExtension, const std::string& sPath ) const
+{
+	for ( std::map< GUIAtlasHandle, Atlas >::const_iterator it = m_hAtlases.begin(); it != m_hAtlases.end(); ++it )
+		if ( it->second.m_sName == sFilenameWithoutExtension && it->second.m_sPath == sPath ) return it->first;
+	return GUI_INVALID_ATLAS;
+}
+
+/*
+	Data and texture files of an atlas are named the same way, its texture is path + name
+*/
+GUIAtlasHandle GUIAnimationManager::FindAtlasByTexture( const std::string& sSrcTexFilepathWithoutExtension ) const
+{
+	for ( std::map< GUIAtlasHandle, Atlas >::const_iterator it = m_hAtlases.begin(); it != m_hAtlases.end(); ++it )
+	{
+		const Atlas& tAtlas = it->second;
+		if ( sSrcTexFilepathWithoutExtension.size() == tAtlas.m_sPath.size() + tAtlas.m_sName.size()
+			&& sSrcTexFilepathWithoutExtension.compare( 0, tAtlas.m_sPath.size(), tAtlas.m_sPath ) == 0
+			&& sSrcTexFilepathWithoutExtension.compare( tAtlas.m_sPath.size(), std::string::npos, tAtlas.m_sName ) == 0 )
+			return it->first;
+	}
+	return GUI_INVALID_ATLAS;
+}
+
+const GUIAnimation::FrameRect* GUIAnimationManager::FindFrame( const GUIAtlasHandle hAtlas, const std::string& sFrame ) const
+{
+	if ( hAtlas != GUI_INVALID_ATLAS )
+	{
+		const Atlas* pAtlas = GetAtlas( hAtlas );
+		if ( !pAtlas ) return 0;
+		std::map< std::string, GUIAnimation::FrameRect >::const_iterator it = pAtlas->m_hFrames.find( sFrame );
+		return ( it != pAtlas->m_hFrames.end() ) ? &it->second : 0;
+	}
+
+	for ( std::map< GUIAtlasHandle, Atlas >::const_reverse_iterator itAtlas = m_hAtlases.rbegin(); itAtlas != m_hAtlases.rend(); ++itAtlas )
+	{
+		std::map< std::string, GUIAnimation::FrameRect >::const_iterator it = itAtlas->second.m_hFrames.find( sFrame );
+		if ( it != itAtlas->second.m_hFrames.end() ) return &it->second;
+	}
+	return 0;
+}
+
+const GUIAnimation::FrameRect& GUIAnimationManager::GetFrame( const GUIAtlasHandle hAtlas, const std::string& sFrame ) const
+{
+	static const GUIAnimation::FrameRect s_tMissing;
+	const GUIAnimation::FrameRect* pFrame = FindFrame( hAtlas, sFrame );
+	return pFrame ? *pFrame : s_tMissing;
+}
+
+const std::map< std::string, GUIAnimation::FrameRect >* GUIAnimationManager::GetAtlasFrames( const GUIAtlasHandle hAtlas ) const
+{
+	const Atlas* pAtlas = GetAtlas( hAtlas );
+	return pAtlas ? &pAtlas->m_hFrames : 0;
+}
+
+void GUIAnimationManager::GetAtlasSource( const GUIAtlasHandle hAtlas, std::string& sFilenameWithoutExtension, std::string& sPath ) const
+{
+	const Atlas* pAtlas = GetAtlas( hAtlas );
+	sFilenameWithoutExtension = pAtlas ? pAtlas->m_sName : std::string();
+	sPath = pAtlas ? pAtlas->m_sPath : std::string();
+}
+
+unsigned int GUIAnimationManager::GetAtlasHandles( DynArray_cl<GUIAtlasHandle>& aHandles ) const
+{
+	unsigned int uiNumHandles = 0;
+	for ( std::map< GUIAtlasHandle, Atlas >::const_iterator it = m_hAtlases.begin(); it != m_hAtlases.end(); ++it )
+		aHandles[ uiNumHandles++ ] = it->first;
+	return uiNumHandles;
+}
+
+GUIAnimationManager::Atlas* GUIAnimationManager::GetAtlas( const GUIAtlasHandle hAtlas )
+{
+	std::map< GUIAtlasHandle, Atlas >::iterator it = m_hAtlases.find( hAtlas );
+	return ( it != m_hAtlases.end() ) ? &it->second : 0;
+}
+
+const GUIAnimationManager::Atlas* GUIAnimationManager::GetAtlas( const GUIAtlasHandle hAtlas ) const
+{
+	std::map< GUIAtlasHandle, Atlas >::const_iterator it = m_hAtlases.find( hAtlas );
+	return ( it != m_hAtlases.end() ) ? &it->second : 0;
+}
+
+/*
+	Pooled elements would keep the previous rects, pools are emptied. Texts from atlas fonts keep their glyphs
+*/
+unsigned int GUIAnimationManager::ReloadAtlasFrames()
+{
+	unsigned int uiNumChanged = 0;
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		GUIAnimation* pAnim = m_aAnimations[i];
+		if ( pAnim && pAnim->ReloadFrames() ) uiNumChanged++;
+	}
+	ClearPools();
+	return uiNumChanged;
+}
+
+/*
+	Compressed containers are stored next to the PNG, see GUITextureCompression::GetFilepath
+*/
+VTextureObject* GUIAnimationManager::LoadAtlasTexture( const std::string& sFilepathWithoutExtension )
+{
+	if ( m_eTextureCompression != GTC_NONE )
+	{
+		const std::string sCompressed = GUITextureCompression::GetFilepath( sFilepathWithoutExtension, m_eTextureCompression );
+		if ( Vision::File.Exists( sCompressed.c_str() ) )
+		{
+			VTextureObject* pTexture = Vision::TextureManager.Load2DTexture( sCompressed.c_str(), VTM_FLAG_NO_MIPMAPS );
+			if ( pTexture && !pTexture->IsLoaded() ) pTexture->EnsureLoaded(); // Evicted by the texture cache
+			if ( pTexture && pTexture->IsLoaded() ) return pTexture;
+		}
+	}
+	VTextureObject* pTexture = Vision::TextureManager.Load2DTexture( ( sFilepathWithoutExtension + TPTEXFILE_EXTENSION ).c_str(), VTM_FLAG_NO_MIPMAPS );
+	if ( pTexture && !pTexture->IsLoaded() ) pTexture->EnsureLoaded(); // Evicted by the texture cache
+	return pTexture;
+}
+
+const char* GUIAnimationManager::GetTierExtension( const eGUITextureTier eTier )
+{
+	switch ( eTier )
+	{
+	case GTT_2X: return "2x";
+	case GTT_4X: return "4x";
+	default: return "";
+	}
+}
+
+/*
+	"name.png" to "name2x.png"
+*/
+std::string GUIAnimationManager::GetTierFilename( const std::string& sFilename, const eGUITextureTier eTier )
+{
+	const size_t uiExtensionDotPos = sFilename.rfind( "." );
+	if ( uiExtensionDotPos == std::string::npos ) return sFilename + GetTierExtension( eTier );
+	return sFilename.substr( 0, uiExtensionDotPos ) + GetTierExtension( eTier ) + sFilename.substr( uiExtensionDotPos );
+}
+
+void GUIAnimationManager::SelectTextureTiers()
+{
+	const int iScreenW = Vision::Video.GetXRes();
+	const int iScreenH = Vision::Video.GetYRes();
+	if ( iScreenW >= MAX_W_OR_H_HD || iScreenH >= MAX_W_OR_H_HD ) m_eLayoutTier = GTT_4X;
+	else if ( iScreenW >= MAX_W_OR_H_SD || iScreenH >= MAX_W_OR_H_SD ) m_eLayoutTier = GTT_2X;
+	else m_eLayoutTier = GTT_SD;
+	SetTextureTier( m_eLayoutTier );
+	EnforceTextureBudget();
+}
+
+/*
+	Atlases with both their JSON and texture at the new tier switch to it, frames and page together; the others keep
+	their tier. Elements of an atlas follow it, standalone textures created through CreateAnimation are swapped when
+	they have a variant at that tier
+*/
+bool GUIAnimationManager::SetTextureTier( const eGUITextureTier eTier )
+{
+	if ( eTier < GTT_SD || eTier >= GTT_COUNT ) return false;
+	const eGUITextureTier ePrevTier = m_eTextureTier;
+	m_eTextureTier = eTier;
+	m_bIsHD = ( eTier != GTT_SD );
+	m_sHDExtension = m_bIsHD ? GetTierExtension( eTier ) : "2x";
+	if ( ePrevTier == eTier ) return true;
+
+	// Same handles, frames and page of the new tier. Pages are only loaded for atlases in use
+	for ( std::map< GUIAtlasHandle, Atlas >::iterator it = m_hAtlases.begin(); it != m_hAtlases.end(); ++it )
+	{
+		Atlas& tAtlas = it->second;
+		if ( tAtlas.m_eTier == eTier ) continue;
+		const std::string sTexturePath = tAtlas.m_sPath + tAtlas.m_sName + GetTierExtension( eTier );
+		std::map< std::string, GUIAnimation::FrameRect > hFrames;
+		if ( !ReadAtlasFrames( tAtlas.m_sName, tAtlas.m_sPath, eTier, hFrames ) ) continue;
+		if ( tAtlas.m_spTexture )
+		{
+			VTextureObject* pTexture = LoadAtlasTexture( sTexturePath );
+			if ( !pTexture || !pTexture->IsLoaded() ) continue;
+			tAtlas.m_spTexture = pTexture;
+		}
+		else if ( !AtlasTextureExists( sTexturePath ) )
+		{
+			continue;
+		}
+		tAtlas.m_hFrames.swap( hFrames );
+		tAtlas.m_eTier = eTier;
+	}
+
+	// Each standalone texture loaded once, shared by the elements using it
+	std::map< std::string, VTextureObject* > hTextures;
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		GUIAnimation* pAnim = m_aAnimations[i];
+		if ( !pAnim || pAnim->m_sTierTexSource.empty() || !pAnim->GetTexture() ) continue;
+		VTextureObject* pTexture = 0;
+		eGUITextureTier eElementTier = eTier;
+		const bool bAtlas = pAnim->m_sTierTexFilename.empty();
+		const Atlas* pAtlas = bAtlas ? GetAtlas( FindAtlasByTexture( pAnim->m_sTierTexSource ) ) : 0;
+		if ( pAtlas )
+		{ // Page of its atlas, at the atlas tier
+			pTexture = pAtlas->m_spTexture;
+			eElementTier = pAtlas->m_eTier;
+		}
+		else
+		{
+			std::string sPath = pAnim->m_sTierTexSource;
+			if ( bAtlas ) sPath += GetTierExtension( eTier );
+			else sPath += GetTierFilename( pAnim->m_sTierTexFilename, eTier );
+			std::map< std::string, VTextureObject* >::iterator it = hTextures.find( sPath );
+			if ( it == hTextures.end() )
+			{
+				VTextureObject* pLoaded = bAtlas ? LoadAtlasTexture( sPath ) : Vision::TextureManager.Load2DTexture( sPath.c_str(), VTM_FLAG_NO_MIPMAPS );
+				it = hTextures.insert( std::make_pair( sPath, pLoaded ) ).first;
+			}
+			pTexture = it->second;
+		}
+		if ( !pTexture || !pTexture->IsLoaded() || pTexture == pAnim->GetTexture()->GetTextureObject() ) continue;
+		m_tTextureCache.Replace( pAnim->GetTexture()->GetTextureObject(), pTexture );
+		pAnim->SwapTexture( pTexture, GetTexelScale( eElementTier ) );
+	}
+
+	// Glyph UVs and pooled elements belong to the previous tier
+	for ( unsigned int i = 0; i < m_uiNumTexts; i++ )
+		m_aTexts[i]->m_bDirty = true;
+	ClearPools();
+	return true;
+}
+
+bool GUIAnimationManager::EnforceTextureBudget()
+{
+	m_bTextureUsageChanged = false;
+	if ( m_uiTextureMemoryBudget == 0 ) return true;
+	while ( GetTextureMemoryUsage() > m_uiTextureMemoryBudget )
+	{
+		if ( !DowngradeTextureTier() ) return false;
+	}
+	return true;
+}
+
+unsigned int GUIAnimationManager::GetTextureMemoryUsage() const
+{
+	std::map< const VTextureObject*, bool > hCounted;
+	unsigned int uiBytes = 0;
+	for ( unsigned int i = 0; i < m_aAnimations.GetValidSize(); i++ )
+	{
+		const GUIAnimation* pAnim = m_aAnimations[i];
+		if ( !pAnim || !pAnim->GetTexture() ) continue;
+		const VTextureObject* pTexture = pAnim->GetTexture()->GetTextureObject();
+		if ( !pTexture || hCounted.find( pTexture ) != hCounted.end() ) continue;
+		hCounted[pTexture] = true;
+		uiBytes += GUITextureCache::GetTextureBytes( pTexture );
+	}
+	return uiBytes;
+}
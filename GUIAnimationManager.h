@@ -4,9 +4,21 @@
 
 #include "GlobalTypes.h"
 #include "GUIAnimation.h"
+#include "GUISpriteBatch.h"
+#include "GUIJobPool.h"
+#include "GUIClock.h"
+#include "GUITimeline.h"
+#include "GUITweenRegistry.h"
+#include "GUIAnimClip.h"
+#include "GUIContainer.h"
+#include "GUIVirtualList.h"
+#include "GUIText.h"
+#include "GUITextureCache.h"
+#include "GUIHotReload.h"
 #include <string>
 #include <map>
 #include <sstream>
+#include <ctime>
 
 
 #define AUTO_LOAD_HD_TEX false
@@ -14,6 +26,16 @@
 #define MAX_W_OR_H_HD 2048
 #define TPTEXFILE_EXTENSION ".png"
 
+
+// Resolution variants of every texture and atlas, file suffixes "", "2x" and "4x"
+enum eGUITextureTier
+{
+	GTT_SD = 0,
+	GTT_2X,
+	GTT_4X,
+	GTT_COUNT
+};
+
 class GUIAnimationManager
 {
 	friend class GUIAnimation;
@@ -29,36 +51,359 @@ public:
 	static void DeInit() { if ( s_pInstance ) delete s_pInstance; s_pInstance = 0; }
 
 
-	GUIAnimation* CreateAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType = GUIAnimation::GAT_ONCE );
+	// Allocated from pArena (per-screen memory, see GUIArena), the heap if null
+	GUIAnimation* CreateAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType = GUIAnimation::GAT_ONCE, GUIArena* pArena = 0 );
+
+	/*
+		Shared description of the elements of a bulk creation: texture or atlas sequence (same meaning as the
+		CreateAnimation arguments), anchoring (offsets are replaced per item when given), order and touchability
+	*/
+	struct AnimationTemplate
+	{
+		AnimationTemplate() : m_iFirstFrame(0), m_iLastFrame(0), m_iNumFrames(0), m_eID(static_cast<eGUIAnimID>(0)), m_eType(GUIAnimation::GAT_ONCE), m_iOrder(GAO_MIDDLE), m_bTouchable(true), m_pArena(0) { m_tAnchorInfo.Init(); }
+
+		std::string m_sSrcTexFilepathWithoutExtension;
+		std::string m_sFilename;
+		int m_iFirstFrame, m_iLastFrame;
+		int m_iNumFrames;
+		eGUIAnimID m_eID;
+		GUIAnimation::eGUIAnimType m_eType;
+		GUIAnimation::UIAnchorInfo m_tAnchorInfo; // Parent included
+		int m_iOrder;
+		bool m_bTouchable;
+		GUIArena* m_pArena; // Null for the heap
+	};
+
+	// Creates uiCount elements from one template: storage reserved once, texture and frames resolved once and every
+	// item laid out in a single pass. pOffsets (optional) gives the anchor offset of each item. The created elements
+	// are written to ppOutAnimations (optional, uiCount entries). Returns the number of elements created
+	unsigned int CreateAnimations( const AnimationTemplate& tTemplate, const unsigned int uiCount, const hkvVec2* pOffsets = 0, GUIAnimation** ppOutAnimations = 0 );
+	// Panel of any size stretched from one atlas frame, border insets in texels
+	GUIAnimation* CreateNineSlice( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sFilename, const float fLeft, const float fTop, const float fRight, const float fBottom, const float fWidth, const float fHeight, const eGUIAnimID eID, GUIArena* pArena = 0 );
+
+	struct PoolStats
+	{
+		void Init() { m_uiSpawned = 0; m_uiReused = 0; m_uiRecycled = 0; m_uiDiscarded = 0; m_uiPooled = 0; }
+
+		unsigned int m_uiSpawned; // SpawnAnimation calls
+		unsigned int m_uiReused; // Spawns served from a pool (no allocation, texture load nor frame lookup)
+		unsigned int m_uiRecycled; // Elements given back to a pool
+		unsigned int m_uiDiscarded; // Recycled elements deleted because their pool was full
+		unsigned int m_uiPooled; // Elements currently waiting in the pools
+	};
+
+	// Pooled elements, one pool per texture/atlas sequence. Spawned elements come back visible and reset (no parent,
+	// callbacks nor tweens); RecycleAnimation hides them and keeps them for the next spawn of the same sequence.
+	// Pools outlive screens, pooled elements are always allocated from the heap
+	GUIAnimation* SpawnAnimation( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const eGUIAnimID eID, const GUIAnimation::eGUIAnimType eType = GUIAnimation::GAT_ONCE );
+	// Elements not spawned from a pool (arena ones included) are deleted
+	void RecycleAnimation( GUIAnimation* pAnim );
+	// Creates pooled elements up front, e.g. while loading the screen
+	void PrewarmPool( const std::string& sSrcTexFilepathWithoutExtension, const std::string& _sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames, const unsigned int uiCount );
+	void SetPoolCapacity( const unsigned int uiCapacity ) { m_uiPoolCapacity = uiCapacity; }
+	void ClearPools();
+	const PoolStats& GetPoolStats() const { return m_tPoolStats; }
 
 	bool IsValid() const { return m_bIsValid; }
 
 	void AddAnimation( GUIAnimation* guiAnimation );
 	void RemoveAnimation( GUIAnimation* guiAnimation );
+	// Screen teardown: removes and deletes every element and text allocated from the arena (their destructors free the
+	// arrays and strings they own), then resets it. False if other objects of the arena are still alive (not reset).
+	// Layouts holding these elements must be dropped, not destroyed afterwards
+	bool ReleaseArena( GUIArena* pArena );
 	GUIAnimation* GetAnimation( unsigned int eAnimID );
 	void Update( float fDeltaTime );
-	std::map< std::string, GUIAnimation::FrameRect >& GetMap() { return m_hDecodedTexturePackerJSON; }
+	void Render();
 
-	void SetElement( const std::string& sKey, const GUIAnimation::FrameRect& tValue ) { m_hDecodedTexturePackerJSON[sKey] = tValue; }
-	const GUIAnimation::FrameRect& GetFrame( const std::string& sKey ) { return m_hDecodedTexturePackerJSON[sKey]; }
+	struct BuildStats
+	{
+		void Init() { m_uiElements = 0; m_fBuildTime = 0.f; }
+
+		unsigned int m_uiElements; // Elements created in the build
+		float m_fBuildTime; // Milliseconds from BeginBuild to the end of EndBuild (CPU time)
+	};
+
+	// Creation of many elements at once (e.g. a whole screen): between BeginBuild and EndBuild positioning, sizing and
+	// order changes are only recorded. EndBuild sorts once and lays every created element out once, parents first
+	void BeginBuild();
+	void EndBuild();
+	bool IsBuilding() const { return m_bBuilding; }
+	const BuildStats& GetBuildStats() const { return m_tBuildStats; }
+
+	// Drives every easing and frame animation from the deltas given to Update
+	GUIClock& GetClock() { return m_tClock; }
+	const GUIClock& GetClock() const { return m_tClock; }
+	// Pool of every easing animation, GUITweenHandle resolves through it
+	GUITweenRegistry& GetTweenRegistry() { return m_tTweenRegistry; }
+	const GUITweenRegistry& GetTweenRegistry() const { return m_tTweenRegistry; }
+	// Timelines are advanced by Update while playing
+	GUITimeline* CreateTimeline();
+	void DestroyTimeline( GUITimeline* pTimeline );
+	unsigned int GetNumTimelines() const { return m_uiNumTimelines; }
+	// Clips are decoded once and cached by path, ".guic" files are read as compiled clips, anything else as JSON.
+	// Null if the file cannot be read
+	const GUIAnimClip* LoadAnimClip( const std::string& sFilename, const std::string& sPath );
+	// Plays the clip on pTarget through a timeline destroyed once finished, valid until then
+	GUITimeline* PlayAnimClip( const GUIAnimClip* pClip, GUIAnimation* pTarget );
+	// Playing clips are not affected, timelines keep their own copy
+	void UnloadAnimClips();
+	// Containers relayout on Update when changed. A null host lays out on the whole screen
+	GUIContainer* CreateContainer( const eGUIContainerType eType, GUIAnimation* pHost );
+	void DestroyContainer( GUIContainer* pContainer );
+	unsigned int GetNumContainers() const { return m_uiNumContainers; }
+	// Rows are created from tRowTemplate parented to pHost (null for the screen). A viewport height of 0 uses the host
+	// height. Null if no row could be created
+	GUIVirtualList* CreateVirtualList( const AnimationTemplate& tRowTemplate, GUIAnimation* pHost, const float fRowHeight, const float fViewportHeight = 0.f, const unsigned int uiNumItems = 0 );
+	// Deletes the rows too
+	void DestroyVirtualList( GUIVirtualList* pList );
+	// Fonts are loaded once and cached by file. BMFont text files (".fnt" with the HD extension when HD, single page
+	// in the same folder) or glyph frames <prefix><char>.png of an atlas whose JSON is already loaded
+	const GUIFont* LoadBMFont( const std::string& sFilenameWithoutExtension, const std::string& sPath );
+	const GUIFont* LoadAtlasFont( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sGlyphPrefix, const char* pcCharset );
+	void UnloadFonts();
+	// Text element on a new GUIAnimation, laid out on Update when changed. Null if the font texture cannot be loaded
+	GUIText* CreateText( const GUIFont* pFont, const eGUIAnimID eID, const char* pcText = "", GUIArena* pArena = 0 );
+	// Deletes the element too
+	void DestroyText( GUIText* pText );
+
+	// Atlases: the frames of each TexturePacker JSON are kept apart under a handle, so equal frame names in two atlases
+	// dont collide. Elements created from an atlas texture (path + name of its JSON) look their frames up in it only.
+	// Loading the same name and path again replaces its frames under the same handle
+	GUIAtlasHandle LoadAtlas( const std::string& sFilenameWithoutExtension, const std::string& sPath );
+	bool LoadTexturePackerJSON( const std::string& sFilenameWithoutExtension, const std::string& sPath ) { return LoadAtlas( sFilenameWithoutExtension, sPath ) != GUI_INVALID_ATLAS; }
+	// Frees the frames, the pooled elements and the texture. Refused while live elements use it: returns their number,
+	// nothing is unloaded then (destroy them first). 0 once unloaded
+	unsigned int UnloadAtlas( const GUIAtlasHandle hAtlas );
+	GUIAtlasHandle FindAtlas( const std::string& sFilenameWithoutExtension, const std::string& sPath ) const;
+	GUIAtlasHandle FindAtlasByTexture( const std::string& sSrcTexFilepathWithoutExtension ) const;
+	// Frame of an atlas, of any atlas with GUI_INVALID_ATLAS (latest loaded first). Null if missing
+	const GUIAnimation::FrameRect* FindFrame( const GUIAtlasHandle hAtlas, const std::string& sFrame ) const;
+	// Invalid rect if missing
+	const GUIAnimation::FrameRect& GetFrame( const GUIAtlasHandle hAtlas, const std::string& sFrame ) const;
+	const GUIAnimation::FrameRect& GetFrame( const std::string& sFrame ) const { return GetFrame( GUI_INVALID_ATLAS, sFrame ); }
+	// Null if not loaded
+	const std::map< std::string, GUIAnimation::FrameRect >* GetAtlasFrames( const GUIAtlasHandle hAtlas ) const;
+	unsigned int GetNumAtlases() const { return static_cast<unsigned int>( m_hAtlases.size() ); }
 
 	VInputMap* GetInputMap() { return m_pInputMap; }
-	bool LoadTexturePackerJSON( const std::string& sFilenameWithoutExtension, const std::string& sPath );
 
 	const std::string& GetHDExtension() const { return m_sHDExtension; }
 	bool IsHD() const { return m_bIsHD; }
 
+	// Texture tiers. The layout tier comes from the screen size and sizes the elements (its texels are pixels); the
+	// texture tier is the one loaded, lower than the layout tier to fit the memory budget. Changing it reloads every
+	// atlas and texture in place: elements are kept, their frame rects rescaled and their size unchanged. Each atlas
+	// keeps its own tier and only switches when both its JSON and texture exist at the new one.
+	// Picks both tiers from the screen size, then lowers the texture tier until the budget is met. Call before creating elements
+	void SelectTextureTiers();
+	bool SetTextureTier( const eGUITextureTier eTier );
+	// One tier down, e.g. on a low memory warning. False if already SD
+	bool DowngradeTextureTier() { return m_eTextureTier > GTT_SD && SetTextureTier( static_cast<eGUITextureTier>( m_eTextureTier - 1 ) ); }
+	eGUITextureTier GetTextureTier() const { return m_eTextureTier; }
+	eGUITextureTier GetLayoutTier() const { return m_eLayoutTier; }
+	// Bytes, 0 for no limit. Checked by SelectTextureTiers and on the next Update after elements were created
+	void SetTextureMemoryBudget( const unsigned int uiBytes ) { m_uiTextureMemoryBudget = uiBytes; m_bTextureUsageChanged = true; }
+	unsigned int GetTextureMemoryBudget() const { return m_uiTextureMemoryBudget; }
+	// Lowers the texture tier while the estimated usage is over the budget. False if it cannot fit
+	bool EnforceTextureBudget();
+	// Estimated memory of the textures used by the elements
+	unsigned int GetTextureMemoryUsage() const;
+	static const char* GetTierExtension( const eGUITextureTier eTier );
+	// Tier the frames and texture of the atlas are loaded at
+	eGUITextureTier GetAtlasTier( const GUIAtlasHandle hAtlas ) const;
+
+	// Atlas pages are loaded from the compressed file of this format when present, from the PNG otherwise. Defaults to
+	// the platform format, unsupported formats fall back to GTC_NONE. Applies to atlases loaded afterwards
+	void SetTextureCompression( const eGUITextureCompression eFormat ) { m_eTextureCompression = GUITextureCompression::IsSupported( eFormat ) ? eFormat : GTC_NONE; }
+	eGUITextureCompression GetTextureCompression() const { return m_eTextureCompression; }
+	// Atlas page from its path without extension (tier included)
+	VTextureObject* LoadAtlasTexture( const std::string& sFilepathWithoutExtension );
+	// Atlas JSON without extension and tier, with its path
+	void GetAtlasSource( const GUIAtlasHandle hAtlas, std::string& sFilenameWithoutExtension, std::string& sPath ) const;
+	// Handles of the loaded atlases, returns their number
+	unsigned int GetAtlasHandles( DynArray_cl<GUIAtlasHandle>& aHandles ) const;
+	// Elements take their frame rects again from the loaded frames, returns the number changed
+	unsigned int ReloadAtlasFrames();
+
+	// Development reloading of changed atlases, textures and layouts (disabled by default)
+	GUIHotReload& GetHotReload() { return m_tHotReload; }
+
+	// Texture memory: accounting per texture and per screen, LRU eviction of textures no visible element uses under a
+	// hard cap (bytes, 0 for none). Textures first used while a tag is set belong to that screen
+	void SetTextureOwnerTag( const std::string& sTag ) { m_sTextureOwnerTag = sTag; }
+	const std::string& GetTextureOwnerTag() const { return m_sTextureOwnerTag; }
+	void SetTextureMemoryCap( const unsigned int uiBytes ) { m_tTextureCache.SetCap( uiBytes ); }
+	// Stats up to date on return
+	const GUITextureCache& GetTextureCache();
+	void EvictUnusedTextures() { GetTextureCache(); m_tTextureCache.EvictUnused(); }
+	static float GetTierScale( const eGUITextureTier eTier ) { return static_cast<float>( 1 << eTier ); }
+	// Texels of the texture tier (or eTier) per layout pixel
+	float GetTexelScale() const { return GetTexelScale( m_eTextureTier ); }
+	float GetTexelScale( const eGUITextureTier eTier ) const { return GetTierScale( eTier ) / GetTierScale( m_eLayoutTier ); }
+
+	// Batched rendering: elements are drawn by the sprite batch instead of one screen mask each
+	void SetBatchedRendering( const bool bBatched, const bool bHeadless = false );
+	bool IsBatchedRendering() const { return m_bBatchedRendering; }
+	const GUISpriteBatch::BatchStats& GetBatchStats() const { return m_tSpriteBatch.GetStats(); }
+
+	struct CullingStats
+	{
+		void Init() { m_uiCulled = 0; m_uiCulledByParent = 0; m_uiVisited = 0; }
+
+		unsigned int m_uiCulled; // Visible elements culled this frame (off-screen, transparent or culled parent)
+		unsigned int m_uiCulledByParent;
+		unsigned int m_uiVisited; // Visible elements visited this frame
+	};
+
+	// Elements updated each frame (animating, dirty layout or just woken up)
+	unsigned int GetActiveCount() const { return m_uiNumActive; }
+	unsigned int GetTouchableCount() const { return m_uiNumTouchables; }
+
+	struct ParallelStats
+	{
+		void Init() { m_uiEvaluated = 0; m_uiLayoutResolved = 0; m_uiLayoutLevels = 0; }
+
+		unsigned int m_uiEvaluated; // Elements whose animations were evaluated in parallel
+		unsigned int m_uiLayoutResolved; // Layouts resolved in parallel
+		unsigned int m_uiLayoutLevels; // Parent-before-child levels (one parallel loop each)
+	};
+
+	// Parallel update: used when at least uiMinElements are awake. uiNumWorkers 0 means one per engine thread
+	void SetParallelUpdate( const bool bEnabled, const unsigned int uiNumWorkers = 0, const unsigned int uiMinElements = 256 );
+	bool IsParallelUpdate() const { return m_bParallelUpdate; }
+	const ParallelStats& GetParallelStats() const { return m_tParallelStats; }
+
+	void SetCullingEnabled( const bool bEnabled );
+	bool IsCullingEnabled() const { return m_bCullingEnabled; }
+	const CullingStats& GetCullingStats() const { return m_tCullingStats; }
+
 private:
 	static GUIAnimationManager* s_pInstance;
 
 	DynArray_cl<GUIAnimation*> m_aAnimations;
-	std::map< std::string, GUIAnimation::FrameRect > m_hDecodedTexturePackerJSON;
 	VInputMap* m_pInputMap;
 	bool m_bIsValid;
 	std::string m_sHDExtension;
 	bool m_bIsHD;
+	eGUITextureTier m_eLayoutTier;
+	eGUITextureTier m_eTextureTier;
+	unsigned int m_uiTextureMemoryBudget;
+	bool m_bTextureUsageChanged; // Budget checked on the next Update
+	GUITextureCache m_tTextureCache;
+	GUIHotReload m_tHotReload;
+	eGUITextureCompression m_eTextureCompression;
+	std::string m_sTextureOwnerTag;
 	GUIAnimation* m_pTouchHandler;
 	bool m_bAnimsArrayIsDirty;
+	GUISpriteBatch m_tSpriteBatch;
+	GUIClock m_tClock;
+	GUITweenRegistry m_tTweenRegistry;
+	bool m_bBatchedRendering;
+	bool m_bCullingEnabled;
+	unsigned int m_uiFrame;
+	CullingStats m_tCullingStats;
+	DynArray_cl<GUITimeline*> m_aTimelines;
+	unsigned int m_uiNumTimelines;
+	bool m_bUpdatingTimelines;
+	std::map< std::string, GUIAnimClip* > m_hAnimClips;
+	DynArray_cl<GUIContainer*> m_aContainers;
+	unsigned int m_uiNumContainers;
+	DynArray_cl<GUIVirtualList*> m_aVirtualLists;
+	unsigned int m_uiNumVirtualLists;
+	std::map< std::string, GUIFont* > m_hFonts;
+	DynArray_cl<GUIText*> m_aTexts;
+	unsigned int m_uiNumTexts;
+
+	// Active set: only awake elements are visited by Update
+	DynArray_cl<GUIAnimation*> m_aActiveAnimations;
+	unsigned int m_uiNumActive;
+	bool m_bUpdatingActive; // Destroyed elements are nulled in the active list instead of removed
+	// Touch candidates ordered front to back, only tested while the pointer is down
+	DynArray_cl<GUIAnimation*> m_aTouchables;
+	unsigned int m_uiNumTouchables;
+
+	// Parallel update
+	struct LayoutPassEntry
+	{
+		LayoutPassEntry() : m_pAnim(0), m_uiDepth(0), m_uiSeq(0) {}
+
+		GUIAnimation* m_pAnim;
+		unsigned int m_uiDepth; // Number of ancestors
+		unsigned int m_uiSeq;
+	};
+
+	GUIJobPool m_tJobPool;
+	bool m_bParallelUpdate;
+	unsigned int m_uiParallelMinElements;
+	DynArray_cl<GUIAnimation*> m_aParallelWork;
+	unsigned int m_uiNumParallelWork;
+	DynArray_cl<LayoutPassEntry> m_aLayoutPass;
+	unsigned int m_uiNumLayoutPass;
+	unsigned int m_uiLayoutLevelBegin;
+	ParallelStats m_tParallelStats;
+
+	// Recycling pools by sequence key
+	struct AnimationPool
+	{
+		AnimationPool() : m_uiNumFree(0) { m_aFree.Init(0); }
+
+		DynArray_cl<GUIAnimation*> m_aFree;
+		unsigned int m_uiNumFree;
+	};
+
+	std::map< std::string, AnimationPool* > m_hPools;
+
+	struct Atlas
+	{
+		std::string m_sName; // JSON without extension and tier
+		std::string m_sPath;
+		std::map< std::string, GUIAnimation::FrameRect > m_hFrames;
+		VTextureObjectPtr m_spTexture; // Loaded tier, set by the first element created from it
+		eGUITextureTier m_eTier; // Of the frames and texture
+	};
+
+	Atlas* GetAtlas( const GUIAtlasHandle hAtlas );
+	const Atlas* GetAtlas( const GUIAtlasHandle hAtlas ) const;
+	static bool ReadAtlasFrames( const std::string& sFilenameWithoutExtension, const std::string& sPath, const eGUITextureTier eTier, std::map< std::string, GUIAnimation::FrameRect >& hFrames );
+	bool AtlasTextureExists( const std::string& sFilepathWithoutExtension ) const;
+
+	std::map< GUIAtlasHandle, Atlas > m_hAtlases;
+	GUIAtlasHandle m_uiNextAtlasHandle;
+	unsigned int m_uiPoolCapacity; // Max idle elements per pool
+	PoolStats m_tPoolStats;
+
+	static std::string GetPoolKey( const std::string& sSrcTexFilepathWithoutExtension, const std::string& sFilename, const int iFirstFrame, const int iLastFrame, const int iNumFrames );
+
+	// Build of many elements at once
+	bool m_bBuilding;
+	DynArray_cl<GUIAnimation*> m_aBuildElements;
+	unsigned int m_uiNumBuildElements;
+	clock_t m_tBuildStartClock;
+	BuildStats m_tBuildStats;
+
+	void SortAnimations();
+	void UpdateParallel();
+	void AddToLayoutPass( GUIAnimation* pAnim );
+	static std::string GetTierFilename( const std::string& sFilename, const eGUITextureTier eTier );
+	static bool CompareLayoutPassEntries( const LayoutPassEntry& tEntry0, const LayoutPassEntry& tEntry1 );
+	static void EvaluateAnimationsJob( void* pUserData, const unsigned int uiBegin, const unsigned int uiEnd );
+	static void ResolveLayoutsJob( void* pUserData, const unsigned int uiBegin, const unsigned int uiEnd );
+
+	void RefreshMaskVisibility( GUIAnimation* pAnim ) const;
+	// Element shown, hidden, culled, restored or given another texture
+	void OnTextureUseChanged( GUIAnimation* pAnim ) { m_tTextureCache.UpdateElement( pAnim ); }
+	void UpdateCulling( GUIAnimation* pAnim );
+	void UpdateInput();
+	void UpdateTimelines();
+	void UpdateTexts();
+	void UpdateContainers();
+	void UpdateVirtualLists();
+	void WakeAnimation( GUIAnimation* pAnim );
+	void RegisterTouchable( GUIAnimation* pAnim );
+	void UnregisterTouchable( GUIAnimation* pAnim );
+	void OnAnimationDestroyed( GUIAnimation* pAnim );
+	void OnAnimationResized( GUIAnimation* pAnim );
 };
 
 
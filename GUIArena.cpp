@@ -0,0 +1,86 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIArena.h"
+
+
+GUIArena::GUIArena( const unsigned int uiCapacity )
+{
+	m_uiCapacity = uiCapacity;
+	char* pcMemory = static_cast<char*>( ::operator new( GUI_ARENA_ALIGNMENT + m_uiCapacity ) );
+	m_pBlock = reinterpret_cast<Block*>( pcMemory );
+	m_pBlock->m_pArena = this;
+	m_pBlock->m_uiNumLive = 0;
+	m_pcData = pcMemory + GUI_ARENA_ALIGNMENT;
+	m_uiUsed = 0;
+	m_uiPeak = 0;
+	m_uiNumFallbacks = 0;
+}
+
+/*
+	Objects left would point to freed memory: the block is then kept and freed by the last FreeObject
+*/
+GUIArena::~GUIArena()
+{
+	VASSERT( m_pBlock->m_uiNumLive == 0 );
+	m_pBlock->m_pArena = 0;
+	if ( m_pBlock->m_uiNumLive == 0 ) ::operator delete( m_pBlock );
+	m_pBlock = 0;
+	m_pcData = 0;
+}
+
+void* GUIArena::Allocate( const size_t uiSize )
+{
+	const unsigned int uiStart = ( m_uiUsed + GUI_ARENA_ALIGNMENT - 1 ) & ~( GUI_ARENA_ALIGNMENT - 1 );
+	if ( uiStart > m_uiCapacity || uiSize > m_uiCapacity - uiStart ) return 0;
+	m_uiUsed = uiStart + static_cast<unsigned int>(uiSize);
+	if ( m_uiUsed > m_uiPeak ) m_uiPeak = m_uiUsed;
+	return m_pcData + uiStart;
+}
+
+bool GUIArena::Reset()
+{
+	if ( m_pBlock->m_uiNumLive > 0 ) return false;
+	m_uiUsed = 0;
+	return true;
+}
+
+/*
+	Each object is preceded by the block it comes from, null for the heap
+*/
+void* GUIArena::AllocateObject( const size_t uiSize, GUIArena* pArena )
+{
+	char* pcMemory = pArena ? static_cast<char*>( pArena->Allocate( uiSize + GUI_ARENA_ALIGNMENT ) ) : 0;
+	Block* pBlock = 0;
+	if ( pcMemory )
+	{
+		pBlock = pArena->m_pBlock;
+		pBlock->m_uiNumLive++;
+	}
+	else
+	{ // No arena or full: heap
+		if ( pArena ) pArena->m_uiNumFallbacks++;
+		pcMemory = static_cast<char*>( ::operator new( uiSize + GUI_ARENA_ALIGNMENT ) );
+	}
+	*reinterpret_cast<Block**>( pcMemory ) = pBlock;
+	return pcMemory + GUI_ARENA_ALIGNMENT;
+}
+
+void GUIArena::FreeObject( void* pObject )
+{
+	if ( !pObject ) return;
+	char* pcMemory = static_cast<char*>( pObject ) - GUI_ARENA_ALIGNMENT;
+	Block* pBlock = *reinterpret_cast<Block**>( pcMemory );
+	if ( !pBlock )
+	{
+		::operator delete( pcMemory );
+		return;
+	}
+	pBlock->m_uiNumLive--; // Memory back on Reset
+	if ( !pBlock->m_pArena && pBlock->m_uiNumLive == 0 ) ::operator delete( pBlock ); // Last object of a destroyed arena
+}
+
+GUIArena* GUIArena::GetOwner( const void* pObject )
+{
+	if ( !pObject ) return 0;
+	const Block* pBlock = *reinterpret_cast<Block* const*>( static_cast<const char*>( pObject ) - GUI_ARENA_ALIGNMENT );
+	return pBlock ? pBlock->m_pArena : 0;
+}
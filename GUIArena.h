@@ -0,0 +1,80 @@
+#ifndef GUIARENA_H_INCLUDED
+#define GUIARENA_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include <new>
+
+
+#define GUI_ARENA_ALIGNMENT 16 // Also the size of the header in front of each object
+#define GUI_ARENA_DEFAULT_CAPACITY ( 256 * 1024 )
+
+
+/*
+	Monotonic allocator for the GUI objects of one screen: a single block handed out in order, never freed piece by
+	piece and released at once by Reset when the screen closes. The arena is passed at creation (CreateAnimation,
+	CreateText, CreateNineSlice, AnimationTemplate, GUILayout::SetArena) and the sub-objects of an element (springs,
+	nine-slice) follow it; null or full arenas fall back to the heap, so objects that outlive the screen are created
+	without one. Pooled elements (SpawnAnimation) always live on the heap.
+	Deleting an object of the arena runs its destructor and only counts it out; Reset refuses while objects are alive.
+	GUIAnimationManager::ReleaseArena tears a screen down in one call: it deletes the elements and texts of the arena,
+	then resets it. An arena destroyed with live objects keeps its block until the last of them is deleted.
+	Only the objects themselves come from the block: their internal arrays and strings use the engine allocator and
+	are freed by their destructors, which is why Reset never skips them.
+*/
+class GUIArena
+{
+public:
+	explicit GUIArena( const unsigned int uiCapacity = GUI_ARENA_DEFAULT_CAPACITY );
+	~GUIArena();
+
+	// Null when full
+	void* Allocate( const size_t uiSize );
+	// O(1). False, and nothing released, while objects of the arena are alive
+	bool Reset();
+
+	unsigned int GetCapacity() const { return m_uiCapacity; }
+	unsigned int GetUsed() const { return m_uiUsed; }
+	unsigned int GetPeak() const { return m_uiPeak; }
+	unsigned int GetNumLive() const { return m_pBlock->m_uiNumLive; }
+	// Objects created on the heap because the arena was full
+	unsigned int GetNumFallbacks() const { return m_uiNumFallbacks; }
+
+	// From pArena, or the heap if null or full
+	static void* AllocateObject( const size_t uiSize, GUIArena* pArena );
+	static void FreeObject( void* pObject );
+	// Arena an object was allocated from, null for the heap
+	static GUIArena* GetOwner( const void* pObject );
+
+private:
+	GUIArena( const GUIArena& );
+	GUIArena& operator=( const GUIArena& );
+
+	// Start of the memory, referenced by the header of each object so it outlives an arena destroyed too early
+	struct Block
+	{
+		GUIArena* m_pArena; // Null once the arena is destroyed
+		unsigned int m_uiNumLive;
+	};
+
+	Block* m_pBlock;
+	char* m_pcData;
+	unsigned int m_uiCapacity;
+	unsigned int m_uiUsed;
+	unsigned int m_uiPeak;
+	unsigned int m_uiNumFallbacks;
+};
+
+
+// Class allocation: new ( pArena ) T from an arena, plain new from the heap
+#define GUI_DECLARE_ARENA_NEW \
+	static void* operator new( size_t uiSize ) { return GUIArena::AllocateObject( uiSize, 0 ); } \
+	static void* operator new( size_t uiSize, GUIArena* pArena ) { return GUIArena::AllocateObject( uiSize, pArena ); } \
+	static void operator delete( void* pObject ) { GUIArena::FreeObject( pObject ); } \
+	static void operator delete( void* pObject, GUIArena* ) { GUIArena::FreeObject( pObject ); } \
+	static void* operator new[]( size_t uiSize ) { return GUIArena::AllocateObject( uiSize, 0 ); } \
+	static void* operator new[]( size_t uiSize, GUIArena* pArena ) { return GUIArena::AllocateObject( uiSize, pArena ); } \
+	static void operator delete[]( void* pObject ) { GUIArena::FreeObject( pObject ); } \
+	static void operator delete[]( void* pObject, GUIArena* ) { GUIArena::FreeObject( pObject ); }
+
+
+#endif // GUIARENA_H_INCLUDED
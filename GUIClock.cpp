@@ -0,0 +1,58 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIClock.h"
+
+
+GUIClock::GUIClock()
+{
+	m_fTimeScale = 1.f;
+	m_bPaused = false;
+	m_fFixedTimeStep = 0.f;
+	for ( unsigned int i = 0; i < GUI_MAX_TIME_GROUPS; i++ )
+	{
+		m_afGroupTimeScale[i] = 1.f;
+		m_abGroupPaused[i] = false;
+	}
+	Reset();
+}
+
+/*
+	Rewinds every time to zero. Scales, pauses and fixed step are kept
+*/
+void GUIClock::Reset()
+{
+	m_fRealTime = 0.f;
+	m_fRealDeltaTime = 0.f;
+	m_fStepAccumulator = 0.f;
+	m_uiStepsLastAdvance = 0;
+	for ( unsigned int i = 0; i < GUI_MAX_TIME_GROUPS; i++ )
+	{
+		m_afGroupTime[i] = 0.f;
+		m_afGroupDeltaTime[i] = 0.f;
+	}
+}
+
+void GUIClock::Advance( const float fDeltaTime )
+{
+	float fRealDelta = hkvMath::Max( fDeltaTime, 0.f );
+	if ( m_fFixedTimeStep > 0.f )
+	{ // Whole steps only, the remainder waits for the next frame
+		m_fStepAccumulator += fRealDelta;
+		m_uiStepsLastAdvance = static_cast<unsigned int>( m_fStepAccumulator / m_fFixedTimeStep );
+		fRealDelta = m_uiStepsLastAdvance * m_fFixedTimeStep;
+		m_fStepAccumulator -= fRealDelta;
+	}
+	else
+	{
+		m_uiStepsLastAdvance = 1;
+	}
+
+	m_fRealDeltaTime = fRealDelta;
+	m_fRealTime += fRealDelta;
+
+	const float fScaledDelta = m_bPaused ? 0.f : fRealDelta * m_fTimeScale;
+	for ( unsigned int i = 0; i < GUI_MAX_TIME_GROUPS; i++ )
+	{
+		m_afGroupDeltaTime[i] = m_abGroupPaused[i] ? 0.f : fScaledDelta * m_afGroupTimeScale[i];
+		m_afGroupTime[i] += m_afGroupDeltaTime[i];
+	}
+}
@@ -0,0 +1,65 @@
+#ifndef GUICLOCK_H_INCLUDED
+#define GUICLOCK_H_INCLUDED
+
+#include "GlobalTypes.h"
+
+
+#define GUI_MAX_TIME_GROUPS 8
+
+
+/*
+	GUI time source advanced only by the delta given to GUIAnimationManager::Update, so the same sequence
+	of deltas always gives the same animation state. Real time ignores pause and time scales; scaled time
+	is kept per group (global scale * group scale, paused groups stand still).
+	With a fixed time step the clock advances in whole steps and carries the remainder to the next frame.
+*/
+class GUIClock
+{
+public:
+	GUIClock();
+
+	void Reset();
+	void Advance( const float fDeltaTime );
+
+	// Real time
+	float GetRealTime() const { return m_fRealTime; }
+	float GetRealDeltaTime() const { return m_fRealDeltaTime; }
+	// Scaled time of a group
+	float GetTime( const unsigned int uiGroup = 0 ) const { return m_afGroupTime[ ClampGroup( uiGroup ) ]; }
+	float GetDeltaTime( const unsigned int uiGroup = 0 ) const { return m_afGroupDeltaTime[ ClampGroup( uiGroup ) ]; }
+	float GetTime( const unsigned int uiGroup, const bool bAffectedByTimeScale ) const { return bAffectedByTimeScale ? GetTime( uiGroup ) : GetRealTime(); }
+
+	void SetTimeScale( const float fTimeScale ) { m_fTimeScale = hkvMath::Max( fTimeScale, 0.f ); }
+	float GetTimeScale() const { return m_fTimeScale; }
+	void SetGroupTimeScale( const unsigned int uiGroup, const float fTimeScale ) { m_afGroupTimeScale[ ClampGroup( uiGroup ) ] = hkvMath::Max( fTimeScale, 0.f ); }
+	float GetGroupTimeScale( const unsigned int uiGroup ) const { return m_afGroupTimeScale[ ClampGroup( uiGroup ) ]; }
+
+	void SetPaused( const bool bPaused ) { m_bPaused = bPaused; }
+	bool IsPaused() const { return m_bPaused; }
+	void SetGroupPaused( const unsigned int uiGroup, const bool bPaused ) { m_abGroupPaused[ ClampGroup( uiGroup ) ] = bPaused; }
+	bool IsGroupPaused( const unsigned int uiGroup ) const { return m_abGroupPaused[ ClampGroup( uiGroup ) ]; }
+
+	// 0 disables the fixed step
+	void SetFixedTimeStep( const float fStep ) { m_fFixedTimeStep = hkvMath::Max( fStep, 0.f ); m_fStepAccumulator = 0.f; }
+	float GetFixedTimeStep() const { return m_fFixedTimeStep; }
+	unsigned int GetStepsLastAdvance() const { return m_uiStepsLastAdvance; }
+
+private:
+	static unsigned int ClampGroup( const unsigned int uiGroup ) { return ( uiGroup < GUI_MAX_TIME_GROUPS ) ? uiGroup : 0; }
+
+	float m_fRealTime;
+	float m_fRealDeltaTime;
+	float m_afGroupTime[GUI_MAX_TIME_GROUPS];
+	float m_afGroupDeltaTime[GUI_MAX_TIME_GROUPS];
+	float m_afGroupTimeScale[GUI_MAX_TIME_GROUPS];
+	bool m_abGroupPaused[GUI_MAX_TIME_GROUPS];
+	float m_fTimeScale;
+	bool m_bPaused;
+
+	float m_fFixedTimeStep;
+	float m_fStepAccumulator;
+	unsigned int m_uiStepsLastAdvance;
+};
+
+
+#endif // GUICLOCK_H_INCLUDED
@@ -0,0 +1,201 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIContainer.h"
+#include "GUIAnimationManager.h"
+
+
+#define CONTAINER_CLEAN 0xFFFFFFFFu
+
+
+namespace
+{
+	// Size as loaded or set, valid before the first layout resolve
+	void GetItemSize( const GUIAnimation* pAnim, float& fWidth, float& fHeight )
+	{
+		fWidth = 0.f;
+		fHeight = 0.f;
+		if ( pAnim->GetTexture() ) pAnim->GetTexture()->GetTargetSize( fWidth, fHeight );
+	}
+}
+
+
+GUIContainer::GUIContainer( const eGUIContainerType eType, GUIAnimation* pHost )
+{
+	m_eType = eType;
+	m_pHost = pHost;
+	m_aItems.Init( Item() );
+	m_uiNumItems = 0;
+	m_uiFirstDirty = CONTAINER_CLEAN;
+	m_bRemovedTail = false;
+	m_bHostResized = false;
+	m_fSpacingX = 0.f;
+	m_fSpacingY = 0.f;
+	m_fPaddingLeft = 0.f;
+	m_fPaddingTop = 0.f;
+	m_uiColumns = 0;
+	m_uiResolvedColumns = 0;
+	m_fCellWidth = 0.f;
+	m_fCellHeight = 0.f;
+	m_fContentWidth = 0.f;
+	m_fContentHeight = 0.f;
+	m_uiLastVisited = 0;
+	m_uiLastMoved = 0;
+	if ( m_pHost ) m_pHost->m_bInContainer = true;
+}
+
+GUIContainer::~GUIContainer()
+{
+	m_aItems.Reset();
+	m_pHost = 0;
+}
+
+void GUIContainer::Insert( const unsigned int uiIndex, GUIAnimation* pItem )
+{
+	VASSERT( pItem );
+	if ( !pItem ) return;
+	const unsigned int uiPos = hkvMath::Min( uiIndex, m_uiNumItems );
+
+	m_aItems.EnsureSize( m_uiNumItems + 1 );
+	Item* pItems = m_aItems.GetDataPtr();
+	for ( unsigned int i = m_uiNumItems; i > uiPos; i-- )
+		pItems[i] = pItems[i - 1];
+	pItems[uiPos] = Item();
+	pItems[uiPos].m_pAnim = pItem;
+	m_uiNumItems++;
+	pItem->m_bInContainer = true;
+
+	pItem->SetParent( m_pHost );
+	MarkDirty( uiPos );
+}
+
+void GUIContainer::Remove( GUIAnimation* pItem )
+{
+	const int iIndex = GetItemIndex( pItem );
+	if ( iIndex >= 0 ) RemoveAt( static_cast<unsigned int>(iIndex) );
+}
+
+/*
+	The removed element keeps its parent and position
+*/
+void GUIContainer::RemoveAt( const unsigned int uiIndex )
+{
+	if ( uiIndex >= m_uiNumItems ) return;
+
+	Item* pItems = m_aItems.GetDataPtr();
+	for ( unsigned int i = uiIndex; i + 1 < m_uiNumItems; i++ )
+		pItems[i] = pItems[i + 1];
+	m_uiNumItems--;
+
+	if ( uiIndex < m_uiNumItems ) MarkDirty( uiIndex );
+	else m_bRemovedTail = true;
+}
+
+void GUIContainer::Clear()
+{
+	m_uiNumItems = 0;
+	m_uiFirstDirty = CONTAINER_CLEAN;
+	m_bRemovedTail = true;
+}
+
+void GUIContainer::MarkItemDirty( GUIAnimation* pItem )
+{
+	const int iIndex = GetItemIndex( pItem );
+	if ( iIndex >= 0 ) MarkDirty( static_cast<unsigned int>(iIndex) );
+}
+
+int GUIContainer::GetItemIndex( const GUIAnimation* pItem ) const
+{
+	const Item* pItems = m_aItems.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumItems; i++ )
+		if ( pItems[i].m_pAnim == pItem ) return static_cast<int>(i);
+	return -1;
+}
+
+unsigned int GUIContainer::ResolveColumns( const float fCellWidth ) const
+{
+	if ( m_uiColumns > 0 ) return m_uiColumns;
+
+	float fHostWidth, fHostHeight;
+	if ( m_pHost ) GetItemSize( m_pHost, fHostWidth, fHostHeight );
+	else fHostWidth = static_cast<float>(Vision::Video.GetXRes());
+	const float fStride = fCellWidth + m_fSpacingX;
+	if ( fStride <= 0.f ) return 1;
+	const float fColumns = hkvMath::floor( ( fHostWidth - 2.f * m_fPaddingLeft + m_fSpacingX ) / fStride );
+	return ( fColumns >= 1.f ) ? static_cast<unsigned int>(fColumns) : 1;
+}
+
+/*
+	One pass from the first dirty item. Each rect only depends on the previous one (stacks) or on the index (grid),
+	so the items before it are not visited
+*/
+void GUIContainer::Relayout()
+{
+	if ( !IsDirty() ) return;
+
+	Item* pItems = m_aItems.GetDataPtr();
+	unsigned int uiFirst = hkvMath::Min( m_uiFirstDirty, m_uiNumItems );
+
+	// Grid cell and columns, a change moves every item
+	float fCellWidth = m_fCellWidth, fCellHeight = m_fCellHeight;
+	if ( m_eType == GCT_WRAP_GRID && m_uiNumItems > 0 && ( fCellWidth <= 0.f || fCellHeight <= 0.f ) )
+	{
+		float fFirstWidth, fFirstHeight;
+		GetItemSize( pItems[0].m_pAnim, fFirstWidth, fFirstHeight );
+		if ( fCellWidth <= 0.f ) fCellWidth = fFirstWidth;
+		if ( fCellHeight <= 0.f ) fCellHeight = fFirstHeight;
+	}
+	const unsigned int uiColumns = ( m_eType == GCT_WRAP_GRID ) ? ResolveColumns( fCellWidth ) : 0;
+	if ( uiColumns != m_uiResolvedColumns ) uiFirst = 0;
+	m_uiResolvedColumns = uiColumns;
+
+	m_uiLastVisited = 0;
+	m_uiLastMoved = 0;
+	for ( unsigned int i = uiFirst; i < m_uiNumItems; i++ )
+	{
+		Item& tItem = pItems[i];
+		const Item* pPrev = ( i > 0 ) ? &pItems[i - 1] : 0;
+		float fWidth, fHeight;
+		GetItemSize( tItem.m_pAnim, fWidth, fHeight );
+
+		float fX = m_fPaddingLeft, fY = m_fPaddingTop;
+		switch ( m_eType )
+		{
+		case GCT_HORIZONTAL_STACK:
+			if ( pPrev ) fX = pPrev->m_fX + pPrev->m_fW + m_fSpacingX;
+			break;
+		case GCT_VERTICAL_STACK:
+			if ( pPrev ) fY = pPrev->m_fY + pPrev->m_fH + m_fSpacingY;
+			break;
+		case GCT_WRAP_GRID:
+			fX += ( i % uiColumns ) * ( fCellWidth + m_fSpacingX );
+			fY += ( i / uiColumns ) * ( fCellHeight + m_fSpacingY );
+			fWidth = fCellWidth;
+			fHeight = fCellHeight;
+			break;
+		default:
+			break;
+		}
+
+		m_uiLastVisited++;
+		tItem.m_fW = fWidth;
+		tItem.m_fH = fHeight;
+		if ( tItem.m_bPlaced && tItem.m_fX == fX && tItem.m_fY == fY ) continue;
+		tItem.m_fX = fX;
+		tItem.m_fY = fY;
+		tItem.m_bPlaced = true;
+		tItem.m_pAnim->PixelPositionFromTopLeft( fY, fX );
+		m_uiLastMoved++;
+	}
+
+	// Content extent from the cached rects, no element is touched
+	m_fContentWidth = 0.f;
+	m_fContentHeight = 0.f;
+	for ( unsigned int i = 0; i < m_uiNumItems; i++ )
+	{
+		m_fContentWidth = hkvMath::Max( m_fContentWidth, pItems[i].m_fX + pItems[i].m_fW + m_fPaddingLeft );
+		m_fContentHeight = hkvMath::Max( m_fContentHeight, pItems[i].m_fY + pItems[i].m_fH + m_fPaddingTop );
+	}
+
+	m_uiFirstDirty = CONTAINER_CLEAN;
+	m_bRemovedTail = false;
+	m_bHostResized = false;
+}
@@ -0,0 +1,98 @@
+#ifndef GUICONTAINER_H_INCLUDED
+#define GUICONTAINER_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+
+
+enum eGUIContainerType
+{
+	GCT_HORIZONTAL_STACK = 0,
+	GCT_VERTICAL_STACK,
+	GCT_WRAP_GRID
+};
+
+
+/*
+	Places its items inside a host element (or the screen) in pixels from the host top left corner. Child rects are
+	computed in one linear pass on the next manager update, starting at the first changed index: items before it
+	keep their rect and are not touched, items after it are only repositioned if their rect moved.
+	Stacks place items one after another with their own size, the wrap grid uses a uniform cell (the first item
+	size unless set) and a fixed number of columns, or as many as fit in the host width.
+	Items are parented to the host. Resizing an item (scale, tweens, springs, texts) relayouts from it, resizing the
+	host resolves the columns of a fitting grid again. Created and owned by GUIAnimationManager.
+*/
+class GUIContainer
+{
+	friend class GUIAnimationManager;
+
+public:
+	void Add( GUIAnimation* pItem ) { Insert( m_uiNumItems, pItem ); }
+	void Insert( const unsigned int uiIndex, GUIAnimation* pItem );
+	void Remove( GUIAnimation* pItem );
+	void RemoveAt( const unsigned int uiIndex );
+	void Clear();
+	// Size of the item changed, relayout from it. Called by the manager on every item resize (GUIAnimation::SetSize)
+	void MarkItemDirty( GUIAnimation* pItem );
+	void MarkDirty( const unsigned int uiFromIndex = 0 ) { if ( uiFromIndex < m_uiFirstDirty ) m_uiFirstDirty = uiFromIndex; }
+	// Applies pending changes now instead of on the next manager update
+	void Relayout();
+
+	void SetSpacing( const float fSpacingX, const float fSpacingY ) { m_fSpacingX = fSpacingX; m_fSpacingY = fSpacingY; MarkDirty(); }
+	void SetPadding( const float fPaddingLeft, const float fPaddingTop ) { m_fPaddingLeft = fPaddingLeft; m_fPaddingTop = fPaddingTop; MarkDirty(); }
+	// Wrap grid only. 0 columns fits as many as the host width allows, 0 cell size uses the first item size
+	void SetColumns( const unsigned int uiColumns ) { m_uiColumns = uiColumns; MarkDirty(); }
+	void SetCellSize( const float fWidth, const float fHeight ) { m_fCellWidth = fWidth; m_fCellHeight = fHeight; MarkDirty(); }
+
+	eGUIContainerType GetType() const { return m_eType; }
+	GUIAnimation* GetHost() const { return m_pHost; }
+	unsigned int GetNumItems() const { return m_uiNumItems; }
+	GUIAnimation* GetItem( const unsigned int uiIndex ) const { return m_aItems.GetDataPtr()[uiIndex].m_pAnim; }
+	int GetItemIndex( const GUIAnimation* pItem ) const;
+	bool IsDirty() const { return m_uiFirstDirty < m_uiNumItems || m_bRemovedTail || m_bHostResized; }
+	// Extent of the items including padding, in pixels
+	float GetContentWidth() const { return m_fContentWidth; }
+	float GetContentHeight() const { return m_fContentHeight; }
+	// Items visited and repositioned by the last relayout
+	unsigned int GetLastVisited() const { return m_uiLastVisited; }
+	unsigned int GetLastMoved() const { return m_uiLastMoved; }
+
+private:
+	GUIContainer( const eGUIContainerType eType, GUIAnimation* pHost );
+	~GUIContainer();
+
+	struct Item
+	{
+		Item() : m_pAnim(0), m_fX(0.f), m_fY(0.f), m_fW(0.f), m_fH(0.f), m_bPlaced(false) {}
+
+		GUIAnimation* m_pAnim;
+		float m_fX, m_fY; // Offset from the host top left corner
+		float m_fW, m_fH; // Size used for the placement
+		bool m_bPlaced;
+	};
+
+	unsigned int ResolveColumns( const float fCellWidth ) const;
+	void OnHostDestroyed() { m_pHost = 0; MarkDirty(); }
+	// Only the columns of a wrap grid fitting the host width depend on its size
+	void OnHostResized() { if ( m_eType == GCT_WRAP_GRID && m_uiColumns == 0 ) m_bHostResized = true; }
+
+	eGUIContainerType m_eType;
+	GUIAnimation* m_pHost;
+	DynArray_cl<Item> m_aItems;
+	unsigned int m_uiNumItems;
+	unsigned int m_uiFirstDirty; // Items from this index need relayout
+	bool m_bRemovedTail; // Content size changed without items to relayout
+	bool m_bHostResized; // Grid columns to resolve again
+
+	float m_fSpacingX, m_fSpacingY;
+	float m_fPaddingLeft, m_fPaddingTop;
+	unsigned int m_uiColumns;
+	unsigned int m_uiResolvedColumns; // Grid columns used by the last relayout
+	float m_fCellWidth, m_fCellHeight;
+	float m_fContentWidth, m_fContentHeight;
+	unsigned int m_uiLastVisited;
+	unsigned int m_uiLastMoved;
+};
+
+
+#endif // GUICONTAINER_H_INCLUDED
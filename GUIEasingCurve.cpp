@@ -0,0 +1,197 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIEasingCurve.h"
+
+
+#define BEZIER_SOLVE_ITERATIONS 24
+
+
+GUIEasingCurve* GUIEasingCurve::s_apCurves[GUI_MAX_EASING_CURVES] = { 0 };
+pfEase GUIEasingCurve::s_apfSlots[GUI_MAX_EASING_CURVES] = { 0 };
+unsigned int GUIEasingCurve::s_auiGenerations[GUI_MAX_EASING_CURVES] = { 0 };
+bool GUIEasingCurve::s_bSlotsFilled = false;
+
+
+/*
+	Instantiates one trampoline per slot: s_apfSlots[i] = &EvalSlot<i>
+*/
+template<int N> struct GUIEasingCurveSlots
+{
+	static void Fill( pfEase* apfSlots )
+	{
+		apfSlots[N - 1] = &GUIEasingCurve::EvalSlot<N - 1>;
+		GUIEasingCurveSlots<N - 1>::Fill( apfSlots );
+	}
+};
+
+template<> struct GUIEasingCurveSlots<0>
+{
+	static void Fill( pfEase* ) {}
+};
+
+
+GUIEasingCurve::GUIEasingCurve( const int iSlot )
+{
+	m_iSlot = iSlot;
+	for ( int i = 0; i <= GUI_EASING_CURVE_SAMPLES; i++ )
+		m_afTable[i] = static_cast<float>(i) / GUI_EASING_CURVE_SAMPLES;
+}
+
+int GUIEasingCurve::FindFreeSlot()
+{
+	if ( !s_bSlotsFilled )
+	{
+		GUIEasingCurveSlots<GUI_MAX_EASING_CURVES>::Fill( s_apfSlots );
+		s_bSlotsFilled = true;
+	}
+	for ( int i = 0; i < GUI_MAX_EASING_CURVES; i++ )
+		if ( !s_apCurves[i] ) return i;
+	return -1;
+}
+
+GUIEasingCurve* GUIEasingCurve::CreateCubicBezier( const float fX1, const float fY1, const float fX2, const float fY2 )
+{
+	const int iSlot = FindFreeSlot();
+	if ( iSlot < 0 ) return 0;
+
+	GUIEasingCurve* pCurve = new GUIEasingCurve( iSlot );
+	pCurve->SolveCubicBezier( hkvMath::clamp( fX1, 0.f, 1.f ), fY1, hkvMath::clamp( fX2, 0.f, 1.f ), fY2 );
+	s_apCurves[iSlot] = pCurve;
+	return pCurve;
+}
+
+GUIEasingCurve* GUIEasingCurve::CreatePiecewise( const hkvVec2* pKeys, const unsigned int uiNumKeys, const bool bSmooth )
+{
+	VASSERT( pKeys && uiNumKeys > 0 );
+	const int iSlot = FindFreeSlot();
+	if ( iSlot < 0 ) return 0;
+
+	GUIEasingCurve* pCurve = new GUIEasingCurve( iSlot );
+	pCurve->SolvePiecewise( pKeys, uiNumKeys, bSmooth );
+	s_apCurves[iSlot] = pCurve;
+	return pCurve;
+}
+
+void GUIEasingCurve::Destroy( GUIEasingCurve* pCurve )
+{
+	if ( !pCurve ) return;
+	s_apCurves[ pCurve->m_iSlot ] = 0;
+	s_auiGenerations[ pCurve->m_iSlot ]++;
+	delete pCurve;
+}
+
+pfEase GUIEasingCurve::GetEase() const
+{
+	return s_apfSlots[m_iSlot];
+}
+
+unsigned int GUIEasingCurve::GetEaseToken( const pfEase pfEaseMethod )
+{
+	if ( !s_bSlotsFilled || !pfEaseMethod ) return 0;
+	for ( int i = 0; i < GUI_MAX_EASING_CURVES; i++ )
+		if ( s_apfSlots[i] == pfEaseMethod ) return ( s_auiGenerations[i] << 8 ) | static_cast<unsigned int>( i + 1 );
+	return 0;
+}
+
+bool GUIEasingCurve::IsTokenValid( const unsigned int uiToken )
+{
+	const int iSlot = static_cast<int>( uiToken & 0xFF ) - 1;
+	if ( iSlot < 0 || iSlot >= GUI_MAX_EASING_CURVES ) return false;
+	return s_apCurves[iSlot] && s_auiGenerations[iSlot] == ( uiToken >> 8 );
+}
+
+float GUIEasingCurve::Evaluate( const float fT ) const
+{
+	const float fPos = hkvMath::clamp( fT, 0.f, 1.f ) * GUI_EASING_CURVE_SAMPLES;
+	const int iSample = hkvMath::Min( static_cast<int>(fPos), GUI_EASING_CURVE_SAMPLES - 1 );
+	return hkvMath::interpolate( m_afTable[iSample], m_afTable[iSample + 1], fPos - iSample );
+}
+
+/*
+	x(t) is monotonic for control x values in 0..1, so each sample is found by bisection once here instead of
+	Newton iterations every frame
+*/
+void GUIEasingCurve::SolveCubicBezier( const float fX1, const float fY1, const float fX2, const float fY2 )
+{
+	for ( int i = 0; i <= GUI_EASING_CURVE_SAMPLES; i++ )
+	{
+		const float fX = static_cast<float>(i) / GUI_EASING_CURVE_SAMPLES;
+		float fLow = 0.f, fHigh = 1.f, fT = fX;
+		for ( int j = 0; j < BEZIER_SOLVE_ITERATIONS; j++ )
+		{
+			const float fInv = 1.f - fT;
+			const float fCurrentX = 3.f * fInv * fInv * fT * fX1 + 3.f * fInv * fT * fT * fX2 + fT * fT * fT;
+			if ( fCurrentX < fX ) fLow = fT;
+			else fHigh = fT;
+			fT = 0.5f * ( fLow + fHigh );
+		}
+		const float fInv = 1.f - fT;
+		m_afTable[i] = 3.f * fInv * fInv * fT * fY1 + 3.f * fInv * fT * fT * fY2 + fT * fT * fT;
+	}
+	// Exact ends
+	m_afTable[0] = 0.f;
+	m_afTable[GUI_EASING_CURVE_SAMPLES] = 1.f;
+}
+
+/*
+	Smooth tangents follow Fritsch-Carlson, limited so each segment stays monotonic
+*/
+void GUIEasingCurve::SolvePiecewise( const hkvVec2* pKeys, const unsigned int uiNumKeys, const bool bSmooth )
+{
+	DynArray_cl<float> aTangents( uiNumKeys, 0.f );
+	if ( bSmooth && uiNumKeys > 1 )
+	{
+		for ( unsigned int k = 0; k < uiNumKeys; k++ )
+		{
+			const float fSlopeIn = ( k > 0 && pKeys[k].x > pKeys[k - 1].x ) ? ( pKeys[k].y - pKeys[k - 1].y ) / ( pKeys[k].x - pKeys[k - 1].x ) : 0.f;
+			const float fSlopeOut = ( k + 1 < uiNumKeys && pKeys[k + 1].x > pKeys[k].x ) ? ( pKeys[k + 1].y - pKeys[k].y ) / ( pKeys[k + 1].x - pKeys[k].x ) : 0.f;
+			if ( k == 0 ) aTangents[k] = fSlopeOut;
+			else if ( k + 1 == uiNumKeys ) aTangents[k] = fSlopeIn;
+			else aTangents[k] = ( fSlopeIn * fSlopeOut > 0.f ) ? 0.5f * ( fSlopeIn + fSlopeOut ) : 0.f;
+		}
+		for ( unsigned int k = 0; k + 1 < uiNumKeys; k++ )
+		{
+			const float fWidth = pKeys[k + 1].x - pKeys[k].x;
+			if ( fWidth <= 0.f ) continue;
+			const float fSlope = ( pKeys[k + 1].y - pKeys[k].y ) / fWidth;
+			if ( fSlope == 0.f )
+			{
+				aTangents[k] = 0.f;
+				aTangents[k + 1] = 0.f;
+				continue;
+			}
+			const float fA = aTangents[k] / fSlope;
+			const float fB = aTangents[k + 1] / fSlope;
+			const float fLength = fA * fA + fB * fB;
+			if ( fLength > 9.f )
+			{
+				const float fTau = 3.f / hkvMath::sqrt( fLength );
+				aTangents[k] = fTau * fA * fSlope;
+				aTangents[k + 1] = fTau * fB * fSlope;
+			}
+		}
+	}
+
+	unsigned int uiKey = 0;
+	for ( int i = 0; i <= GUI_EASING_CURVE_SAMPLES; i++ )
+	{
+		const float fX = static_cast<float>(i) / GUI_EASING_CURVE_SAMPLES;
+		while ( uiKey + 1 < uiNumKeys && pKeys[uiKey + 1].x <= fX ) uiKey++;
+
+		if ( fX <= pKeys[0].x ) { m_afTable[i] = pKeys[0].y; continue; }
+		if ( uiKey + 1 >= uiNumKeys ) { m_afTable[i] = pKeys[uiNumKeys - 1].y; continue; }
+
+		const hkvVec2& v2Key0 = pKeys[uiKey];
+		const hkvVec2& v2Key1 = pKeys[uiKey + 1];
+		const float fWidth = v2Key1.x - v2Key0.x;
+		const float fU = ( fWidth > 0.f ) ? ( fX - v2Key0.x ) / fWidth : 1.f;
+		if ( !bSmooth )
+		{
+			m_afTable[i] = hkvMath::interpolate( v2Key0.y, v2Key1.y, fU );
+			continue;
+		}
+		// Cubic Hermite
+		const float fU2 = fU * fU, fU3 = fU2 * fU;
+		m_afTable[i] = ( 2.f * fU3 - 3.f * fU2 + 1.f ) * v2Key0.y + ( fU3 - 2.f * fU2 + fU ) * fWidth * aTangents[uiKey]
+			+ ( -2.f * fU3 + 3.f * fU2 ) * v2Key1.y + ( fU3 - fU2 ) * fWidth * aTangents[uiKey + 1];
+	}
+}
@@ -0,0 +1,59 @@
+#ifndef GUIEASINGCURVE_H_INCLUDED
+#define GUIEASINGCURVE_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+
+
+#define GUI_MAX_EASING_CURVES 32 // At most 255, ease tokens keep the slot in their low byte
+#define GUI_EASING_CURVE_SAMPLES 256
+
+
+/*
+	Designer easing curve (CSS cubic-bezier or keyframes) solved into a lookup table when created, so evaluating
+	it is a table lookup and a lerp. Each curve is bound to one of GUI_MAX_EASING_CURVES static trampolines,
+	GetEase returns it as a plain pfEase usable with any tween or timeline step.
+	Tweens and timeline tracks keep an ease token with the ease: once the curve is destroyed, or its slot is reused by
+	another curve, they fall back to linear instead of following the new curve.
+*/
+class GUIEasingCurve
+{
+public:
+	// Same meaning as CSS cubic-bezier(x1, y1, x2, y2), x values are clamped to 0..1. Null if no free slot
+	static GUIEasingCurve* CreateCubicBezier( const float fX1, const float fY1, const float fX2, const float fY2 );
+	// Keyframes (x = time, y = value) sorted by time, the curve is extended flat before the first and after the
+	// last one. Smooth curves use monotone cubic interpolation (no overshoot between keys). Null if no free slot
+	static GUIEasingCurve* CreatePiecewise( const hkvVec2* pKeys, const unsigned int uiNumKeys, const bool bSmooth = false );
+	static void Destroy( GUIEasingCurve* pCurve );
+
+	pfEase GetEase() const;
+	// Curve slot and generation behind an ease, 0 if it is not a curve ease
+	static unsigned int GetEaseToken( const pfEase pfEaseMethod );
+	// Ease to call now for an ease kept with its token: linear once its curve is gone
+	static pfEase Resolve( const pfEase pfEaseMethod, const unsigned int uiToken ) { return ( uiToken != 0 && !IsTokenValid( uiToken ) ) ? &Easing::Linear::EaseIn : pfEaseMethod; }
+	static bool IsTokenValid( const unsigned int uiToken );
+	float Evaluate( const float fT ) const;
+
+private:
+	GUIEasingCurve( const int iSlot );
+	~GUIEasingCurve() {}
+
+	void SolveCubicBezier( const float fX1, const float fY1, const float fX2, const float fY2 );
+	void SolvePiecewise( const hkvVec2* pKeys, const unsigned int uiNumKeys, const bool bSmooth );
+
+	// Empty slot evaluates as linear
+	template<int N> static float EvalSlot( const float fT ) { return s_apCurves[N] ? s_apCurves[N]->Evaluate( fT ) : fT; }
+	template<int N> friend struct GUIEasingCurveSlots;
+	static int FindFreeSlot();
+
+	int m_iSlot;
+	float m_afTable[GUI_EASING_CURVE_SAMPLES + 1]; // Values at x = i / GUI_EASING_CURVE_SAMPLES
+
+	static GUIEasingCurve* s_apCurves[GUI_MAX_EASING_CURVES];
+	static pfEase s_apfSlots[GUI_MAX_EASING_CURVES];
+	static unsigned int s_auiGenerations[GUI_MAX_EASING_CURVES]; // Incremented when the slot is emptied
+	static bool s_bSlotsFilled;
+};
+
+
+#endif // GUIEASINGCURVE_H_INCLUDED
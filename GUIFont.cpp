@@ -0,0 +1,134 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIFont.h"
+#include "GUIAnimationManager.h"
+
+
+#define MAX_BMFONT_LINE 512
+
+
+namespace
+{
+	// Value of " key=" in a BMFont line
+	bool ReadField( const char* pcLine, const char* pcKey, float& fValue )
+	{
+		const std::string sPattern = std::string( " " ) + pcKey + "=";
+		const char* pcField = strstr( pcLine, sPattern.c_str() );
+		if ( !pcField ) return false;
+		fValue = static_cast<float>(atof( pcField + sPattern.size() ));
+		return true;
+	}
+
+	bool ReadQuotedField( const char* pcLine, const char* pcKey, std::string& sValue )
+	{
+		const std::string sPattern = std::string( " " ) + pcKey + "=\"";
+		const char* pcField = strstr( pcLine, sPattern.c_str() );
+		if ( !pcField ) return false;
+		pcField += sPattern.size();
+		const char* pcEnd = strchr( pcField, '"' );
+		if ( !pcEnd ) return false;
+		sValue.assign( pcField, pcEnd - pcField );
+		return true;
+	}
+
+	bool StartsWith( const char* pcLine, const char* pcTag )
+	{
+		return strncmp( pcLine, pcTag, strlen( pcTag ) ) == 0;
+	}
+}
+
+
+GUIFont::GUIFont()
+{
+	m_fLineHeight = 0.f;
+	m_bAtlas = false;
+}
+
+/*
+	Text format: "common lineHeight=", "page id=0 file=" and one "char id= x= y= width= height= xoffset= yoffset= xadvance="
+	line per glyph. Only the first page is used, glyphs of other pages are skipped
+*/
+bool GUIFont::LoadBMFont( const char* pcContent )
+{
+	m_bAtlas = false;
+	m_sTextureFile.clear();
+
+	char pcLine[MAX_BMFONT_LINE];
+	const char* pcCursor = pcContent;
+	while ( pcCursor && *pcCursor )
+	{
+		// Copy the line, with a leading space so every field is " key="
+		const char* pcEnd = strchr( pcCursor, '\n' );
+		const size_t uiLength = pcEnd ? static_cast<size_t>( pcEnd - pcCursor ) : strlen( pcCursor );
+		const size_t uiCopy = hkvMath::Min( uiLength, static_cast<size_t>( MAX_BMFONT_LINE - 2 ) );
+		pcLine[0] = ' ';
+		memcpy( pcLine + 1, pcCursor, uiCopy );
+		pcLine[uiCopy + 1] = '\0';
+		pcCursor = pcEnd ? pcEnd + 1 : 0;
+
+		const char* pcTag = pcLine + 1;
+		if ( StartsWith( pcTag, "common " ) )
+		{
+			ReadField( pcLine, "lineHeight", m_fLineHeight );
+		}
+		else if ( StartsWith( pcTag, "page " ) )
+		{
+			float fPage = -1.f;
+			if ( ReadField( pcLine, "id", fPage ) && fPage == 0.f ) ReadQuotedField( pcLine, "file", m_sTextureFile );
+		}
+		else if ( StartsWith( pcTag, "char " ) )
+		{
+			float fID = -1.f, fPage = 0.f;
+			if ( !ReadField( pcLine, "id", fID ) || fID < 0.f || fID >= GUI_FONT_NUM_GLYPHS ) continue;
+			ReadField( pcLine, "page", fPage );
+			if ( fPage != 0.f ) continue;
+
+			Glyph& tGlyph = m_atGlyphs[ static_cast<int>(fID) ];
+			ReadField( pcLine, "x", tGlyph.m_fX );
+			ReadField( pcLine, "y", tGlyph.m_fY );
+			ReadField( pcLine, "width", tGlyph.m_fW );
+			ReadField( pcLine, "height", tGlyph.m_fH );
+			ReadField( pcLine, "xoffset", tGlyph.m_fOffsetX );
+			ReadField( pcLine, "yoffset", tGlyph.m_fOffsetY );
+			ReadField( pcLine, "xadvance", tGlyph.m_fAdvance );
+			tGlyph.m_bValid = true;
+		}
+	}
+	return !m_sTextureFile.empty();
+}
+
+/*
+	Glyphs are placed on the top of the line and advance by their width. A missing space advances half the widest glyph
+*/
+bool GUIFont::LoadFromAtlas( const GUIAtlasHandle hAtlas, const std::string& sGlyphPrefix, const char* pcCharset )
+{
+	m_bAtlas = true;
+	m_sTextureFile.clear();
+	m_fLineHeight = 0.f;
+
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	// Glyphs are kept in layout pixels whatever the tier loaded
+	const float fTexelScale = tManager.GetTexelScale();
+	float fMaxWidth = 0.f;
+	for ( const char* pcChar = pcCharset; *pcChar; pcChar++ )
+	{
+		const std::string sFrame = sGlyphPrefix + *pcChar + ".png";
+		const GUIAnimation::FrameRect* pFrame = tManager.FindFrame( hAtlas, sFrame );
+		if ( !pFrame ) continue;
+		const GUIAnimation::FrameRect& tFrame = *pFrame;
+
+		Glyph& tGlyph = m_atGlyphs[ static_cast<unsigned char>(*pcChar) ];
+		tGlyph.m_fX = tFrame.m_fX / fTexelScale;
+		tGlyph.m_fY = tFrame.m_fY / fTexelScale;
+		tGlyph.m_fW = tFrame.m_fW / fTexelScale;
+		tGlyph.m_fH = tFrame.m_fH / fTexelScale;
+		tGlyph.m_fAdvance = tGlyph.m_fW;
+		tGlyph.m_bValid = true;
+		if ( m_sTextureFile.empty() ) m_sTextureFile = sFrame;
+		m_fLineHeight = hkvMath::Max( m_fLineHeight, tGlyph.m_fH );
+		fMaxWidth = hkvMath::Max( fMaxWidth, tGlyph.m_fW );
+	}
+
+	Glyph& tSpace = m_atGlyphs[ static_cast<unsigned char>(' ') ];
+	if ( !tSpace.m_bValid ) tSpace.m_fAdvance = fMaxWidth / 2.f;
+	return !m_sTextureFile.empty();
+}
@@ -0,0 +1,53 @@
+#ifndef GUIFONT_H_INCLUDED
+#define GUIFONT_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include <string>
+
+
+#define GUI_FONT_NUM_GLYPHS 256
+
+
+/*
+	Glyph metrics of a bitmap font, in texels of the font texture. Read from a BMFont text file (single page) or
+	from the frames of a loaded TexturePacker atlas named <prefix><char>.png (e.g. score_0.png .. score_9.png).
+	Loaded and cached by GUIAnimationManager.
+*/
+class GUIFont
+{
+public:
+	struct Glyph
+	{
+		Glyph() : m_fX(0.f), m_fY(0.f), m_fW(0.f), m_fH(0.f), m_fOffsetX(0.f), m_fOffsetY(0.f), m_fAdvance(0.f), m_bValid(false) {}
+
+		float m_fX, m_fY, m_fW, m_fH; // Rect in the texture
+		float m_fOffsetX, m_fOffsetY; // From the pen position to the glyph top left corner
+		float m_fAdvance;
+		bool m_bValid;
+	};
+
+	GUIFont();
+
+	bool LoadBMFont( const char* pcContent );
+	// Atlas frames must be loaded (GUIAnimationManager::LoadAtlas), any loaded atlas with GUI_INVALID_ATLAS
+	bool LoadFromAtlas( const GUIAtlasHandle hAtlas, const std::string& sGlyphPrefix, const char* pcCharset );
+
+	const Glyph& GetGlyph( const unsigned char ucChar ) const { return m_atGlyphs[ucChar]; }
+	float GetLineHeight() const { return m_fLineHeight; }
+	// Standalone texture (BMFont page) or atlas holding the glyphs
+	bool IsAtlasFont() const { return m_bAtlas; }
+	const std::string& GetTextureFile() const { return m_sTextureFile; }
+	void SetTexturePath( const std::string& sPath ) { m_sTexturePath = sPath; }
+	const std::string& GetTexturePath() const { return m_sTexturePath; }
+
+private:
+	Glyph m_atGlyphs[GUI_FONT_NUM_GLYPHS];
+	float m_fLineHeight;
+	bool m_bAtlas;
+	std::string m_sTexturePath; // Atlas path without extension, or folder of the BMFont page
+	std::string m_sTextureFile; // BMFont page, or first glyph frame of the atlas
+};
+
+
+#endif // GUIFONT_H_INCLUDED
@@ -0,0 +1,187 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIHotReload.h"
+#include "GUIAnimationManager.h"
+#include "GUILayout.h"
+#include "../CutshumotoPlugin/CutshumotoUtilities.h"
+
+
+#define GUI_HOT_RELOAD_READ_CHUNK 4096
+
+
+GUIHotReload::GUIHotReload()
+{
+	m_bEnabled = false;
+	m_fPollInterval = GUI_HOT_RELOAD_DEFAULT_INTERVAL;
+	m_fTimeToPoll = 0.f;
+	m_aLayouts.Init(0);
+	m_uiNumLayouts = 0;
+	m_tStats.Init();
+}
+
+/*
+	Enabling records the current content of every watched file, only later changes are reloaded
+*/
+void GUIHotReload::SetEnabled( const bool bEnabled, const float fPollInterval )
+{
+	m_fPollInterval = hkvMath::Max( fPollInterval, 0.f );
+	if ( m_bEnabled == bEnabled ) return;
+	m_bEnabled = bEnabled;
+	m_hFiles.clear();
+	m_fTimeToPoll = m_fPollInterval;
+	if ( m_bEnabled ) Poll();
+}
+
+void GUIHotReload::AddLayout( GUILayout* pLayout )
+{
+	if ( !pLayout ) return;
+	for ( unsigned int i = 0; i < m_uiNumLayouts; i++ )
+		if ( m_aLayouts[i] == pLayout ) return;
+	m_aLayouts[ m_uiNumLayouts++ ] = pLayout;
+}
+
+void GUIHotReload::RemoveLayout( GUILayout* pLayout )
+{
+	unsigned int uiNumKept = 0;
+	for ( unsigned int i = 0; i < m_uiNumLayouts; i++ )
+		if ( m_aLayouts[i] != pLayout ) m_aLayouts[ uiNumKept++ ] = m_aLayouts[i];
+	m_uiNumLayouts = uiNumKept;
+}
+
+void GUIHotReload::Update( const float fRealDeltaTime )
+{
+	if ( !m_bEnabled ) return;
+	m_fTimeToPoll -= fRealDeltaTime;
+	if ( m_fTimeToPoll > 0.f ) return;
+	m_fTimeToPoll = m_fPollInterval;
+	Poll();
+}
+
+void GUIHotReload::Poll()
+{
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	m_tStats.m_uiNumPolls++;
+	char pcFileContent[MAX_TPJSONFILE_SIZE];
+
+	// Atlas JSONs of the tier each atlas is loaded at, elements patched once after all of them
+	bool bFramesChanged = false;
+	DynArray_cl<GUIAtlasHandle> aAtlases( 0 );
+	const unsigned int uiNumAtlases = tManager.GetAtlasHandles( aAtlases );
+	for ( unsigned int i = 0; i < uiNumAtlases; i++ )
+	{
+		std::string sName, sPath;
+		tManager.GetAtlasSource( aAtlases[i], sName, sPath );
+		const std::string sFilename = sName + GUIAnimationManager::GetTierExtension( tManager.GetAtlasTier( aAtlases[i] ) ) + ".json";
+		const std::string sKey = sPath + sFilename;
+		FileStamp tStamp;
+		if ( !ReadStamp( sKey.c_str(), tStamp ) || IsUnchanged( sKey, tStamp ) ) continue;
+		if ( !CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() ) ) continue;
+		const unsigned int uiHash = HashString( pcFileContent );
+		if ( !HasChanged( sKey, tStamp, uiHash ) ) continue;
+		if ( tManager.LoadAtlas( sName, sPath ) == GUI_INVALID_ATLAS ) continue;
+		Commit( sKey, tStamp, uiHash );
+		m_tStats.m_uiNumAtlasReloads++;
+		bFramesChanged = true;
+	}
+	if ( bFramesChanged ) m_tStats.m_uiNumPatchedElements += tManager.ReloadAtlasFrames();
+
+	// Textures in use, evicted ones are read from the file when needed anyway
+	const std::map< const VTextureObject*, GUITextureCache::Entry >& hTextures = tManager.GetTextureCache().GetEntries();
+	for ( std::map< const VTextureObject*, GUITextureCache::Entry >::const_iterator it = hTextures.begin(); it != hTextures.end(); ++it )
+	{
+		if ( !it->second.m_bResident ) continue;
+		const char* pcFilename = it->second.m_spTexture->GetFilename();
+		FileStamp tStamp;
+		if ( !ReadStamp( pcFilename, tStamp ) || IsUnchanged( pcFilename, tStamp ) ) continue;
+		bool bRead = false;
+		const unsigned int uiHash = HashFile( pcFilename, bRead );
+		if ( !bRead || !HasChanged( pcFilename, tStamp, uiHash ) ) continue;
+		if ( !it->second.m_spTexture->Reload() ) continue;
+		Commit( pcFilename, tStamp, uiHash );
+		m_tStats.m_uiNumTextureReloads++;
+	}
+
+	for ( unsigned int i = 0; i < m_uiNumLayouts; i++ )
+	{
+		GUILayout* pLayout = m_aLayouts[i];
+		if ( pLayout->GetFilename().empty() ) continue; // Loaded from memory
+		const std::string sKey = pLayout->GetPath() + pLayout->GetFilename();
+		FileStamp tStamp;
+		if ( !ReadStamp( sKey.c_str(), tStamp ) || IsUnchanged( sKey, tStamp ) ) continue;
+		if ( !CutshumotoUtilities::ReadFile( pcFileContent, pLayout->GetFilename().c_str(), pLayout->GetPath().c_str() ) ) continue;
+		const unsigned int uiHash = HashString( pcFileContent );
+		if ( !HasChanged( sKey, tStamp, uiHash ) ) continue;
+		bool bRebuilt = false;
+		if ( !pLayout->Reload( pcFileContent, bRebuilt ) ) continue;
+		Commit( sKey, tStamp, uiHash );
+		m_tStats.m_uiNumLayoutReloads++;
+		if ( bRebuilt ) m_tStats.m_uiNumLayoutRebuilds++;
+	}
+}
+
+bool GUIHotReload::ReadStamp( const char* pcFilepath, FileStamp& tStamp )
+{
+	if ( !pcFilepath || !*pcFilepath ) return false;
+	IVFileInStream* pIn = Vision::File.Open( pcFilepath );
+	if ( !pIn ) return false;
+	tStamp.m_iSize = pIn->GetSize();
+	tStamp.m_bHasTime = pIn->GetTimeStamp( tStamp.m_tTime ) != 0;
+	pIn->Close();
+	return true;
+}
+
+bool GUIHotReload::IsUnchanged( const std::string& sKey, const FileStamp& tStamp ) const
+{
+	std::map< std::string, WatchedFile >::const_iterator it = m_hFiles.find( sKey );
+	if ( it == m_hFiles.end() || !tStamp.m_bHasTime || !it->second.m_tStamp.m_bHasTime ) return false;
+	return it->second.m_tStamp.m_iSize == tStamp.m_iSize && it->second.m_tStamp.m_tTime == tStamp.m_tTime;
+}
+
+/*
+	Nothing is kept for a change: it is reported again until Commit, so a reload that failed is retried
+*/
+bool GUIHotReload::HasChanged( const std::string& sKey, const FileStamp& tStamp, const unsigned int uiHash )
+{
+	std::map< std::string, WatchedFile >::iterator it = m_hFiles.find( sKey );
+	if ( it == m_hFiles.end() )
+	{
+		Commit( sKey, tStamp, uiHash );
+		return false;
+	}
+	if ( it->second.m_uiHash != uiHash ) return true;
+	it->second.m_tStamp = tStamp; // Touched, same content
+	return false;
+}
+
+void GUIHotReload::Commit( const std::string& sKey, const FileStamp& tStamp, const unsigned int uiHash )
+{
+	WatchedFile& tFile = m_hFiles[sKey];
+	tFile.m_tStamp = tStamp;
+	tFile.m_uiHash = uiHash;
+}
+
+unsigned int GUIHotReload::HashFile( const char* pcFilepath, bool& bRead )
+{
+	bRead = false;
+	unsigned int uiHash = GUI_FNV_OFFSET_BASIS;
+	if ( !pcFilepath || !*pcFilepath ) return uiHash;
+	IVFileInStream* pIn = Vision::File.Open( pcFilepath );
+	if ( !pIn ) return uiHash;
+
+	unsigned char aucChunk[GUI_HOT_RELOAD_READ_CHUNK];
+	size_t uiRead = 0;
+	while ( ( uiRead = pIn->Read( aucChunk, GUI_HOT_RELOAD_READ_CHUNK ) ) > 0 )
+	{
+		for ( size_t i = 0; i < uiRead; i++ )
+			uiHash = ( uiHash ^ aucChunk[i] ) * GUI_FNV_PRIME;
+	}
+	pIn->Close();
+	bRead = true;
+	return uiHash;
+}
+
+unsigned int GUIHotReload::HashString( const char* pcContent, unsigned int uiHash )
+{
+	for ( const unsigned char* pucChar = reinterpret_cast<const unsigned char*>(pcContent); *pucChar; pucChar++ )
+		uiHash = ( uiHash ^ *pucChar ) * GUI_FNV_PRIME;
+	return uiHash;
+}
@@ -0,0 +1,94 @@
+#ifndef GUIHOTRELOAD_H_INCLUDED
+#define GUIHOTRELOAD_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include <string>
+#include <map>
+
+
+#define GUI_HOT_RELOAD_DEFAULT_INTERVAL 1.f // Seconds of real time between two polls
+#define GUI_FNV_OFFSET_BASIS 2166136261u
+#define GUI_FNV_PRIME 16777619u
+
+
+class GUILayout;
+
+
+/*
+	Development mode reloading UI content while the app runs. Loaded atlas JSONs, the textures used by the elements and
+	the layouts added here are polled on the real clock through the engine file system, so packaged and device data
+	directories work the same. Size and modification time are checked first, the content is only read and hashed when one
+	of them differs. A new hash is kept once the file is reloaded, a failed reload (e.g. file still being written) is
+	retried on the next poll. Changes are applied in place:
+	- atlas JSON: frames reloaded, elements whose frame rects differ are patched (size follows, scale kept)
+	- texture: the engine resource is reloaded, every element using it draws the new texels
+	- layout: properties reapplied to the existing elements, rebuilt only if its element sources changed
+	Disabled by default, owned by GUIAnimationManager and updated at the start of its Update.
+*/
+class GUIHotReload
+{
+public:
+	struct Stats
+	{
+		unsigned int m_uiNumPolls;
+		unsigned int m_uiNumAtlasReloads;
+		unsigned int m_uiNumTextureReloads;
+		unsigned int m_uiNumLayoutReloads;
+		unsigned int m_uiNumLayoutRebuilds; // Layout reloads that recreated their elements
+		unsigned int m_uiNumPatchedElements;
+		void Init() { memset( this, 0, sizeof(Stats) ); }
+	};
+
+	GUIHotReload();
+	~GUIHotReload() { m_aLayouts.Reset(); }
+
+	void SetEnabled( const bool bEnabled, const float fPollInterval = GUI_HOT_RELOAD_DEFAULT_INTERVAL );
+	bool IsEnabled() const { return m_bEnabled; }
+	// Layouts must be removed before they are deleted
+	void AddLayout( GUILayout* pLayout );
+	void RemoveLayout( GUILayout* pLayout );
+
+	void Update( const float fRealDeltaTime );
+	// Checks every watched file now
+	void Poll();
+
+	const Stats& GetStats() const { return m_tStats; }
+
+	// FNV-1a, uiHash continues a previous hash
+	static unsigned int HashString( const char* pcContent, const unsigned int uiHash = GUI_FNV_OFFSET_BASIS );
+
+private:
+	struct FileStamp
+	{
+		long m_iSize;
+		VFileTime m_tTime;
+		bool m_bHasTime; // Not every file system reports it, the content is then hashed on each poll
+	};
+
+	struct WatchedFile
+	{
+		FileStamp m_tStamp;
+		unsigned int m_uiHash;
+	};
+
+	// False if the file can't be opened
+	static bool ReadStamp( const char* pcFilepath, FileStamp& tStamp );
+	// Same size and modification time as when the last hash was kept
+	bool IsUnchanged( const std::string& sKey, const FileStamp& tStamp ) const;
+	// Content differs from the last kept hash. First call for a file records it
+	bool HasChanged( const std::string& sKey, const FileStamp& tStamp, const unsigned int uiHash );
+	// Once the change is applied
+	void Commit( const std::string& sKey, const FileStamp& tStamp, const unsigned int uiHash );
+	static unsigned int HashFile( const char* pcFilepath, bool& bRead );
+
+	bool m_bEnabled;
+	float m_fPollInterval;
+	float m_fTimeToPoll;
+	std::map< std::string, WatchedFile > m_hFiles; // Watched file, stamp and hash of the content last applied
+	DynArray_cl<GUILayout*> m_aLayouts;
+	unsigned int m_uiNumLayouts;
+	Stats m_tStats;
+};
+
+
+#endif // GUIHOTRELOAD_H_INCLUDED
@@ -0,0 +1,78 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIJobPool.h"
+
+
+GUIJobPool::GUIJobPool()
+{
+	m_aWorkers.Init(0);
+	m_uiNumWorkers = 0;
+	m_pfJob = 0;
+	m_pUserData = 0;
+	m_uiCount = 0;
+	m_uiChunkSize = 1;
+	m_iNumChunks = 0;
+	m_iNextChunk = 0;
+}
+
+GUIJobPool::~GUIJobPool()
+{
+	ReleaseWorkers();
+}
+
+void GUIJobPool::SetNumWorkers( const unsigned int uiNumWorkers )
+{
+	ReleaseWorkers();
+	m_uiNumWorkers = uiNumWorkers;
+	for ( unsigned int i = 0; i < m_uiNumWorkers; i++ )
+		m_aWorkers[i] = new WorkerTask( this );
+}
+
+void GUIJobPool::ReleaseWorkers()
+{
+	for ( unsigned int i = 0; i < m_uiNumWorkers; i++ )
+	{
+		if ( m_aWorkers[i] ) delete m_aWorkers[i];
+		m_aWorkers[i] = 0;
+	}
+	m_aWorkers.Reset();
+	m_uiNumWorkers = 0;
+}
+
+void GUIJobPool::ParallelFor( const unsigned int uiCount, const unsigned int uiChunkSize, const pfGUIJobRange pfJob, void* pUserData )
+{
+	if ( uiCount == 0 ) return;
+
+	m_pfJob = pfJob;
+	m_pUserData = pUserData;
+	m_uiCount = uiCount;
+	m_uiChunkSize = ( uiChunkSize > 0 ) ? uiChunkSize : 1;
+	m_iNumChunks = static_cast<int>( ( uiCount + m_uiChunkSize - 1 ) / m_uiChunkSize );
+	m_iNextChunk = 0;
+
+	// Not worth waking workers for a single chunk
+	const unsigned int uiNumWorkers = hkvMath::Min( m_uiNumWorkers, static_cast<unsigned int>(m_iNumChunks - 1) );
+	for ( unsigned int i = 0; i < uiNumWorkers; i++ )
+		Vision::GetThreadManager()->ScheduleTask( m_aWorkers[i] );
+
+	// The calling thread takes chunks too
+	ProcessChunks();
+
+	for ( unsigned int i = 0; i < uiNumWorkers; i++ )
+		Vision::GetThreadManager()->WaitForTask( m_aWorkers[i], true );
+
+	m_pfJob = 0;
+	m_pUserData = 0;
+}
+
+void GUIJobPool::ProcessChunks()
+{
+	for ( ;; )
+	{
+		const int iChunk = VAtomic::Increment( m_iNextChunk ) - 1;
+		if ( iChunk >= m_iNumChunks ) break;
+
+		const unsigned int uiBegin = static_cast<unsigned int>(iChunk) * m_uiChunkSize;
+		const unsigned int uiEnd = hkvMath::Min( uiBegin + m_uiChunkSize, m_uiCount );
+		m_pfJob( m_pUserData, uiBegin, uiEnd );
+	}
+}
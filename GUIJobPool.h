@@ -0,0 +1,55 @@
+#ifndef GUIJOBPOOL_H_INCLUDED
+#define GUIJOBPOOL_H_INCLUDED
+
+#include "GlobalTypes.h"
+
+
+// Processes items [uiBegin, uiEnd) of a parallel loop
+typedef void (*pfGUIJobRange)( void* pUserData, const unsigned int uiBegin, const unsigned int uiEnd );
+
+
+/*
+	Parallel-for on top of the engine thread manager. The index range is split in small chunks that
+	workers (and the calling thread) claim from a shared atomic cursor, so a worker that runs out of
+	work keeps taking chunks left by slower ones. ParallelFor returns once every chunk is processed.
+	Jobs must only write data owned by the items of their chunk.
+*/
+class GUIJobPool
+{
+public:
+	GUIJobPool();
+	~GUIJobPool();
+
+	void SetNumWorkers( const unsigned int uiNumWorkers );
+	unsigned int GetNumWorkers() const { return m_uiNumWorkers; }
+
+	void ParallelFor( const unsigned int uiCount, const unsigned int uiChunkSize, const pfGUIJobRange pfJob, void* pUserData );
+
+private:
+	class WorkerTask : public VThreadedTask
+	{
+	public:
+		WorkerTask( GUIJobPool* pPool ) : m_pPool( pPool ) {}
+		virtual void Run( VManagedThread* pThread ) { m_pPool->ProcessChunks(); }
+
+	private:
+		GUIJobPool* m_pPool;
+	};
+
+	void ProcessChunks();
+	void ReleaseWorkers();
+
+	DynArray_cl<WorkerTask*> m_aWorkers;
+	unsigned int m_uiNumWorkers;
+
+	// Current loop
+	pfGUIJobRange m_pfJob;
+	void* m_pUserData;
+	unsigned int m_uiCount;
+	unsigned int m_uiChunkSize;
+	int m_iNumChunks;
+	volatile int m_iNextChunk;
+};
+
+
+#endif // GUIJOBPOOL_H_INCLUDED
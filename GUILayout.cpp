@@ -0,0 +1,236 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUILayout.h"
+#include "GUIAnimationManager.h"
+#include "GUIHotReload.h"
+#include "../CutshumotoPlugin/CutshumotoUtilities.h"
+#include <ctime>
+
+
+namespace
+{
+	const char* GetString( const rapidjson::Value& element, const char* pcMember, const char* pcDefault )
+	{
+		return ( element.HasMember( pcMember ) && element[pcMember].IsString() ) ? element[pcMember].GetString() : pcDefault;
+	}
+
+	int GetInt( const rapidjson::Value& element, const char* pcMember, const int iDefault )
+	{
+		return ( element.HasMember( pcMember ) && element[pcMember].IsNumber() ) ? static_cast<int>(element[pcMember].GetDouble()) : iDefault;
+	}
+
+	bool GetBool( const rapidjson::Value& element, const char* pcMember, const bool bDefault )
+	{
+		return ( element.HasMember( pcMember ) && element[pcMember].IsBool() ) ? element[pcMember].GetBool() : bDefault;
+	}
+
+	GUIAnimation::eGUIAnimType GetAnimType( const char* pcType )
+	{
+		if ( strcmp( pcType, "loop" ) == 0 ) return GUIAnimation::GAT_LOOP;
+		if ( strcmp( pcType, "ping_pong" ) == 0 ) return GUIAnimation::GAT_PING_PONG;
+		if ( strcmp( pcType, "none" ) == 0 ) return GUIAnimation::GAT_NONE;
+		return GUIAnimation::GAT_ONCE;
+	}
+
+	// Offsets are (from top/bottom, from left/right) like the PositionFrom functions
+	void ApplyAnchor( GUIAnimation* pAnim, const char* pcAnchor, const float fX, const float fY )
+	{
+		if ( strcmp( pcAnchor, "top_left" ) == 0 ) pAnim->PositionFromTopLeft( fY, fX );
+		else if ( strcmp( pcAnchor, "top_right" ) == 0 ) pAnim->PositionFromTopRight( fY, fX );
+		else if ( strcmp( pcAnchor, "bottom_left" ) == 0 ) pAnim->PositionFromBottomLeft( fY, fX );
+		else if ( strcmp( pcAnchor, "bottom_right" ) == 0 ) pAnim->PositionFromBottomRight( fY, fX );
+		else if ( strcmp( pcAnchor, "top" ) == 0 ) pAnim->PositionFromTop( fY, fX );
+		else if ( strcmp( pcAnchor, "bottom" ) == 0 ) pAnim->PositionFromBottom( fY, fX );
+		else if ( strcmp( pcAnchor, "left" ) == 0 ) pAnim->PositionFromLeft( fY, fX );
+		else if ( strcmp( pcAnchor, "right" ) == 0 ) pAnim->PositionFromRight( fY, fX );
+		else pAnim->PositionFromCenter( fY, fX );
+	}
+
+	bool HasSource( const rapidjson::Value& element )
+	{
+		return element.HasMember( "frame" ) || element.HasMember( "texture" );
+	}
+
+	// Anchor, offset, parent and flags. Patched elements go back to the defaults of missing placement properties
+	void ApplyProperties( const GUILayout& tLayout, GUIAnimation* pAnim, const rapidjson::Value& element, const bool bPatch )
+	{
+		if ( element.HasMember( "parent" ) ) pAnim->SetParent( tLayout.Find( GetString( element, "parent", "" ) ) );
+		else if ( bPatch ) pAnim->SetParent( 0 );
+
+		float fOffsetX = 0.f, fOffsetY = 0.f;
+		const bool bOffset = element.HasMember( "offset" ) && element["offset"].IsArray() && element["offset"].Size() >= 2;
+		if ( bOffset && element["offset"][0].IsNumber() && element["offset"][1].IsNumber() )
+		{
+			fOffsetX = static_cast<float>(element["offset"][0].GetDouble());
+			fOffsetY = static_cast<float>(element["offset"][1].GetDouble());
+		}
+		ApplyAnchor( pAnim, GetString( element, "anchor", "center" ), fOffsetX, fOffsetY );
+		if ( GetBool( element, "pixels", false ) ) pAnim->SetPositionPrecision( UIP_PIXEL );
+		else if ( bPatch ) pAnim->SetPositionPrecision( UIP_PERCENTAGE );
+
+		if ( element.HasMember( "order" ) || bPatch ) pAnim->SetOrder( GetInt( element, "order", GAO_MIDDLE ) );
+		if ( element.HasMember( "fps" ) || bPatch ) pAnim->SetFPS( GetInt( element, "fps", 24 ) );
+		// Runtime state of the game, patched only when written in the file
+		const bool bTouchable = GetBool( element, "touchable", true );
+		if ( bPatch ? element.HasMember( "touchable" ) : !bTouchable ) pAnim->SetTouchable( bTouchable );
+		const bool bVisible = GetBool( element, "visible", true );
+		if ( bPatch ? element.HasMember( "visible" ) : !bVisible ) pAnim->SetVisible( bVisible );
+	}
+
+	// What the elements are created from, a change needs them created again
+	unsigned int HashSources( const rapidjson::Value& elements, const char* pcAtlas )
+	{
+		unsigned int uiHash = GUI_FNV_OFFSET_BASIS;
+		for ( unsigned int i = 0; i < elements.Size(); i++ )
+		{
+			const rapidjson::Value& element = elements[i];
+			if ( !HasSource( element ) ) continue;
+			std::ostringstream ss;
+			ss << GetString( element, "atlas", pcAtlas ) << '|' << GetString( element, "frame", "" ) << '|' << GetString( element, "path", "" )
+				<< '|' << GetString( element, "texture", "" ) << '|' << GetInt( element, "frames", 1 ) << '|' << GetInt( element, "first", 0 )
+				<< '|' << GetInt( element, "last", -1 ) << '|' << GetInt( element, "id", 0 ) << '|' << GetString( element, "type", "once" ) << '\n';
+			uiHash = GUIHotReload::HashString( ss.str().c_str(), uiHash );
+		}
+		return uiHash;
+	}
+}
+
+
+GUILayout::GUILayout()
+{
+	m_aElements.Init(0);
+	m_aSourceIndices.Init(0);
+	m_uiNumElements = 0;
+	m_fBuildTime = 0.f;
+	m_uiSourcesHash = 0;
+	m_pArena = 0;
+}
+
+GUILayout::~GUILayout()
+{
+	m_aElements.Reset();
+	m_aSourceIndices.Reset();
+	m_hNamedElements.clear();
+}
+
+bool GUILayout::Load( const std::string& sFilename, const std::string& sPath )
+{
+	const clock_t tStart = clock();
+
+	char pcFileContent[MAX_TPJSONFILE_SIZE];
+	if ( !CutshumotoUtilities::ReadFile( pcFileContent, sFilename.c_str(), sPath.c_str() ) ) return false;
+	const bool bLoaded = LoadJSON( pcFileContent );
+	m_sFilename = sFilename;
+	m_sPath = sPath;
+
+	m_fBuildTime = static_cast<float>( clock() - tStart ) * 1000.f / CLOCKS_PER_SEC;
+	return bLoaded;
+}
+
+/*
+	Elements that fail to load are skipped, their children are attached to the screen instead. The elements of a
+	previous load are destroyed once the new content is parsed, a layout holds one tree
+*/
+bool GUILayout::LoadJSON( const char* pcContent )
+{
+	const clock_t tStart = clock();
+
+	rapidjson::Document jsonDoc;
+	jsonDoc.Parse<0>( pcContent );
+	if ( jsonDoc.HasParseError() || !jsonDoc.IsObject() || !jsonDoc.HasMember( "elements" ) ) return false;
+
+	const rapidjson::Value& elements = jsonDoc["elements"];
+	if ( !elements.IsArray() ) return false;
+	Destroy();
+	const std::string sAtlas = GetString( jsonDoc, "atlas", "" );
+	m_uiSourcesHash = HashSources( elements, sAtlas.c_str() );
+
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	tManager.BeginBuild();
+	unsigned int uiSourceIndex = 0;
+	for ( unsigned int i = 0; i < elements.Size(); i++ )
+	{
+		const rapidjson::Value& element = elements[i];
+		const eGUIAnimID eID = static_cast<eGUIAnimID>( GetInt( element, "id", 0 ) );
+		const GUIAnimation::eGUIAnimType eType = GetAnimType( GetString( element, "type", "once" ) );
+
+		GUIAnimation* pAnim = 0;
+		if ( element.HasMember( "frame" ) )
+		{ // Atlas frame(s)
+			const int iNumFrames = hkvMath::Max( GetInt( element, "frames", 1 ), 1 );
+			const int iFirstFrame = GetInt( element, "first", 0 );
+			const int iLastFrame = GetInt( element, "last", iNumFrames - 1 );
+			pAnim = tManager.CreateAnimation( GetString( element, "atlas", sAtlas.c_str() ), GetString( element, "frame", "" ), iFirstFrame, iLastFrame, iNumFrames, eID, eType, m_pArena );
+		}
+		else if ( element.HasMember( "texture" ) )
+		{ // Standalone texture
+			pAnim = tManager.CreateAnimation( GetString( element, "path", "" ), GetString( element, "texture", "" ), 0, 0, 0, eID, eType, m_pArena );
+		}
+		if ( HasSource( element ) ) uiSourceIndex++;
+		if ( !pAnim ) continue;
+
+		m_aSourceIndices[ m_uiNumElements ] = uiSourceIndex - 1;
+		m_aElements[ m_uiNumElements++ ] = pAnim;
+		if ( element.HasMember( "name" ) ) m_hNamedElements[ GetString( element, "name", "" ) ] = pAnim;
+
+		ApplyProperties( *this, pAnim, element, false );
+		if ( GetBool( element, "play", false ) ) pAnim->Play();
+	}
+	tManager.EndBuild();
+
+	m_fBuildTime = static_cast<float>( clock() - tStart ) * 1000.f / CLOCKS_PER_SEC;
+	return true;
+}
+
+/*
+	Elements are matched to the entry they were built from, by position among the entries with a source (unchanged,
+	the sources hash is the same). Entries that failed to load have no element and are skipped. Names are taken again
+*/
+bool GUILayout::Reload( const char* pcContent, bool& bRebuilt )
+{
+	bRebuilt = false;
+	rapidjson::Document jsonDoc;
+	jsonDoc.Parse<0>( pcContent );
+	if ( jsonDoc.HasParseError() || !jsonDoc.IsObject() || !jsonDoc.HasMember( "elements" ) ) return false;
+	const rapidjson::Value& elements = jsonDoc["elements"];
+	if ( !elements.IsArray() ) return false;
+
+	if ( HashSources( elements, GetString( jsonDoc, "atlas", "" ) ) != m_uiSourcesHash )
+	{ // Previous elements destroyed by the load
+		bRebuilt = true;
+		return LoadJSON( pcContent );
+	}
+
+	m_hNamedElements.clear();
+	unsigned int uiElement = 0;
+	unsigned int uiSourceIndex = 0;
+	for ( unsigned int i = 0; i < elements.Size() && uiElement < m_uiNumElements; i++ )
+	{
+		const rapidjson::Value& element = elements[i];
+		if ( !HasSource( element ) ) continue;
+		if ( m_aSourceIndices[uiElement] != uiSourceIndex++ ) continue; // Failed to load
+		GUIAnimation* pAnim = m_aElements[ uiElement++ ];
+		if ( element.HasMember( "name" ) ) m_hNamedElements[ GetString( element, "name", "" ) ] = pAnim;
+		ApplyProperties( *this, pAnim, element, true );
+	}
+	return true;
+}
+
+void GUILayout::Destroy()
+{
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	// Children first, parents are listed before them
+	for ( unsigned int i = m_uiNumElements; i > 0; i-- )
+	{
+		GUIAnimation* pAnim = m_aElements[i - 1];
+		tManager.RemoveAnimation( pAnim );
+		delete pAnim;
+	}
+	m_uiNumElements = 0;
+	m_hNamedElements.clear();
+}
+
+GUIAnimation* GUILayout::Find( const std::string& sName ) const
+{
+	std::map< std::string, GUIAnimation* >::const_iterator it = m_hNamedElements.find( sName );
+	return ( it != m_hNamedElements.end() ) ? it->second : 0;
+}
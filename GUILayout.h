@@ -0,0 +1,67 @@
+#ifndef GUILAYOUT_H_INCLUDED
+#define GUILAYOUT_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include <string>
+#include <map>
+
+
+/*
+	Screen described in a JSON file and created in one manager build (single sort, single layout pass):
+	{ "atlas": "GUI/menu",
+	  "elements": [ { "name": "panel", "path": "GUI/", "texture": "panel.png", "anchor": "center", "order": 750, "touchable": false },
+	                { "name": "play", "parent": "panel", "frame": "btn_play.png", "frames": 2, "id": 1,
+	                  "anchor": "bottom", "offset": [0, 24], "pixels": true, "order": 500 } ] }
+	Elements use either a standalone "texture" (loaded from "path") or a "frame" of the atlas (optional "frames",
+	"first", "last", "fps", "type": once/loop/ping_pong, "play"). Anchors: center, top_left, top_right, bottom_left,
+	bottom_right, top, bottom, left, right. Offsets are [x, y], relative to the parent size unless "pixels" is set.
+	Parents must be listed before their children. The layout keeps the created elements, it does not own them
+	unless Destroy is called. With an arena set (SetArena) the elements are allocated from it and, once Destroy is
+	called, released together by GUIArena::Reset (GUIAnimationManager::ReleaseArena does both, the layout is then
+	dropped without Destroy). Reload (hot reload) reapplies anchors, offsets, parents and flags to the existing elements,
+	and only recreates them when an element source ("atlas", "frame", "texture", frames, "id", "type") changed.
+*/
+class GUILayout
+{
+public:
+	GUILayout();
+	~GUILayout();
+
+	// Replaces the elements of a previous load (destroyed), kept if the content fails to parse
+	bool Load( const std::string& sFilename, const std::string& sPath );
+	bool LoadJSON( const char* pcContent );
+	// New content of the loaded file. bRebuilt: elements were destroyed and created again, pointers to them are invalid
+	bool Reload( const char* pcContent, bool& bRebuilt );
+	// Removes and deletes every element created by the layout
+	void Destroy();
+
+	GUIAnimation* Find( const std::string& sName ) const;
+	unsigned int GetNumElements() const { return m_uiNumElements; }
+	GUIAnimation* GetElement( const unsigned int uiIndex ) const { return m_aElements.GetDataPtr()[uiIndex]; }
+	// Milliseconds spent by the last load: parsing, creation and layout (CPU time)
+	float GetBuildTime() const { return m_fBuildTime; }
+	// Empty if loaded from memory
+	const std::string& GetFilename() const { return m_sFilename; }
+	const std::string& GetPath() const { return m_sPath; }
+	// Arena of the elements created by the next loads, null for the heap
+	void SetArena( GUIArena* pArena ) { m_pArena = pArena; }
+	GUIArena* GetArena() const { return m_pArena; }
+
+private:
+	GUILayout( const GUILayout& );
+	GUILayout& operator=( const GUILayout& );
+
+	DynArray_cl<GUIAnimation*> m_aElements;
+	DynArray_cl<unsigned int> m_aSourceIndices; // Per element, its position among the entries with a source (failed ones included)
+	unsigned int m_uiNumElements;
+	std::map< std::string, GUIAnimation* > m_hNamedElements;
+	float m_fBuildTime;
+	std::string m_sFilename;
+	std::string m_sPath;
+	unsigned int m_uiSourcesHash;
+	GUIArena* m_pArena;
+};
+
+
+#endif // GUILAYOUT_H_INCLUDED
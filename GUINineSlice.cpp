@@ -0,0 +1,65 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUINineSlice.h"
+#include "GUIAnimation.h"
+
+
+GUINineSlice::GUINineSlice( const float fLeft, const float fTop, const float fRight, const float fBottom )
+{
+	SetInsets( fLeft, fTop, fRight, fBottom );
+	m_bDrawCenter = true;
+}
+
+void GUINineSlice::SetInsets( const float fLeft, const float fTop, const float fRight, const float fBottom )
+{
+	m_fLeft = hkvMath::Max( fLeft, 0.f );
+	m_fTop = hkvMath::Max( fTop, 0.f );
+	m_fRight = hkvMath::Max( fRight, 0.f );
+	m_fBottom = hkvMath::Max( fBottom, 0.f );
+}
+
+void GUINineSlice::AddQuads( GUISpriteBatch& tBatch, const GUIAnimation* pAnim )
+{
+	const VisScreenMask_cl* pMask = pAnim->GetTexture();
+	VTextureObject* pTexture = pMask->GetTextureObject();
+	const float fTexW = static_cast<float>(pTexture->GetTextureWidth());
+	const float fTexH = static_cast<float>(pTexture->GetTextureHeight());
+	if ( fTexW <= 0.f || fTexH <= 0.f ) return;
+
+	float fX, fY, fW, fH;
+	pMask->GetPos( fX, fY );
+	pMask->GetTargetSize( fW, fH );
+	float fU0, fV0, fU1, fV1;
+	pMask->GetTextureRange( fU0, fV0, fU1, fV1 );
+	// Insets are layout pixels, the texture may be another tier
+	const float fTexelScale = pAnim->GetTexelScale();
+
+	// Insets can not exceed the frame
+	const float fLeft = hkvMath::Min( m_fLeft, ( fU1 - fU0 ) / fTexelScale / 2.f );
+	const float fRight = hkvMath::Min( m_fRight, ( fU1 - fU0 ) / fTexelScale / 2.f );
+	const float fTop = hkvMath::Min( m_fTop, ( fV1 - fV0 ) / fTexelScale / 2.f );
+	const float fBottom = hkvMath::Min( m_fBottom, ( fV1 - fV0 ) / fTexelScale / 2.f );
+	// Corners shrink when the panel is smaller than the borders
+	const float fScaleX = ( fLeft + fRight > fW && fLeft + fRight > 0.f ) ? fW / ( fLeft + fRight ) : 1.f;
+	const float fScaleY = ( fTop + fBottom > fH && fTop + fBottom > 0.f ) ? fH / ( fTop + fBottom ) : 1.f;
+
+	// Patch edges on screen and in the texture (texels)
+	const float afX[4] = { fX, fX + fLeft * fScaleX, fX + fW - fRight * fScaleX, fX + fW };
+	const float afY[4] = { fY, fY + fTop * fScaleY, fY + fH - fBottom * fScaleY, fY + fH };
+	const float afU[4] = { fU0, fU0 + fLeft * fTexelScale, fU1 - fRight * fTexelScale, fU1 };
+	const float afV[4] = { fV0, fV0 + fTop * fTexelScale, fV1 - fBottom * fTexelScale, fV1 };
+
+	const int iOrder = pMask->GetOrder();
+	const VColorRef tColor = pMask->GetColor();
+	for ( int iRow = 0; iRow < 3; iRow++ )
+	{
+		for ( int iCol = 0; iCol < 3; iCol++ )
+		{
+			if ( iRow == 1 && iCol == 1 && !m_bDrawCenter ) continue;
+			const float fPatchW = afX[iCol + 1] - afX[iCol];
+			const float fPatchH = afY[iRow + 1] - afY[iRow];
+			if ( fPatchW <= 0.f || fPatchH <= 0.f ) continue;
+			tBatch.AddQuad( pTexture, iOrder, afX[iCol], afY[iRow], fPatchW, fPatchH,
+				afU[iCol] / fTexW, afV[iRow] / fTexH, afU[iCol + 1] / fTexW, afV[iRow + 1] / fTexH, tColor );
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef GUININESLICE_H_INCLUDED
+#define GUININESLICE_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUISpriteBatch.h"
+#include "GUIArena.h"
+
+
+/*
+	Draws the current frame of an element as a scalable panel: the frame is cut by four border insets (texels of the layout tier) into
+	corners kept at their size, edges stretched along one axis and a center stretched along both. Sizes below the
+	borders shrink the corners proportionally. The element size (SetSize, SetScale, tweens) is the panel size and
+	its touch area. Owned by the element (GUIAnimation::SetNineSlice). Rotation is not applied.
+*/
+class GUINineSlice : public IGUIQuadProvider
+{
+public:
+	GUI_DECLARE_ARENA_NEW
+
+	GUINineSlice( const float fLeft, const float fTop, const float fRight, const float fBottom );
+
+	void SetInsets( const float fLeft, const float fTop, const float fRight, const float fBottom );
+	void GetInsets( float& fLeft, float& fTop, float& fRight, float& fBottom ) const { fLeft = m_fLeft; fTop = m_fTop; fRight = m_fRight; fBottom = m_fBottom; }
+	// Center patch is not drawn (frames, outlines)
+	void SetDrawCenter( const bool bDrawCenter ) { m_bDrawCenter = bDrawCenter; }
+	bool GetDrawCenter() const { return m_bDrawCenter; }
+
+	virtual void AddQuads( GUISpriteBatch& tBatch, const GUIAnimation* pAnim );
+
+private:
+	float m_fLeft, m_fTop, m_fRight, m_fBottom;
+	bool m_bDrawCenter;
+};
+
+
+#endif // GUININESLICE_H_INCLUDED
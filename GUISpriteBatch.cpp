@@ -0,0 +1,213 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUISpriteBatch.h"
+#include "GUIAnimation.h"
+#include <algorithm>
+
+
+#define VERTICES_PER_QUAD 6
+
+
+GUISpriteBatch::GUISpriteBatch()
+{
+	m_uiNumQuads = 0;
+	m_pRenderInterface = 0;
+	m_bHeadless = false;
+	m_bBegun = false;
+	m_bClipping = false;
+	m_fClipX0 = m_fClipY0 = m_fClipX1 = m_fClipY1 = 0.f;
+	m_tStats.Init();
+}
+
+GUISpriteBatch::~GUISpriteBatch()
+{
+	m_aQuads.Reset();
+	m_aVertices.Reset();
+	m_pRenderInterface = 0;
+}
+
+void GUISpriteBatch::Begin()
+{
+	m_uiNumQuads = 0;
+	m_tStats.Init();
+	m_bBegun = true;
+	m_bClipping = false;
+}
+
+void GUISpriteBatch::SetClipRect( const float fX, const float fY, const float fW, const float fH )
+{
+	m_bClipping = true;
+	m_fClipX0 = fX;
+	m_fClipY0 = fY;
+	m_fClipX1 = fX + hkvMath::Max( fW, 0.f );
+	m_fClipY1 = fY + hkvMath::Max( fH, 0.f );
+}
+
+void GUISpriteBatch::AddElement( const GUIAnimation* pAnim )
+{
+	const VisScreenMask_cl* pMask = pAnim->GetTexture();
+	if ( !pMask ) return;
+	VTextureObject* pTexture = pMask->GetTextureObject();
+	if ( !pTexture ) return;
+
+	float fX, fY, fW, fH;
+	pMask->GetPos( fX, fY );
+	pMask->GetTargetSize( fW, fH );
+	// Texture range is given in texels, convert to normalized coords
+	float fU0, fV0, fU1, fV1;
+	pMask->GetTextureRange( fU0, fV0, fU1, fV1 );
+	const float fTexW = static_cast<float>(pTexture->GetTextureWidth());
+	const float fTexH = static_cast<float>(pTexture->GetTextureHeight());
+	if ( fTexW <= 0.f || fTexH <= 0.f ) return;
+
+	m_tStats.m_uiElements++;
+	if ( pAnim->HasClipRect() )
+	{
+		const GUIAnimation::FrameRect& tClipRect = pAnim->GetClipRect();
+		SetClipRect( tClipRect.m_fX, tClipRect.m_fY, tClipRect.m_fW, tClipRect.m_fH );
+	}
+	else ClearClipRect();
+	if ( pAnim->GetQuadProvider() ) pAnim->GetQuadProvider()->AddQuads( *this, pAnim );
+	else AddQuad( pTexture, pMask->GetOrder(), fX, fY, fW, fH, fU0 / fTexW, fV0 / fTexH, fU1 / fTexW, fV1 / fTexH, pMask->GetColor(), pMask->GetRotationAngle() );
+	ClearClipRect();
+}
+
+void GUISpriteBatch::AddQuad( VTextureObject* pTexture, const int iOrder, const float fX, const float fY, const float fW, const float fH, const float fU0, const float fV0, const float fU1, const float fV1, const VColorRef& tColor, const float fAngle )
+{
+	VASSERT( m_bBegun );
+
+	m_aQuads.EnsureSize( m_uiNumQuads + 1 );
+	QuadEntry& tQuad = m_aQuads.GetDataPtr()[ m_uiNumQuads ];
+	tQuad.m_pTexture = pTexture;
+	tQuad.m_iOrder = iOrder;
+	tQuad.m_uiSeq = m_uiNumQuads;
+	tQuad.m_fX = fX; tQuad.m_fY = fY; tQuad.m_fW = fW; tQuad.m_fH = fH;
+	tQuad.m_fU0 = fU0; tQuad.m_fV0 = fV0; tQuad.m_fU1 = fU1; tQuad.m_fV1 = fV1;
+	tQuad.m_tColor = tColor;
+	tQuad.m_fAngle = fAngle;
+	if ( m_bClipping && !ClipQuad( tQuad ) ) 
+	{
+		m_tStats.m_uiClippedOut++;
+		return;
+	}
+	m_uiNumQuads++;
+}
+
+/*
+	Trims the quad and its texture coords to the clip rect. False if nothing is left
+*/
+bool GUISpriteBatch::ClipQuad( QuadEntry& tQuad )
+{
+	if ( tQuad.m_fAngle != 0.f )
+	{ // Circumscribed square of the rotated quad, kept whole
+		const float fRadius = hkvMath::sqrt( tQuad.m_fW * tQuad.m_fW + tQuad.m_fH * tQuad.m_fH ) / 2.f;
+		const float fCenterX = tQuad.m_fX + tQuad.m_fW / 2.f;
+		const float fCenterY = tQuad.m_fY + tQuad.m_fH / 2.f;
+		return !( fCenterX + fRadius <= m_fClipX0 || fCenterY + fRadius <= m_fClipY0 || fCenterX - fRadius >= m_fClipX1 || fCenterY - fRadius >= m_fClipY1 );
+	}
+
+	const float fX0 = hkvMath::Max( tQuad.m_fX, m_fClipX0 );
+	const float fY0 = hkvMath::Max( tQuad.m_fY, m_fClipY0 );
+	const float fX1 = hkvMath::Min( tQuad.m_fX + tQuad.m_fW, m_fClipX1 );
+	const float fY1 = hkvMath::Min( tQuad.m_fY + tQuad.m_fH, m_fClipY1 );
+	if ( fX1 <= fX0 || fY1 <= fY0 ) return false;
+	if ( fX0 == tQuad.m_fX && fY0 == tQuad.m_fY && fX1 == tQuad.m_fX + tQuad.m_fW && fY1 == tQuad.m_fY + tQuad.m_fH ) return true;
+
+	// Texture coords follow the trimmed edges
+	const float fDU = ( tQuad.m_fU1 - tQuad.m_fU0 ) / tQuad.m_fW;
+	const float fDV = ( tQuad.m_fV1 - tQuad.m_fV0 ) / tQuad.m_fH;
+	const float fU0 = tQuad.m_fU0 + ( fX0 - tQuad.m_fX ) * fDU;
+	const float fV0 = tQuad.m_fV0 + ( fY0 - tQuad.m_fY ) * fDV;
+	tQuad.m_fU1 = tQuad.m_fU0 + ( fX1 - tQuad.m_fX ) * fDU;
+	tQuad.m_fV1 = tQuad.m_fV0 + ( fY1 - tQuad.m_fY ) * fDV;
+	tQuad.m_fU0 = fU0;
+	tQuad.m_fV0 = fV0;
+	tQuad.m_fX = fX0;
+	tQuad.m_fY = fY0;
+	tQuad.m_fW = fX1 - fX0;
+	tQuad.m_fH = fY1 - fY0;
+	m_tStats.m_uiTrimmed++;
+	return true;
+}
+
+void GUISpriteBatch::End()
+{
+	VASSERT( m_bBegun );
+	m_bBegun = false;
+	if ( m_uiNumQuads == 0 ) return;
+
+	// Back to front (higher order is drawn first), then group by atlas page inside the same order
+	QuadEntry* pQuads = m_aQuads.GetDataPtr();
+	std::sort( pQuads, pQuads + m_uiNumQuads, CompareQuads );
+
+	// Write every quad in the shared vertex buffer
+	const unsigned int uiNumVertices = m_uiNumQuads * VERTICES_PER_QUAD;
+	m_aVertices.EnsureSize( uiNumVertices );
+	Overlay2DVertex_t* pVertices = m_aVertices.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumQuads; i++ )
+		WriteQuad( pQuads[i], pVertices + i * VERTICES_PER_QUAD );
+	m_tStats.m_uiQuads = m_uiNumQuads;
+	m_tStats.m_uiVertices = uiNumVertices;
+
+	if ( !m_bHeadless ) m_pRenderInterface = Vision::RenderLoopHelper.BeginOverlayRendering();
+
+	// One draw per run of quads sharing the same texture
+	unsigned int uiRunStart = 0;
+	for ( unsigned int i = 1; i <= m_uiNumQuads; i++ )
+	{
+		if ( i == m_uiNumQuads || pQuads[i].m_pTexture != pQuads[uiRunStart].m_pTexture )
+		{
+			Flush( pQuads[uiRunStart].m_pTexture, uiRunStart * VERTICES_PER_QUAD, (i - uiRunStart) * VERTICES_PER_QUAD );
+			uiRunStart = i;
+		}
+	}
+
+	if ( !m_bHeadless ) Vision::RenderLoopHelper.EndOverlayRendering();
+	m_pRenderInterface = 0;
+}
+
+bool GUISpriteBatch::CompareQuads( const QuadEntry& tQuad0, const QuadEntry& tQuad1 )
+{
+	if ( tQuad0.m_iOrder != tQuad1.m_iOrder ) return tQuad0.m_iOrder > tQuad1.m_iOrder;
+	if ( tQuad0.m_pTexture != tQuad1.m_pTexture ) return tQuad0.m_pTexture < tQuad1.m_pTexture;
+	return tQuad0.m_uiSeq < tQuad1.m_uiSeq;
+}
+
+void GUISpriteBatch::WriteQuad( const QuadEntry& tQuad, Overlay2DVertex_t* pVertices ) const
+{
+	// Corners relative to the rotation center (quad center)
+	const float fHalfW = tQuad.m_fW / 2.f;
+	const float fHalfH = tQuad.m_fH / 2.f;
+	hkvVec2 av2Corners[4] = { hkvVec2( -fHalfW, -fHalfH ), hkvVec2( fHalfW, -fHalfH ), hkvVec2( fHalfW, fHalfH ), hkvVec2( -fHalfW, fHalfH ) };
+	if ( tQuad.m_fAngle != 0.f )
+	{
+		const float fSin = hkvMath::sinDeg( tQuad.m_fAngle );
+		const float fCos = hkvMath::cosDeg( tQuad.m_fAngle );
+		for ( int i = 0; i < 4; i++ )
+		{
+			const hkvVec2 v2Corner = av2Corners[i];
+			av2Corners[i].x = v2Corner.x * fCos - v2Corner.y * fSin;
+			av2Corners[i].y = v2Corner.x * fSin + v2Corner.y * fCos;
+		}
+	}
+	const hkvVec2 v2Center( tQuad.m_fX + fHalfW, tQuad.m_fY + fHalfH );
+	const hkvVec2 av2UVs[4] = { hkvVec2( tQuad.m_fU0, tQuad.m_fV0 ), hkvVec2( tQuad.m_fU1, tQuad.m_fV0 ), hkvVec2( tQuad.m_fU1, tQuad.m_fV1 ), hkvVec2( tQuad.m_fU0, tQuad.m_fV1 ) };
+
+	// Two triangles: 0-1-2, 0-2-3
+	static const int s_aiIndices[VERTICES_PER_QUAD] = { 0, 1, 2, 0, 2, 3 };
+	for ( int i = 0; i < VERTICES_PER_QUAD; i++ )
+	{
+		const int iCorner = s_aiIndices[i];
+		pVertices[i].screenPos = v2Center + av2Corners[iCorner];
+		pVertices[i].texCoord = av2UVs[iCorner];
+		pVertices[i].color = tQuad.m_tColor;
+	}
+}
+
+void GUISpriteBatch::Flush( VTextureObject* pTexture, const unsigned int uiFirstVertex, const unsigned int uiNumVertices )
+{
+	m_tStats.m_uiBatches++;
+	if ( m_bHeadless || !m_pRenderInterface ) return;
+
+	VSimpleRenderState_t tState( VIS_TRANSP_ALPHA, RENDERSTATEFLAG_FILTERING );
+	m_pRenderInterface->Draw2DBuffer( uiNumVertices, m_aVertices.GetDataPtr() + uiFirstVertex, pTexture, tState );
+}
@@ -0,0 +1,92 @@
+#ifndef GUISPRITEBATCH_H_INCLUDED
+#define GUISPRITEBATCH_H_INCLUDED
+
+#include "GlobalTypes.h"
+
+
+class GUIAnimation;
+class GUISpriteBatch;
+
+
+/*
+	Draws an element with its own quads instead of its screen mask quad (e.g. text). The element clip rect is already
+	set on the batch when AddQuads is called
+*/
+class IGUIQuadProvider
+{
+public:
+	virtual ~IGUIQuadProvider() {}
+	virtual void AddQuads( GUISpriteBatch& tBatch, const GUIAnimation* pAnim ) = 0;
+};
+
+
+/*
+	Collects the quads of visible GUI elements, groups them by atlas page (texture) keeping the
+	back-to-front order given by the screen mask order, and submits each group with a single draw.
+	In headless mode the vertex buffer is built and the batches are counted but nothing is drawn.
+	Quads can be clipped to a screen rect: the clipping is done on the CPU (position and texture coords are trimmed)
+	so clipped quads stay in the same batches. Rotated quads are only dropped when fully outside the rect.
+*/
+class GUISpriteBatch
+{
+public:
+	struct BatchStats
+	{
+		void Init() { m_uiElements = 0; m_uiQuads = 0; m_uiBatches = 0; m_uiVertices = 0; m_uiTrimmed = 0; m_uiClippedOut = 0; }
+
+		unsigned int m_uiElements; // Elements submitted to the batch
+		unsigned int m_uiQuads; // Quads written in the vertex buffer
+		unsigned int m_uiBatches; // Draw calls issued (or counted in headless mode)
+		unsigned int m_uiVertices;
+		unsigned int m_uiTrimmed; // Quads partially clipped
+		unsigned int m_uiClippedOut; // Quads dropped by the clip rect
+	};
+
+	GUISpriteBatch();
+	~GUISpriteBatch();
+
+	void SetHeadless( const bool bHeadless ) { m_bHeadless = bHeadless; }
+	bool IsHeadless() const { return m_bHeadless; }
+
+	void Begin();
+	void AddElement( const GUIAnimation* pAnim );
+	void AddQuad( VTextureObject* pTexture, const int iOrder, const float fX, const float fY, const float fW, const float fH, const float fU0, const float fV0, const float fU1, const float fV1, const VColorRef& tColor, const float fAngle = 0.f );
+	void End();
+	// Applies to the next quads until cleared. AddElement sets the element clip rect itself
+	void SetClipRect( const float fX, const float fY, const float fW, const float fH );
+	void ClearClipRect() { m_bClipping = false; }
+	bool IsClipping() const { return m_bClipping; }
+
+	const BatchStats& GetStats() const { return m_tStats; }
+
+private:
+	struct QuadEntry
+	{
+		VTextureObject* m_pTexture;
+		int m_iOrder;
+		unsigned int m_uiSeq; // Submission index, keeps the sort stable
+		float m_fX, m_fY, m_fW, m_fH;
+		float m_fU0, m_fV0, m_fU1, m_fV1; // Normalized texture coords
+		float m_fAngle; // Degrees, around the quad center
+		VColorRef m_tColor;
+	};
+
+	static bool CompareQuads( const QuadEntry& tQuad0, const QuadEntry& tQuad1 );
+
+	bool ClipQuad( QuadEntry& tQuad );
+	void WriteQuad( const QuadEntry& tQuad, Overlay2DVertex_t* pVertices ) const;
+	void Flush( VTextureObject* pTexture, const unsigned int uiFirstVertex, const unsigned int uiNumVertices );
+
+	DynArray_cl<QuadEntry> m_aQuads;
+	unsigned int m_uiNumQuads;
+	DynArray_cl<Overlay2DVertex_t> m_aVertices; // Dynamic vertex buffer shared by every batch
+	IVRender2DInterface* m_pRenderInterface;
+	bool m_bHeadless;
+	bool m_bBegun;
+	bool m_bClipping;
+	float m_fClipX0, m_fClipY0, m_fClipX1, m_fClipY1;
+	BatchStats m_tStats;
+};
+
+
+#endif // GUISPRITEBATCH_H_INCLUDED
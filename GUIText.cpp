@@ -0,0 +1,176 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIText.h"
+#include "GUIAnimationManager.h"
+
+
+GUIText::GUIText( const GUIFont* pFont, GUIAnimation* pAnim )
+{
+	m_pFont = pFont;
+	m_pAnim = pAnim;
+	m_pcText[0] = '\0';
+	m_uiLength = 0;
+	m_eAlign = GTA_LEFT;
+	m_fLetterSpacing = 0.f;
+	m_aQuads.Init( GlyphQuad() );
+	m_uiNumQuads = 0;
+	m_fWidth = 0.f;
+	m_fHeight = 0.f;
+	m_bDirty = true;
+	m_uiLayoutCount = 0;
+	if ( m_pAnim ) m_pAnim->SetQuadProvider( this );
+}
+
+/*
+	The element is deleted by GUIAnimationManager::DestroyText, or with every other element on shutdown
+*/
+GUIText::~GUIText()
+{
+	if ( m_pAnim ) m_pAnim->SetQuadProvider( 0 );
+	m_aQuads.Reset();
+}
+
+void GUIText::SetText( const char* pcText )
+{
+	if ( !pcText ) pcText = "";
+	// Compare and copy in one pass, stop at the first difference
+	unsigned int i = 0;
+	while ( i < GUI_TEXT_MAX_LENGTH && pcText[i] && pcText[i] == m_pcText[i] ) i++;
+	if ( ( i == GUI_TEXT_MAX_LENGTH || pcText[i] == m_pcText[i] ) && i == m_uiLength ) return; // Unchanged
+
+	for ( ; i < GUI_TEXT_MAX_LENGTH && pcText[i]; i++ )
+		m_pcText[i] = pcText[i];
+	m_pcText[i] = '\0';
+	m_uiLength = i;
+	m_bDirty = true;
+}
+
+void GUIText::SetNumber( const int iNumber, const unsigned int uiMinDigits )
+{
+	// Digits written backwards on the stack, no string allocation
+	char pcDigits[16];
+	char* pcCursor = pcDigits + sizeof(pcDigits) - 1;
+	*pcCursor = '\0';
+	unsigned int uiValue = ( iNumber < 0 ) ? 0u - static_cast<unsigned int>(iNumber) : static_cast<unsigned int>(iNumber);
+	unsigned int uiNumDigits = 0;
+	const unsigned int uiPadDigits = hkvMath::Min( uiMinDigits, static_cast<unsigned int>( sizeof(pcDigits) - 2 ) );
+	do
+	{
+		*--pcCursor = static_cast<char>( '0' + uiValue % 10 );
+		uiValue /= 10;
+		uiNumDigits++;
+	} while ( uiValue > 0 || uiNumDigits < uiPadDigits );
+	if ( iNumber < 0 ) *--pcCursor = '-';
+	SetText( pcCursor );
+}
+
+void GUIText::SetAlignment( const eGUITextAlign eAlign )
+{
+	if ( m_eAlign == eAlign ) return;
+	m_eAlign = eAlign;
+	m_bDirty = true;
+}
+
+void GUIText::SetLetterSpacing( const float fSpacing )
+{
+	if ( m_fLetterSpacing == fSpacing ) return;
+	m_fLetterSpacing = fSpacing;
+	m_bDirty = true;
+}
+
+float GUIText::GetLineWidth( const unsigned int uiStart ) const
+{
+	float fWidth = 0.f;
+	unsigned int uiNumChars = 0;
+	for ( unsigned int i = uiStart; i < m_uiLength && m_pcText[i] != '\n'; i++, uiNumChars++ )
+		fWidth += m_pFont->GetGlyph( static_cast<unsigned char>(m_pcText[i]) ).m_fAdvance;
+	if ( uiNumChars > 1 ) fWidth += m_fLetterSpacing * ( uiNumChars - 1 );
+	return fWidth;
+}
+
+bool GUIText::Layout()
+{
+	m_bDirty = false;
+	m_uiNumQuads = 0;
+	if ( !m_pAnim || !m_pAnim->GetTexture() || !m_pAnim->GetTexture()->GetTextureObject() ) return false;
+	m_uiLayoutCount++;
+
+	// Glyphs are layout pixels, the texture may be another tier
+	const VTextureObject* pTexture = m_pAnim->GetTexture()->GetTextureObject();
+	const float fTexW = static_cast<float>(pTexture->GetTextureWidth()) / m_pAnim->GetTexelScale();
+	const float fTexH = static_cast<float>(pTexture->GetTextureHeight()) / m_pAnim->GetTexelScale();
+	if ( fTexW <= 0.f || fTexH <= 0.f ) return false;
+	const float fLineHeight = m_pFont->GetLineHeight();
+
+	// Extents first, lines are aligned inside the widest one
+	float fWidth = GetLineWidth( 0 );
+	unsigned int uiNumLines = 1;
+	for ( unsigned int i = 0; i < m_uiLength; i++ )
+	{
+		if ( m_pcText[i] != '\n' ) continue;
+		fWidth = hkvMath::Max( fWidth, GetLineWidth( i + 1 ) );
+		uiNumLines++;
+	}
+
+	m_aQuads.EnsureSize( m_uiLength );
+	GlyphQuad* pQuads = m_aQuads.GetDataPtr();
+	float fPenY = 0.f;
+	float fPenX = 0.f;
+	for ( unsigned int i = 0; i <= m_uiLength; i++ )
+	{
+		if ( i == 0 || m_pcText[i - 1] == '\n' )
+		{ // Line start
+			if ( i > 0 ) fPenY += fLineHeight;
+			const float fLineWidth = GetLineWidth( i );
+			fPenX = ( m_eAlign == GTA_CENTER ) ? ( fWidth - fLineWidth ) / 2.f : ( ( m_eAlign == GTA_RIGHT ) ? fWidth - fLineWidth : 0.f );
+		}
+		if ( i == m_uiLength || m_pcText[i] == '\n' ) continue;
+
+		const GUIFont::Glyph& tGlyph = m_pFont->GetGlyph( static_cast<unsigned char>(m_pcText[i]) );
+		if ( tGlyph.m_bValid && tGlyph.m_fW > 0.f && tGlyph.m_fH > 0.f )
+		{
+			GlyphQuad& tQuad = pQuads[ m_uiNumQuads++ ];
+			tQuad.m_fX = fPenX + tGlyph.m_fOffsetX;
+			tQuad.m_fY = fPenY + tGlyph.m_fOffsetY;
+			tQuad.m_fW = tGlyph.m_fW;
+			tQuad.m_fH = tGlyph.m_fH;
+			tQuad.m_fU0 = tGlyph.m_fX / fTexW;
+			tQuad.m_fV0 = tGlyph.m_fY / fTexH;
+			tQuad.m_fU1 = ( tGlyph.m_fX + tGlyph.m_fW ) / fTexW;
+			tQuad.m_fV1 = ( tGlyph.m_fY + tGlyph.m_fH ) / fTexH;
+		}
+		fPenX += tGlyph.m_fAdvance + m_fLetterSpacing;
+	}
+
+	const float fHeight = fLineHeight * uiNumLines;
+	if ( fWidth == m_fWidth && fHeight == m_fHeight ) return false;
+	m_fWidth = fWidth;
+	m_fHeight = fHeight;
+
+	// New natural size, the element keeps its scale
+	m_pAnim->m_fInitWidth = hkvMath::Max( m_fWidth, 1.f );
+	m_pAnim->m_fInitHeight = hkvMath::Max( m_fHeight, 1.f );
+	m_pAnim->SetSize( m_pAnim->m_fInitWidth * m_pAnim->m_fScaleX, m_pAnim->m_fInitHeight * m_pAnim->m_fScaleY );
+	return true;
+}
+
+void GUIText::AddQuads( GUISpriteBatch& tBatch, const GUIAnimation* pAnim )
+{
+	const VisScreenMask_cl* pMask = pAnim->GetTexture();
+	VTextureObject* pTexture = pMask->GetTextureObject();
+	float fX, fY, fW, fH;
+	pMask->GetPos( fX, fY );
+	pMask->GetTargetSize( fW, fH );
+	// Tweened size scales the glyphs
+	const float fScaleX = fW / pAnim->m_fInitWidth;
+	const float fScaleY = fH / pAnim->m_fInitHeight;
+	const int iOrder = pMask->GetOrder();
+	const VColorRef tColor = pMask->GetColor();
+
+	const GlyphQuad* pQuads = m_aQuads.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumQuads; i++ )
+	{
+		const GlyphQuad& tQuad = pQuads[i];
+		tBatch.AddQuad( pTexture, iOrder, fX + tQuad.m_fX * fScaleX, fY + tQuad.m_fY * fScaleY, tQuad.m_fW * fScaleX, tQuad.m_fH * fScaleY,
+			tQuad.m_fU0, tQuad.m_fV0, tQuad.m_fU1, tQuad.m_fV1, tColor );
+	}
+}
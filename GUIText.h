@@ -0,0 +1,87 @@
+#ifndef GUITEXT_H_INCLUDED
+#define GUITEXT_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include "GUISpriteBatch.h"
+#include "GUIFont.h"
+
+
+#define GUI_TEXT_MAX_LENGTH 255
+
+
+enum eGUITextAlign
+{
+	GTA_LEFT = 0,
+	GTA_CENTER,
+	GTA_RIGHT
+};
+
+
+/*
+	String drawn with a bitmap font through the sprite batch. The text lives on a regular element (GetAnimation) sized
+	to the text extents, so it is positioned, parented, tweened (scale, alpha, color) and touched like any other; its
+	glyph quads are cached relative to it and only rebuilt when the string, alignment or spacing change.
+	The string is kept in a fixed buffer: SetText and SetNumber do not allocate and ignore unchanged values.
+	Lines are split by '\n'. Rotation is not applied to the glyphs. Created and owned by GUIAnimationManager.
+*/
+class GUIText : public IGUIQuadProvider
+{
+	friend class GUIAnimationManager;
+
+public:
+	GUI_DECLARE_ARENA_NEW
+
+	// Longer strings are truncated to GUI_TEXT_MAX_LENGTH characters
+	void SetText( const char* pcText );
+	void SetNumber( const int iNumber, const unsigned int uiMinDigits = 0 );
+	const char* GetText() const { return m_pcText; }
+	unsigned int GetLength() const { return m_uiLength; }
+
+	void SetAlignment( const eGUITextAlign eAlign );
+	eGUITextAlign GetAlignment() const { return m_eAlign; }
+	void SetLetterSpacing( const float fSpacing );
+	float GetLetterSpacing() const { return m_fLetterSpacing; }
+
+	GUIAnimation* GetAnimation() const { return m_pAnim; }
+	const GUIFont* GetFont() const { return m_pFont; }
+	// Unscaled text extents in pixels
+	float GetTextWidth() const { return m_fWidth; }
+	float GetTextHeight() const { return m_fHeight; }
+	bool IsDirty() const { return m_bDirty; }
+	// Glyph layouts done so far
+	unsigned int GetLayoutCount() const { return m_uiLayoutCount; }
+
+	virtual void AddQuads( GUISpriteBatch& tBatch, const GUIAnimation* pAnim );
+
+private:
+	GUIText( const GUIFont* pFont, GUIAnimation* pAnim );
+	virtual ~GUIText();
+
+	struct GlyphQuad
+	{
+		float m_fX, m_fY, m_fW, m_fH; // From the text top left corner, unscaled
+		float m_fU0, m_fV0, m_fU1, m_fV1; // Normalized texture coords
+	};
+
+	// Rebuilds the glyph quads and resizes the element, keeping its scale. False if the extents did not change
+	bool Layout();
+	float GetLineWidth( const unsigned int uiStart ) const;
+	void OnAnimationDestroyed() { m_pAnim = 0; }
+
+	const GUIFont* m_pFont;
+	GUIAnimation* m_pAnim;
+	char m_pcText[GUI_TEXT_MAX_LENGTH + 1];
+	unsigned int m_uiLength;
+	eGUITextAlign m_eAlign;
+	float m_fLetterSpacing;
+
+	DynArray_cl<GlyphQuad> m_aQuads;
+	unsigned int m_uiNumQuads;
+	float m_fWidth, m_fHeight;
+	bool m_bDirty;
+	unsigned int m_uiLayoutCount;
+};
+
+
+#endif // GUITEXT_H_INCLUDED
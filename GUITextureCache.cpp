@@ -0,0 +1,187 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUITextureCache.h"
+
+
+GUITextureCache::GUITextureCache()
+{
+	m_uiCap = 0;
+	m_uiFrame = 0;
+	m_bDirty = false;
+	for ( unsigned int i = 0; i < GUI_TEXTURE_EVICTION_LOG_SIZE; i++ )
+	{
+		m_atEvictionLog[i].m_uiBytes = 0;
+		m_atEvictionLog[i].m_uiFrame = 0;
+	}
+	m_tStats.Init();
+}
+
+void GUITextureCache::Register( VTextureObject* pTexture, const std::string& sTag )
+{
+	if ( !pTexture || m_hEntries.find( pTexture ) != m_hEntries.end() ) return;
+	if ( !pTexture->IsLoaded() ) pTexture->EnsureLoaded(); // Evicted, then forgotten once no element used it
+	Entry& tEntry = m_hEntries[pTexture];
+	tEntry.m_spTexture = pTexture;
+	tEntry.m_sTag = sTag;
+	tEntry.m_uiBytes = GetTextureBytes( pTexture );
+	tEntry.m_uiNumElements = 0;
+	tEntry.m_uiNumVisible = 0;
+	tEntry.m_uiLastVisibleFrame = m_uiFrame; // Just loaded counts as recently used
+	tEntry.m_bResident = true;
+	m_tStats.m_uiNumTextures++;
+	m_tStats.m_uiNumResident++;
+	m_tStats.m_uiResidentBytes += tEntry.m_uiBytes;
+}
+
+void GUITextureCache::Replace( VTextureObject* pOld, VTextureObject* pNew )
+{
+	std::map< const VTextureObject*, Entry >::const_iterator it = m_hEntries.find( pOld );
+	Register( pNew, ( it != m_hEntries.end() ) ? it->second.m_sTag : std::string() );
+	m_bDirty = true; // Old one released once no element uses it
+}
+
+void GUITextureCache::AddElement( GUIAnimation* pAnim, const std::string& sTag )
+{
+	if ( pAnim->m_bCacheCounted ) RemoveElement( pAnim );
+	VTextureObject* pTexture = pAnim->GetTexture() ? pAnim->GetTexture()->GetTextureObject() : 0;
+	pAnim->m_bCacheCounted = true;
+	pAnim->m_pCacheTexture = pTexture;
+	pAnim->m_bCacheVisible = pTexture && pAnim->IsVisible() && !pAnim->IsCulled();
+	if ( !pTexture ) return;
+
+	Register( pTexture, sTag );
+	Entry& tEntry = m_hEntries[pTexture];
+	tEntry.m_uiNumElements++;
+	if ( pAnim->m_bCacheVisible )
+	{
+		tEntry.m_uiNumVisible++;
+		if ( !tEntry.m_bResident ) Reload( tEntry ); // Needed again before this frame is drawn
+	}
+	m_bDirty = true;
+}
+
+void GUITextureCache::RemoveElement( GUIAnimation* pAnim )
+{
+	if ( !pAnim->m_bCacheCounted ) return;
+	pAnim->m_bCacheCounted = false;
+	std::map< const VTextureObject*, Entry >::iterator it = m_hEntries.find( pAnim->m_pCacheTexture );
+	if ( it == m_hEntries.end() ) return;
+
+	Entry& tEntry = it->second;
+	tEntry.m_uiNumElements--;
+	if ( pAnim->m_bCacheVisible && --tEntry.m_uiNumVisible == 0 ) tEntry.m_uiLastVisibleFrame = m_uiFrame;
+	if ( tEntry.m_uiNumElements == 0 ) m_hEntries.erase( it ); // Released by every element
+	m_bDirty = true;
+}
+
+void GUITextureCache::UpdateElement( GUIAnimation* pAnim )
+{
+	if ( !pAnim->m_bCacheCounted ) return;
+	const VTextureObject* pTexture = pAnim->GetTexture() ? pAnim->GetTexture()->GetTextureObject() : 0;
+	const bool bVisible = pTexture && pAnim->IsVisible() && !pAnim->IsCulled();
+	if ( pTexture == pAnim->m_pCacheTexture && bVisible == pAnim->m_bCacheVisible ) return;
+
+	// Tag of the texture it used, the new one is most likely known already (tier swaps register it first)
+	std::map< const VTextureObject*, Entry >::const_iterator it = m_hEntries.find( pAnim->m_pCacheTexture );
+	const std::string sTag = ( it != m_hEntries.end() ) ? it->second.m_sTag : std::string();
+	RemoveElement( pAnim );
+	AddElement( pAnim, sTag );
+}
+
+void GUITextureCache::Refresh()
+{
+	if ( !m_bDirty ) return;
+	m_bDirty = false;
+	RefreshStats();
+	while ( m_uiCap > 0 && m_tStats.m_uiResidentBytes > m_uiCap )
+	{
+		// Least recently visible among the unused ones
+		Entry* pVictim = 0;
+		for ( std::map< const VTextureObject*, Entry >::iterator it = m_hEntries.begin(); it != m_hEntries.end(); ++it )
+		{
+			Entry& tEntry = it->second;
+			if ( !tEntry.m_bResident || tEntry.m_uiNumVisible > 0 ) continue;
+			if ( !pVictim || tEntry.m_uiLastVisibleFrame < pVictim->m_uiLastVisibleFrame ) pVictim = &tEntry;
+		}
+		if ( !pVictim ) break; // Everything resident is on screen
+		Evict( *pVictim );
+	}
+}
+
+void GUITextureCache::EvictUnused()
+{
+	for ( std::map< const VTextureObject*, Entry >::iterator it = m_hEntries.begin(); it != m_hEntries.end(); ++it )
+		if ( it->second.m_bResident && it->second.m_uiNumVisible == 0 ) Evict( it->second );
+}
+
+void GUITextureCache::Reload( Entry& tEntry )
+{
+	tEntry.m_spTexture->EnsureLoaded();
+	tEntry.m_bResident = true;
+	m_tStats.m_uiNumReloads++;
+	m_tStats.m_uiNumResident++;
+	m_tStats.m_uiResidentBytes += tEntry.m_uiBytes;
+	m_tStats.m_uiEvictedBytes -= tEntry.m_uiBytes;
+}
+
+void GUITextureCache::Evict( Entry& tEntry )
+{
+	tEntry.m_spTexture->EnsureUnloaded();
+	tEntry.m_bResident = false;
+
+	Eviction& tLog = m_atEvictionLog[ m_tStats.m_uiNumEvictions % GUI_TEXTURE_EVICTION_LOG_SIZE ];
+	tLog.m_sName = tEntry.m_spTexture->GetFilename();
+	tLog.m_sTag = tEntry.m_sTag;
+	tLog.m_uiBytes = tEntry.m_uiBytes;
+	tLog.m_uiFrame = m_uiFrame;
+	m_tStats.m_uiNumEvictions++;
+	m_tStats.m_uiNumResident--;
+	m_tStats.m_uiResidentBytes -= tEntry.m_uiBytes;
+	m_tStats.m_uiEvictedBytes += tEntry.m_uiBytes;
+}
+
+void GUITextureCache::RefreshStats()
+{
+	m_tStats.m_uiNumTextures = static_cast<unsigned int>( m_hEntries.size() );
+	m_tStats.m_uiNumResident = 0;
+	m_tStats.m_uiResidentBytes = 0;
+	m_tStats.m_uiEvictedBytes = 0;
+	for ( std::map< const VTextureObject*, Entry >::const_iterator it = m_hEntries.begin(); it != m_hEntries.end(); ++it )
+	{
+		if ( it->second.m_bResident )
+		{
+			m_tStats.m_uiNumResident++;
+			m_tStats.m_uiResidentBytes += it->second.m_uiBytes;
+		}
+		else m_tStats.m_uiEvictedBytes += it->second.m_uiBytes;
+	}
+}
+
+void GUITextureCache::ReloadAll()
+{
+	for ( std::map< const VTextureObject*, Entry >::iterator it = m_hEntries.begin(); it != m_hEntries.end(); ++it )
+		if ( !it->second.m_bResident ) Reload( it->second );
+}
+
+void GUITextureCache::GetTagBytes( const std::string& sTag, unsigned int& uiResidentBytes, unsigned int& uiEvictedBytes ) const
+{
+	uiResidentBytes = 0;
+	uiEvictedBytes = 0;
+	for ( std::map< const VTextureObject*, Entry >::const_iterator it = m_hEntries.begin(); it != m_hEntries.end(); ++it )
+	{
+		if ( it->second.m_sTag != sTag ) continue;
+		if ( it->second.m_bResident ) uiResidentBytes += it->second.m_uiBytes;
+		else uiEvictedBytes += it->second.m_uiBytes;
+	}
+}
+
+const GUITextureCache::Eviction& GUITextureCache::GetLoggedEviction( const unsigned int uiIndex ) const
+{
+	VASSERT( uiIndex < GetNumLoggedEvictions() );
+	return m_atEvictionLog[ ( m_tStats.m_uiNumEvictions - 1 - uiIndex ) % GUI_TEXTURE_EVICTION_LOG_SIZE ];
+}
+
+unsigned int GUITextureCache::GetTextureBytes( const VTextureObject* pTexture )
+{
+	const unsigned int uiBitsPerTexel = GUITextureCompression::GetBitsPerTexel( GUITextureCompression::GetFromFilename( pTexture->GetFilename() ) );
+	return pTexture->GetTextureWidth() * pTexture->GetTextureHeight() * uiBitsPerTexel / 8;
+}
@@ -0,0 +1,106 @@
+#ifndef GUITEXTURECACHE_H_INCLUDED
+#define GUITEXTURECACHE_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include "GUITextureCompression.h"
+#include <map>
+
+
+#define GUI_TEXTURE_EVICTION_LOG_SIZE 32 // Last evictions kept for queries
+
+
+/*
+	Memory accounting of the textures used by the elements (atlas pages and standalone textures) and LRU eviction
+	under a cap. Each texture is tagged with the screen active when it was first used (GUIAnimationManager::SetTextureOwnerTag).
+	Over the cap, textures no visible element uses are unloaded, the one visible longest ago first; they stay owned by
+	their elements and are reloaded as soon as one of them is visible again. Textures no element uses anymore are dropped.
+	Element and visible counts per texture are kept current by the manager hooks (element added or destroyed, shown,
+	hidden, culled, texture swapped), so an element shown again reloads its texture right away, cap or not. Eviction
+	only runs on the manager Update after counts changed. Owned by GUIAnimationManager.
+	Pooled elements are out of the manager lists, their textures are not accounted.
+*/
+class GUITextureCache
+{
+public:
+	struct Entry
+	{
+		VTextureObjectPtr m_spTexture;
+		std::string m_sTag;
+		unsigned int m_uiBytes;
+		unsigned int m_uiNumElements; // Kept current by the element hooks
+		unsigned int m_uiNumVisible;
+		unsigned int m_uiLastVisibleFrame;
+		bool m_bResident;
+	};
+
+	struct Eviction
+	{
+		std::string m_sName;
+		std::string m_sTag;
+		unsigned int m_uiBytes;
+		unsigned int m_uiFrame;
+	};
+
+	struct Stats
+	{
+		unsigned int m_uiNumTextures;
+		unsigned int m_uiNumResident;
+		unsigned int m_uiResidentBytes;
+		unsigned int m_uiEvictedBytes; // Accounted textures currently unloaded
+		unsigned int m_uiNumEvictions; // Since start
+		unsigned int m_uiNumReloads;
+		void Init() { memset( this, 0, sizeof(Stats) ); }
+	};
+
+	GUITextureCache();
+
+	// Accounts the texture under the tag if not known yet, loading it again if it was evicted meanwhile
+	void Register( VTextureObject* pTexture, const std::string& sTag );
+	// Same tag for a texture replacing another (tier change)
+	void Replace( VTextureObject* pOld, VTextureObject* pNew );
+	// Counts the element under its texture, the texture is tagged with sTag if new
+	void AddElement( GUIAnimation* pAnim, const std::string& sTag );
+	// Safe to call again for an element not counted anymore
+	void RemoveElement( GUIAnimation* pAnim );
+	// Visibility, culling or texture of a counted element changed. A texture needed again is loaded right away
+	void UpdateElement( GUIAnimation* pAnim );
+	// Frame stamped on the textures that stop being visible
+	void SetFrame( const unsigned int uiFrame ) { m_uiFrame = uiFrame; }
+	// Stats and eviction down to the cap, only if counts changed since the last refresh
+	void Refresh();
+	// Unloads every texture no visible element uses, whatever the cap (e.g. after a screen transition)
+	void EvictUnused();
+	// Loads every evicted texture back
+	void ReloadAll();
+	bool IsDirty() const { return m_bDirty; }
+
+	// Bytes, 0 for no cap
+	void SetCap( const unsigned int uiBytes ) { m_uiCap = uiBytes; m_bDirty = true; }
+	unsigned int GetCap() const { return m_uiCap; }
+
+	const Stats& GetStats() const { return m_tStats; }
+	const std::map< const VTextureObject*, Entry >& GetEntries() const { return m_hEntries; }
+	// Resident and evicted bytes of the textures of a screen
+	void GetTagBytes( const std::string& sTag, unsigned int& uiResidentBytes, unsigned int& uiEvictedBytes ) const;
+	// 0 is the most recent, up to GUI_TEXTURE_EVICTION_LOG_SIZE
+	unsigned int GetNumLoggedEvictions() const { return hkvMath::Min( m_tStats.m_uiNumEvictions, static_cast<unsigned int>(GUI_TEXTURE_EVICTION_LOG_SIZE) ); }
+	const Eviction& GetLoggedEviction( const unsigned int uiIndex ) const;
+
+	static unsigned int GetTextureBytes( const VTextureObject* pTexture );
+
+private:
+	void Evict( Entry& tEntry );
+	void Reload( Entry& tEntry );
+	void RefreshStats();
+
+	std::map< const VTextureObject*, Entry > m_hEntries;
+	unsigned int m_uiCap;
+	unsigned int m_uiFrame;
+	bool m_bDirty;
+	Eviction m_atEvictionLog[GUI_TEXTURE_EVICTION_LOG_SIZE]; // Ring buffer
+	Stats m_tStats;
+};
+
+
+#endif // GUITEXTURECACHE_H_INCLUDED
@@ -0,0 +1,132 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUITextureCompression.h"
+#include <algorithm>
+
+
+namespace
+{
+	const char* const s_apcSuffixes[GTC_COUNT] = { ".png", ".dds", "_etc2.ktx", "_astc.ktx" };
+}
+
+
+/*
+	Desktop GPUs decode BCn, GLES3 mobile GPUs ETC2. ASTC is opt-in (GUIAnimationManager::SetTextureCompression) as only
+	recent mobile GPUs decode it
+*/
+eGUITextureCompression GUITextureCompression::GetPlatformDefault()
+{
+#if defined(_VISION_WIN32)
+	return GTC_BC3;
+#elif defined(_VISION_ANDROID) || defined(_VISION_IOS)
+	return GTC_ETC2;
+#else
+	return GTC_NONE;
+#endif
+}
+
+bool GUITextureCompression::IsSupported( const eGUITextureCompression eFormat )
+{
+	switch ( eFormat )
+	{
+	case GTC_NONE: return true;
+#if defined(_VISION_WIN32)
+	case GTC_BC3: return true;
+#elif defined(_VISION_ANDROID) || defined(_VISION_IOS)
+	case GTC_ETC2:
+	case GTC_ASTC: return true;
+#endif
+	default: return false;
+	}
+}
+
+std::string GUITextureCompression::GetFilepath( const std::string& sFilepathWithoutExtension, const eGUITextureCompression eFormat )
+{
+	return sFilepathWithoutExtension + s_apcSuffixes[ ( eFormat < GTC_COUNT ) ? eFormat : GTC_NONE ];
+}
+
+eGUITextureCompression GUITextureCompression::GetFromFilename( const char* pcFilename )
+{
+	if ( !pcFilename ) return GTC_NONE;
+	const size_t uiLength = strlen( pcFilename );
+	for ( int i = GTC_NONE + 1; i < GTC_COUNT; i++ )
+	{
+		const size_t uiSuffixLength = strlen( s_apcSuffixes[i] );
+		if ( uiLength >= uiSuffixLength && strcmp( pcFilename + uiLength - uiSuffixLength, s_apcSuffixes[i] ) == 0 )
+			return static_cast<eGUITextureCompression>(i);
+	}
+	return GTC_NONE;
+}
+
+unsigned int GUITextureCompression::CheckAlpha( const unsigned char* pRGBA, const unsigned int uiWidth, const unsigned int uiHeight,
+	const std::map< std::string, GUIAnimation::FrameRect >& hFrames, const unsigned int uiMaxError, DynArray_cl<AlphaReport>& aReports )
+{
+	unsigned int uiNumReports = 0;
+	for ( std::map< std::string, GUIAnimation::FrameRect >::const_iterator it = hFrames.begin(); it != hFrames.end(); ++it )
+	{
+		AlphaReport tReport = CheckFrameAlpha( pRGBA, uiWidth, uiHeight, it->second );
+		if ( tReport.m_uiMaxError <= uiMaxError ) continue;
+		tReport.m_sFrame = it->first;
+		aReports[ uiNumReports++ ] = tReport;
+	}
+	if ( uiNumReports > 1 ) std::sort( aReports.GetDataPtr(), aReports.GetDataPtr() + uiNumReports, CompareReports );
+	return uiNumReports;
+}
+
+/*
+	Alpha of a block is rebuilt from 8 levels evenly spread between its min and max (BC3 alpha, close to ETC2 EAC and
+	ASTC endpoints). Blocks are aligned to the atlas, so texels of neighbour frames widen the range too
+*/
+GUITextureCompression::AlphaReport GUITextureCompression::CheckFrameAlpha( const unsigned char* pRGBA, const unsigned int uiWidth, const unsigned int uiHeight, const GUIAnimation::FrameRect& tFrame )
+{
+	AlphaReport tReport;
+	tReport.m_uiMaxError = 0;
+	tReport.m_fMeanError = 0.f;
+	tReport.m_fTranslucentRatio = 0.f;
+
+	const unsigned int uiX0 = static_cast<unsigned int>( hkvMath::Max( tFrame.m_fX, 0.f ) );
+	const unsigned int uiY0 = static_cast<unsigned int>( hkvMath::Max( tFrame.m_fY, 0.f ) );
+	const unsigned int uiX1 = hkvMath::Min( static_cast<unsigned int>( tFrame.m_fX + tFrame.m_fW ), uiWidth );
+	const unsigned int uiY1 = hkvMath::Min( static_cast<unsigned int>( tFrame.m_fY + tFrame.m_fH ), uiHeight );
+	if ( !pRGBA || uiX0 >= uiX1 || uiY0 >= uiY1 ) return tReport;
+
+	unsigned int uiNumTranslucent = 0;
+	unsigned int uiErrorSum = 0;
+	for ( unsigned int uiBlockY = uiY0 - uiY0 % GUI_ALPHA_BLOCK_SIZE; uiBlockY < uiY1; uiBlockY += GUI_ALPHA_BLOCK_SIZE )
+	{
+		for ( unsigned int uiBlockX = uiX0 - uiX0 % GUI_ALPHA_BLOCK_SIZE; uiBlockX < uiX1; uiBlockX += GUI_ALPHA_BLOCK_SIZE )
+		{
+			const unsigned int uiBlockX1 = hkvMath::Min( uiBlockX + GUI_ALPHA_BLOCK_SIZE, uiWidth );
+			const unsigned int uiBlockY1 = hkvMath::Min( uiBlockY + GUI_ALPHA_BLOCK_SIZE, uiHeight );
+			int iMin = 255, iMax = 0;
+			for ( unsigned int y = uiBlockY; y < uiBlockY1; y++ )
+			{
+				for ( unsigned int x = uiBlockX; x < uiBlockX1; x++ )
+				{
+					const int iAlpha = pRGBA[ ( y * uiWidth + x ) * 4 + 3 ];
+					iMin = hkvMath::Min( iMin, iAlpha );
+					iMax = hkvMath::Max( iMax, iAlpha );
+				}
+			}
+
+			const float fStep = ( iMax - iMin ) / 7.f;
+			for ( unsigned int y = hkvMath::Max( uiBlockY, uiY0 ); y < hkvMath::Min( uiBlockY1, uiY1 ); y++ )
+			{
+				for ( unsigned int x = hkvMath::Max( uiBlockX, uiX0 ); x < hkvMath::Min( uiBlockX1, uiX1 ); x++ )
+				{
+					const int iAlpha = pRGBA[ ( y * uiWidth + x ) * 4 + 3 ];
+					if ( iAlpha == 0 || iAlpha == 255 ) continue;
+					uiNumTranslucent++;
+					if ( fStep <= 0.f ) continue;
+					const float fLevel = hkvMath::floor( ( iAlpha - iMin ) / fStep + 0.5f );
+					const unsigned int uiError = static_cast<unsigned int>( hkvMath::Abs( iMin + fLevel * fStep - iAlpha ) + 0.5f );
+					uiErrorSum += uiError;
+					tReport.m_uiMaxError = hkvMath::Max( tReport.m_uiMaxError, uiError );
+				}
+			}
+		}
+	}
+
+	if ( uiNumTranslucent > 0 ) tReport.m_fMeanError = static_cast<float>(uiErrorSum) / uiNumTranslucent;
+	tReport.m_fTranslucentRatio = static_cast<float>(uiNumTranslucent) / ( ( uiX1 - uiX0 ) * ( uiY1 - uiY0 ) );
+	return tReport;
+}
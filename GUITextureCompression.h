@@ -0,0 +1,67 @@
+#ifndef GUITEXTURECOMPRESSION_H_INCLUDED
+#define GUITEXTURECOMPRESSION_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include <map>
+
+
+#define GUI_ALPHA_BLOCK_SIZE 4 // Texels per side of a compressed block
+#define GUI_ALPHA_DEFAULT_MAX_ERROR 8 // Alpha levels (0-255) a frame may lose before it is reported
+
+
+/*
+	Block compressed formats for atlas pages, all 8 bits per texel with alpha (a quarter of RGBA8). Atlases are looked up
+	next to the PNG with a suffix per format: "gui2x.dds" (BC3), "gui2x_etc2.ktx" (ETC2 RGBA), "gui2x_astc.ktx" (ASTC 4x4)
+*/
+enum eGUITextureCompression
+{
+	GTC_NONE = 0,
+	GTC_BC3,
+	GTC_ETC2,
+	GTC_ASTC,
+	GTC_COUNT
+};
+
+
+/*
+	Platform capabilities, file naming and memory of compressed atlases, and an offline check of frames that
+	should stay uncompressed. Block formats keep one alpha range per 4x4 block: soft shadows, glows and antialiased
+	edges packed next to opaque texels get banding. CheckAlpha simulates that quantization on the RGBA8 source
+	(e.g. the decoded PNG in a content tool) and reports the frames to pack in an atlas without compressed variant
+*/
+class GUITextureCompression
+{
+public:
+	struct AlphaReport
+	{
+		std::string m_sFrame;
+		unsigned int m_uiMaxError; // Worst alpha error of a texel, 0-255
+		float m_fMeanError; // Over the translucent texels
+		float m_fTranslucentRatio; // Texels neither opaque nor fully transparent
+	};
+
+	// Best format the running platform decodes in hardware, GTC_NONE if none
+	static eGUITextureCompression GetPlatformDefault();
+	static bool IsSupported( const eGUITextureCompression eFormat );
+	// File of the atlas in that format, from the path without extension
+	static std::string GetFilepath( const std::string& sFilepathWithoutExtension, const eGUITextureCompression eFormat );
+	// Format from a loaded texture filename, GTC_NONE for PNG and unknown files
+	static eGUITextureCompression GetFromFilename( const char* pcFilename );
+	static unsigned int GetBitsPerTexel( const eGUITextureCompression eFormat ) { return ( eFormat == GTC_NONE ) ? 32 : 8; }
+
+	/*
+		pRGBA: tightly packed RGBA8 texels of the atlas. Frames whose worst alpha error exceeds uiMaxError are written to
+		aReports, worst first, returns their number
+	*/
+	static unsigned int CheckAlpha( const unsigned char* pRGBA, const unsigned int uiWidth, const unsigned int uiHeight,
+		const std::map< std::string, GUIAnimation::FrameRect >& hFrames, const unsigned int uiMaxError, DynArray_cl<AlphaReport>& aReports );
+	// One frame, always reported
+	static AlphaReport CheckFrameAlpha( const unsigned char* pRGBA, const unsigned int uiWidth, const unsigned int uiHeight, const GUIAnimation::FrameRect& tFrame );
+
+private:
+	static bool CompareReports( const AlphaReport& tReport0, const AlphaReport& tReport1 ) { return tReport0.m_uiMaxError > tReport1.m_uiMaxError; }
+};
+
+
+#endif // GUITEXTURECOMPRESSION_H_INCLUDED
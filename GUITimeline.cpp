@@ -0,0 +1,384 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUITimeline.h"
+#include "GUIAnimationManager.h"
+#include "GUIAnimClip.h"
+#include "GUIEasingCurve.h"
+#include <algorithm>
+
+
+namespace
+{
+	hkvVec4 ColorToVec4( const VColorRef& tColor ) { return hkvVec4( tColor.r, tColor.g, tColor.b, 0.f ); }
+}
+
+GUITimeline::GUITimeline()
+{
+	m_aTracks.Init( Track() );
+	m_uiNumTracks = 0;
+	m_aChannels.Init( Channel() );
+	m_uiNumChannels = 0;
+	m_bDirty = false;
+	m_fDuration = 0.f;
+	m_fCursor = 0.f;
+	m_fPendingDelay = 0.f;
+	m_bInParallel = false;
+	m_fParallelStart = 0.f;
+	m_fParallelEnd = 0.f;
+	m_fTime = 0.f;
+	m_iRepeat = 0;
+	m_bYoyo = false;
+	m_bPlaying = false;
+	m_bFinished = false;
+	m_bPendingDestroy = false;
+	m_bAutoDestroy = false;
+	m_uiTimeGroup = 0;
+	m_bAffectedByTimeScale = true;
+	m_pfOnComplete = 0;
+}
+
+GUITimeline::~GUITimeline()
+{
+	m_aTracks.Reset();
+	m_aChannels.Reset();
+	m_hLabels.clear();
+	m_pfOnComplete = 0;
+}
+
+void GUITimeline::To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const float fTarget, const pfEase pfEaseMethod )
+{
+	const hkvVec4 v4Target( fTarget, 0.f, 0.f, 0.f );
+	AddTrack( pTarget, eProperty, fDuration, v4Target, v4Target, true, pfEaseMethod );
+}
+
+void GUITimeline::To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod )
+{
+	const hkvVec4 v4Target = ColorToVec4( tTarget );
+	AddTrack( pTarget, eProperty, fDuration, v4Target, v4Target, true, pfEaseMethod );
+}
+
+/*
+	Position given in relative (normalized) measures from top left anchor
+*/
+void GUITimeline::To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod )
+{
+	const hkvVec4 v4Target( v2Target.x, v2Target.y, 0.f, 0.f );
+	AddTrack( pTarget, eProperty, fDuration, v4Target, v4Target, true, pfEaseMethod );
+}
+
+void GUITimeline::FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod )
+{
+	AddTrack( pTarget, eProperty, fDuration, hkvVec4( fStart, 0.f, 0.f, 0.f ), hkvVec4( fTarget, 0.f, 0.f, 0.f ), false, pfEaseMethod );
+}
+
+void GUITimeline::FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod )
+{
+	AddTrack( pTarget, eProperty, fDuration, ColorToVec4( tStart ), ColorToVec4( tTarget ), false, pfEaseMethod );
+}
+
+/*
+	Position given in relative (normalized) measures from top left anchor
+*/
+void GUITimeline::FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod )
+{
+	AddTrack( pTarget, eProperty, fDuration, hkvVec4( v2Start.x, v2Start.y, 0.f, 0.f ), hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), false, pfEaseMethod );
+}
+
+void GUITimeline::AddTrack( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec4& v4Start, const hkvVec4& v4Target, const bool bFromCurrent, const pfEase pfEaseMethod )
+{
+	VASSERT( pTarget );
+	if ( !pTarget ) return;
+
+	const float fStartTime = ( m_bInParallel ? m_fParallelStart : m_fCursor ) + m_fPendingDelay;
+	m_fPendingDelay = 0.f;
+
+	m_aTracks.EnsureSize( m_uiNumTracks + 1 );
+	Track& tTrack = m_aTracks.GetDataPtr()[ m_uiNumTracks ];
+	tTrack.m_pTarget = pTarget;
+	tTrack.m_eProperty = eProperty;
+	tTrack.m_fStartTime = fStartTime;
+	tTrack.m_fEndTime = fStartTime + hkvMath::Max( fDuration, 0.f );
+	tTrack.m_v4Start = v4Start;
+	tTrack.m_v4Target = v4Target;
+	tTrack.m_pfEase = pfEaseMethod ? pfEaseMethod : Easing::Linear::EaseIn;
+	tTrack.m_uiEaseToken = GUIEasingCurve::GetEaseToken( tTrack.m_pfEase );
+	tTrack.m_bFromCurrent = bFromCurrent;
+	tTrack.m_uiSeq = m_uiNumTracks;
+	tTrack.m_uiChannel = 0;
+	m_uiNumTracks++;
+
+	if ( m_bInParallel ) m_fParallelEnd = hkvMath::Max( m_fParallelEnd, tTrack.m_fEndTime );
+	else m_fCursor = tTrack.m_fEndTime;
+	m_bDirty = true;
+}
+
+/*
+	Segments are copied, the clip can be unloaded afterwards
+*/
+void GUITimeline::AddClip( const GUIAnimClip* pClip, GUIAnimation* pTarget )
+{
+	VASSERT( pClip );
+	if ( !pClip ) return;
+
+	const bool bWasInParallel = m_bInParallel;
+	BeginParallel();
+	const float fPendingDelay = m_fPendingDelay;
+	for ( unsigned int i = 0; i < pClip->GetNumSegments(); i++ )
+	{
+		const GUIAnimClip::Segment& tSegment = pClip->GetSegment(i);
+		m_fPendingDelay = fPendingDelay + tSegment.m_fStartTime;
+		AddTrack( pTarget, tSegment.m_eProperty, tSegment.m_fDuration, tSegment.m_v4Start, tSegment.m_v4Target, false, tSegment.m_pfEase );
+	}
+	m_fPendingDelay = 0.f;
+	if ( !bWasInParallel ) EndParallel();
+}
+
+void GUITimeline::Delay( const float fDelay )
+{
+	if ( m_bInParallel ) m_fPendingDelay += fDelay;
+	else m_fCursor += fDelay;
+}
+
+void GUITimeline::BeginParallel()
+{
+	if ( m_bInParallel ) return;
+	m_bInParallel = true;
+	m_fParallelStart = m_fCursor;
+	m_fParallelEnd = m_fCursor;
+}
+
+void GUITimeline::EndParallel()
+{
+	if ( !m_bInParallel ) return;
+	m_bInParallel = false;
+	m_fPendingDelay = 0.f;
+	// The sequence continues when the longest step of the group ends
+	m_fCursor = hkvMath::Max( m_fCursor, m_fParallelEnd );
+}
+
+void GUITimeline::AddLabel( const std::string& sLabel )
+{
+	m_hLabels[sLabel] = m_bInParallel ? m_fParallelStart : m_fCursor;
+}
+
+void GUITimeline::At( const float fTime )
+{
+	const float fCursor = hkvMath::Max( fTime, 0.f );
+	if ( m_bInParallel ) m_fParallelStart = fCursor;
+	else m_fCursor = fCursor;
+}
+
+void GUITimeline::At( const std::string& sLabel, const float fOffset )
+{
+	At( GetLabelTime( sLabel ) + fOffset );
+}
+
+float GUITimeline::GetLabelTime( const std::string& sLabel ) const
+{
+	std::map< std::string, float >::const_iterator it = m_hLabels.find( sLabel );
+	VASSERT( it != m_hLabels.end() );
+	return ( it != m_hLabels.end() ) ? it->second : 0.f;
+}
+
+void GUITimeline::Clear()
+{
+	m_uiNumTracks = 0;
+	m_uiNumChannels = 0;
+	m_hLabels.clear();
+	m_fDuration = 0.f;
+	m_fCursor = 0.f;
+	m_fPendingDelay = 0.f;
+	m_bInParallel = false;
+	m_bDirty = false;
+	Stop();
+}
+
+void GUITimeline::RemoveTarget( const GUIAnimation* pTarget )
+{
+	unsigned int uiNumKept = 0;
+	Track* pTracks = m_aTracks.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumTracks; i++ )
+		if ( pTracks[i].m_pTarget != pTarget ) pTracks[ uiNumKept++ ] = pTracks[i];
+	if ( uiNumKept == m_uiNumTracks ) return;
+	m_uiNumTracks = uiNumKept;
+	m_bDirty = true;
+}
+
+/*
+	Sorts the tracks by start time, groups them by target property and resolves the start of 'To' tracks
+*/
+void GUITimeline::Compile()
+{
+	m_bDirty = false;
+	Track* pTracks = m_aTracks.GetDataPtr();
+	std::sort( pTracks, pTracks + m_uiNumTracks, CompareTracks );
+
+	m_uiNumChannels = 0;
+	m_fDuration = 0.f;
+	for ( unsigned int i = 0; i < m_uiNumTracks; i++ )
+	{
+		Track& tTrack = pTracks[i];
+		tTrack.m_uiSeq = i;
+		m_fDuration = hkvMath::Max( m_fDuration, tTrack.m_fEndTime );
+
+		unsigned int uiChannel = 0;
+		while ( uiChannel < m_uiNumChannels && ( m_aChannels[uiChannel].m_pTarget != tTrack.m_pTarget || m_aChannels[uiChannel].m_eProperty != tTrack.m_eProperty ) )
+			uiChannel++;
+
+		Channel& tChannel = m_aChannels[uiChannel];
+		if ( uiChannel == m_uiNumChannels )
+		{ // First track on this property
+			tChannel = Channel();
+			tChannel.m_pTarget = tTrack.m_pTarget;
+			tChannel.m_eProperty = tTrack.m_eProperty;
+			tChannel.m_iFirstTrack = static_cast<int>(i);
+			m_uiNumChannels++;
+			if ( tTrack.m_bFromCurrent ) tTrack.m_v4Start = tTrack.m_pTarget->GetBaseValue( tTrack.m_eProperty );
+		}
+		else if ( tTrack.m_bFromCurrent )
+		{ // Continues from where the previous track left it
+			tTrack.m_v4Start = pTracks[ tChannel.m_iCurrentTrack ].m_v4Target;
+		}
+		tChannel.m_iCurrentTrack = static_cast<int>(i);
+		tTrack.m_uiChannel = uiChannel;
+	}
+
+	for ( unsigned int i = 0; i < m_uiNumChannels; i++ )
+		m_aChannels[i].m_iCurrentTrack = -1;
+}
+
+bool GUITimeline::CompareTracks( const Track& tTrack0, const Track& tTrack1 )
+{
+	if ( tTrack0.m_fStartTime != tTrack1.m_fStartTime ) return tTrack0.m_fStartTime < tTrack1.m_fStartTime;
+	return tTrack0.m_uiSeq < tTrack1.m_uiSeq;
+}
+
+float GUITimeline::GetDuration()
+{
+	if ( m_bDirty ) Compile();
+	return m_fDuration;
+}
+
+void GUITimeline::Play()
+{
+	if ( m_bDirty ) Compile();
+	if ( m_bFinished )
+	{ // Start over
+		m_fTime = 0.f;
+		m_bFinished = false;
+	}
+	m_bPlaying = true;
+
+	// Bound channels take over their properties from the tweens and springs running on them
+	for ( unsigned int i = 0; i < m_uiNumChannels; i++ )
+	{
+		m_aChannels[i].m_pTarget->OverrideAnimTypeIfExists( m_aChannels[i].m_eProperty );
+		m_aChannels[i].m_pTarget->StopSpring( m_aChannels[i].m_eProperty );
+	}
+}
+
+void GUITimeline::Stop()
+{
+	m_bPlaying = false;
+	m_bFinished = false;
+	m_fTime = 0.f;
+	for ( unsigned int i = 0; i < m_uiNumChannels; i++ )
+	{
+		m_aChannels[i].m_iAppliedTrack = CHANNEL_UNTOUCHED;
+		m_aChannels[i].m_bSettled = false;
+	}
+}
+
+void GUITimeline::Seek( const float fTime )
+{
+	if ( m_bDirty ) Compile();
+	m_fTime = hkvMath::Max( fTime, 0.f );
+	m_bFinished = false;
+	Evaluate( ToLocalTime( m_fTime ) );
+}
+
+void GUITimeline::Seek( const std::string& sLabel )
+{
+	Seek( GetLabelTime( sLabel ) );
+}
+
+/*
+	Called by the manager once per frame
+*/
+void GUITimeline::Advance( const float fDeltaTime )
+{
+	if ( !m_bPlaying ) return;
+	if ( m_bDirty ) Compile();
+
+	m_fTime += fDeltaTime;
+	const bool bDone = ( m_iRepeat >= 0 ) && ( m_fTime >= m_fDuration * ( m_iRepeat + 1 ) );
+	if ( bDone ) m_fTime = m_fDuration * ( m_iRepeat + 1 );
+	Evaluate( ToLocalTime( m_fTime ) );
+
+	if ( bDone )
+	{
+		m_bPlaying = false;
+		m_bFinished = true;
+		if ( m_pfOnComplete ) m_pfOnComplete( this );
+	}
+}
+
+/*
+	Time inside the current play, backwards on odd plays when yoyo is set
+*/
+float GUITimeline::ToLocalTime( const float fTime ) const
+{
+	if ( m_fDuration <= 0.f ) return 0.f;
+
+	float fPlay = hkvMath::floor( fTime / m_fDuration );
+	if ( m_iRepeat >= 0 ) fPlay = hkvMath::Min( fPlay, static_cast<float>(m_iRepeat) ); // End of the last play
+	const float fLocalTime = hkvMath::clamp( fTime - fPlay * m_fDuration, 0.f, m_fDuration );
+	const bool bBackwards = m_bYoyo && ( static_cast<int>(fPlay) % 2 == 1 );
+	return bBackwards ? m_fDuration - fLocalTime : fLocalTime;
+}
+
+/*
+	Each property takes the value of its latest started track: interpolated while it runs, its target once it ended.
+	Settled properties are not written again, so idle elements can sleep while the timeline plays
+*/
+void GUITimeline::Evaluate( const float fLocalTime )
+{
+	const Track* pTracks = m_aTracks.GetDataPtr();
+	Channel* pChannels = m_aChannels.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumChannels; i++ )
+		pChannels[i].m_iCurrentTrack = -1;
+
+	// Sorted by start time, stop at the first track not started yet
+	for ( unsigned int i = 0; i < m_uiNumTracks && pTracks[i].m_fStartTime <= fLocalTime; i++ )
+		pChannels[ pTracks[i].m_uiChannel ].m_iCurrentTrack = static_cast<int>(i);
+
+	for ( unsigned int i = 0; i < m_uiNumChannels; i++ )
+	{
+		Channel& tChannel = pChannels[i];
+		if ( tChannel.m_iCurrentTrack < 0 )
+		{ // Before its first track, only restored if the timeline wrote it already (yoyo, seek back)
+			if ( tChannel.m_iAppliedTrack == CHANNEL_UNTOUCHED || tChannel.m_iAppliedTrack == CHANNEL_REWOUND ) continue;
+			const Track& tFirst = pTracks[ tChannel.m_iFirstTrack ];
+			tChannel.m_pTarget->ApplyTimelineValue( tChannel.m_eProperty, tFirst.m_v4Start );
+			tChannel.m_iAppliedTrack = CHANNEL_REWOUND;
+			tChannel.m_bSettled = false;
+			continue;
+		}
+
+		const Track& tTrack = pTracks[ tChannel.m_iCurrentTrack ];
+		if ( fLocalTime >= tTrack.m_fEndTime )
+		{
+			if ( tChannel.m_bSettled && tChannel.m_iAppliedTrack == tChannel.m_iCurrentTrack ) continue;
+			tChannel.m_pTarget->ApplyTimelineValue( tChannel.m_eProperty, tTrack.m_v4Target );
+			tChannel.m_bSettled = true;
+		}
+		else
+		{
+			const float fEasePos = GUIEasingCurve::Resolve( tTrack.m_pfEase, tTrack.m_uiEaseToken )( ( fLocalTime - tTrack.m_fStartTime ) / ( tTrack.m_fEndTime - tTrack.m_fStartTime ) );
+			hkvVec4 v4Value;
+			v4Value.setInterpolate( tTrack.m_v4Start, tTrack.m_v4Target, fEasePos );
+			tChannel.m_pTarget->ApplyTimelineValue( tChannel.m_eProperty, v4Value );
+			tChannel.m_bSettled = false;
+		}
+		tChannel.m_iAppliedTrack = tChannel.m_iCurrentTrack;
+	}
+}
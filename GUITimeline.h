@@ -0,0 +1,154 @@
+#ifndef GUITIMELINE_H_INCLUDED
+#define GUITIMELINE_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+#include <string>
+#include <map>
+
+
+class GUITimeline;
+class GUIAnimClip;
+
+// Timeline completion callback
+typedef void (*pfGUITimelineCallback)(GUITimeline* pSender);
+
+
+/*
+	Whole transition (sequences, parallel groups, delays, labels) built once and compiled into a flat list of
+	tracks sorted by start time. Playing it is a single entry in the manager update: every frame the tracks are
+	evaluated at the timeline local time, so there is no allocation nor callback between steps.
+	Steps are placed one after another unless they are added between BeginParallel and EndParallel, where they
+	all start together. 'To' steps start from the value the property has when the previous step on the same
+	property ends (or from the current value when it is the first one), resolved at compile time.
+	Values are applied like tween values, below the additive offsets. Playing stops the tweens and springs running on
+	the animated properties, and so does each write of the timeline to a property.
+	Created and owned by GUIAnimationManager.
+*/
+class GUITimeline
+{
+	friend class GUIAnimationManager;
+
+public:
+	// Building. Changes are compiled on the next Play or Seek
+	void To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const float fTarget, const pfEase pfEaseMethod );
+	void To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const VColorRef& tTarget, const pfEase pfEaseMethod );
+	void To( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec2& v2Target, const pfEase pfEaseMethod );
+	void FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const float fStart, const float fTarget, const pfEase pfEaseMethod );
+	void FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const VColorRef& tStart, const VColorRef& tTarget, const pfEase pfEaseMethod );
+	void FromTo( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec2& v2Start, const hkvVec2& v2Target, const pfEase pfEaseMethod );
+	// In a parallel group the delay only shifts the next step (stagger)
+	void Delay( const float fDelay );
+	void BeginParallel();
+	void EndParallel();
+	// Names the current insertion time
+	void AddLabel( const std::string& sLabel );
+	// Moves the insertion time, next steps are placed from there
+	void At( const float fTime );
+	void At( const std::string& sLabel, const float fOffset = 0.f );
+	// Every segment of the clip applied to pTarget, as a group starting at the insertion time
+	void AddClip( const GUIAnimClip* pClip, GUIAnimation* pTarget );
+	void Clear();
+	// Removes every step animating pTarget
+	void RemoveTarget( const GUIAnimation* pTarget );
+
+	// Extra plays after the first one, -1 repeats forever
+	void SetRepeat( const int iRepeat ) { m_iRepeat = iRepeat; }
+	int GetRepeat() const { return m_iRepeat; }
+	// Odd plays run backwards
+	void SetYoyo( const bool bYoyo ) { m_bYoyo = bYoyo; }
+	bool IsYoyo() const { return m_bYoyo; }
+	void SetTimeGroup( const unsigned int uiGroup ) { m_uiTimeGroup = uiGroup; }
+	unsigned int GetTimeGroup() const { return m_uiTimeGroup; }
+	void SetAffectedByTimeScale( const bool bAffected ) { m_bAffectedByTimeScale = bAffected; }
+	void SetOnComplete( const pfGUITimelineCallback pfCallback ) { m_pfOnComplete = pfCallback; }
+	// Destroyed by the manager once finished (after the completion callback)
+	void SetAutoDestroy( const bool bAutoDestroy ) { m_bAutoDestroy = bAutoDestroy; }
+
+	void Play();
+	void Pause() { m_bPlaying = false; }
+	// Stops and rewinds without touching the targets
+	void Stop();
+	void Seek( const float fTime );
+	void Seek( const std::string& sLabel );
+	bool IsPlaying() const { return m_bPlaying; }
+	bool IsFinished() const { return m_bFinished; }
+	float GetTime() const { return m_fTime; }
+	// Length of one play
+	float GetDuration();
+	float GetLabelTime( const std::string& sLabel ) const;
+	unsigned int GetNumTracks() const { return m_uiNumTracks; }
+
+private:
+	GUITimeline();
+	~GUITimeline();
+
+	struct Track
+	{
+		Track() : m_pTarget(0), m_eProperty(GAP_POSITION), m_fStartTime(0.f), m_fEndTime(0.f), m_pfEase(0), m_uiEaseToken(0), m_bFromCurrent(false), m_uiSeq(0), m_uiChannel(0) {}
+
+		GUIAnimation* m_pTarget;
+		eGUIAnimProperty m_eProperty;
+		float m_fStartTime;
+		float m_fEndTime;
+		hkvVec4 m_v4Start;
+		hkvVec4 m_v4Target;
+		pfEase m_pfEase;
+		unsigned int m_uiEaseToken; // Designer curve behind the ease, falls back to linear once destroyed
+		bool m_bFromCurrent; // 'To' step, start resolved on compile
+		unsigned int m_uiSeq; // Insertion index, keeps the sort stable
+		unsigned int m_uiChannel;
+	};
+
+	enum { CHANNEL_UNTOUCHED = -2, CHANNEL_REWOUND = -1 };
+
+	// Target property animated by one or more tracks
+	struct Channel
+	{
+		Channel() : m_pTarget(0), m_eProperty(GAP_POSITION), m_iFirstTrack(-1), m_iCurrentTrack(-1), m_iAppliedTrack(CHANNEL_UNTOUCHED), m_bSettled(false) {}
+
+		GUIAnimation* m_pTarget;
+		eGUIAnimProperty m_eProperty;
+		int m_iFirstTrack;
+		int m_iCurrentTrack; // Latest started track at the evaluated time
+		int m_iAppliedTrack; // Track whose value was applied last
+		bool m_bSettled; // Applied value is the end value of m_iAppliedTrack
+	};
+
+	void AddTrack( GUIAnimation* pTarget, const eGUIAnimProperty eProperty, const float fDuration, const hkvVec4& v4Start, const hkvVec4& v4Target, const bool bFromCurrent, const pfEase pfEaseMethod );
+	void Compile();
+	void Advance( const float fDeltaTime );
+	float ToLocalTime( const float fTime ) const;
+	void Evaluate( const float fLocalTime );
+	static bool CompareTracks( const Track& tTrack0, const Track& tTrack1 );
+
+	DynArray_cl<Track> m_aTracks;
+	unsigned int m_uiNumTracks;
+	DynArray_cl<Channel> m_aChannels;
+	unsigned int m_uiNumChannels;
+	std::map< std::string, float > m_hLabels;
+	bool m_bDirty;
+	float m_fDuration;
+
+	// Building cursor
+	float m_fCursor; // Start of the next sequential step
+	float m_fPendingDelay;
+	bool m_bInParallel;
+	float m_fParallelStart;
+	float m_fParallelEnd;
+
+	// Playback
+	float m_fTime; // Since the first play started, repeats included
+	int m_iRepeat;
+	bool m_bYoyo;
+	bool m_bPlaying;
+	bool m_bFinished;
+	bool m_bPendingDestroy;
+	bool m_bAutoDestroy;
+	unsigned int m_uiTimeGroup;
+	bool m_bAffectedByTimeScale;
+	pfGUITimelineCallback m_pfOnComplete;
+};
+
+
+#endif // GUITIMELINE_H_INCLUDED
@@ -0,0 +1,138 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUITweenRegistry.h"
+#include "GUIAnimationManager.h"
+
+
+// GUITweenHandle member functions
+EasingAnimation* GUITweenHandle::Get() const
+{
+	return GUIAnimationManager::Instance().GetTweenRegistry().Resolve( *this );
+}
+
+bool GUITweenHandle::IsFinished() const
+{
+	const EasingAnimation* pTween = Get();
+	return !pTween || pTween->IsFinished();
+}
+
+void GUITweenHandle::Play() const
+{
+	EasingAnimation* pTween = Get();
+	if ( pTween && !pTween->IsFinished() ) pTween->Play();
+}
+
+void GUITweenHandle::Pause() const
+{
+	EasingAnimation* pTween = Get();
+	if ( pTween && !pTween->IsFinished() ) pTween->Pause();
+}
+
+void GUITweenHandle::Kill() const
+{
+	EasingAnimation* pTween = Get();
+	if ( pTween ) pTween->Stop();
+}
+
+void GUITweenHandle::SetAutoreverse( const bool bAutoreverse ) const
+{
+	EasingAnimation* pTween = Get();
+	if ( pTween ) pTween->SetAutoreverse( bAutoreverse );
+}
+
+bool GUITweenHandle::Retarget( const float fTarget, const float fDuration ) const
+{
+	EasingAnimation* pTween = Get();
+	return pTween && pTween->Retarget( hkvVec4( fTarget, 0.f, 0.f, 0.f ), fDuration );
+}
+
+bool GUITweenHandle::Retarget( const hkvVec2& v2Target, const float fDuration ) const
+{
+	EasingAnimation* pTween = Get();
+	return pTween && pTween->Retarget( hkvVec4( v2Target.x, v2Target.y, 0.f, 0.f ), fDuration );
+}
+
+bool GUITweenHandle::Retarget( const VColorRef& tTarget, const float fDuration ) const
+{
+	EasingAnimation* pTween = Get();
+	return pTween && pTween->Retarget( hkvVec4( tTarget.r, tTarget.g, tTarget.b, 0.f ), fDuration );
+}
+
+
+// GUITweenRegistry member functions
+GUITweenRegistry::GUITweenRegistry()
+{
+	m_aSlots.Init( Slot() );
+	m_uiNumSlots = 0;
+	m_iFirstFree = -1;
+	m_uiNumAlive = 0;
+}
+
+GUITweenRegistry::~GUITweenRegistry()
+{
+	Slot* pSlots = m_aSlots.GetDataPtr();
+	for ( unsigned int i = 0; i < m_uiNumSlots; i++ )
+	{
+		if ( pSlots[i].m_pTween ) delete pSlots[i].m_pTween;
+		pSlots[i].m_pTween = 0;
+	}
+	m_aSlots.Reset();
+	m_uiNumSlots = 0;
+	m_iFirstFree = -1;
+	m_uiNumAlive = 0;
+}
+
+/*
+	Creates free slots (and their tweens) up front, e.g. before a heavy menu transition
+*/
+void GUITweenRegistry::Reserve( const unsigned int uiNumTweens )
+{
+	while ( m_uiNumSlots < uiNumTweens )
+	{
+		const int iSlot = AddSlot();
+		m_aSlots.GetDataPtr()[iSlot].m_iNextFree = m_iFirstFree;
+		m_iFirstFree = iSlot;
+	}
+}
+
+int GUITweenRegistry::AddSlot()
+{
+	m_aSlots.EnsureSize( m_uiNumSlots + 1 );
+	Slot& tSlot = m_aSlots.GetDataPtr()[ m_uiNumSlots ];
+	tSlot = Slot();
+	tSlot.m_pTween = new EasingAnimation();
+	return static_cast<int>(m_uiNumSlots++);
+}
+
+int GUITweenRegistry::Acquire()
+{
+	int iSlot = m_iFirstFree;
+	if ( iSlot >= 0 ) m_iFirstFree = m_aSlots.GetDataPtr()[iSlot].m_iNextFree;
+	else iSlot = AddSlot();
+
+	Slot& tSlot = m_aSlots.GetDataPtr()[iSlot];
+	tSlot.m_bAlive = true;
+	tSlot.m_iNextFree = -1;
+	m_uiNumAlive++;
+	return iSlot;
+}
+
+void GUITweenRegistry::Release( const int iSlot )
+{
+	if ( iSlot < 0 || static_cast<unsigned int>(iSlot) >= m_uiNumSlots ) return;
+	Slot& tSlot = m_aSlots.GetDataPtr()[iSlot];
+	if ( !tSlot.m_bAlive ) return;
+
+	tSlot.m_bAlive = false;
+	tSlot.m_uiGeneration++; // Handles to the old tween stop resolving
+	if ( tSlot.m_uiGeneration == 0 ) tSlot.m_uiGeneration = 1; // 0 is never valid
+	tSlot.m_iNextFree = m_iFirstFree;
+	m_iFirstFree = iSlot;
+	m_uiNumAlive--;
+}
+
+EasingAnimation* GUITweenRegistry::Resolve( const GUITweenHandle& tHandle ) const
+{
+	if ( tHandle.m_iSlot < 0 || static_cast<unsigned int>(tHandle.m_iSlot) >= m_uiNumSlots ) return 0;
+	const Slot& tSlot = m_aSlots.GetDataPtr()[ tHandle.m_iSlot ];
+	return ( tSlot.m_bAlive && tSlot.m_uiGeneration == tHandle.m_uiGeneration ) ? tSlot.m_pTween : 0;
+}
@@ -0,0 +1,84 @@
+#ifndef GUITWEENREGISTRY_H_INCLUDED
+#define GUITWEENREGISTRY_H_INCLUDED
+
+#include "GlobalTypes.h"
+
+
+class EasingAnimation;
+
+
+/*
+	Reference to a tween of the registry. Released tweens bump their slot generation, so a handle kept across
+	frames becomes invalid instead of dangling. Every call is O(1) and does nothing on an invalid handle.
+*/
+struct GUITweenHandle
+{
+	GUITweenHandle() : m_iSlot(-1), m_uiGeneration(0) {}
+	GUITweenHandle( const int iSlot, const unsigned int uiGeneration ) : m_iSlot(iSlot), m_uiGeneration(uiGeneration) {}
+
+	// Tween still alive (running, paused or finished this frame)
+	bool IsValid() const { return Get() != 0; }
+	// Finished, stopped or already released
+	bool IsFinished() const;
+	void Play() const;
+	void Pause() const;
+	// Stops the tween without completion callback, it is released on the next update
+	void Kill() const;
+	void SetAutoreverse( const bool bAutoreverse ) const;
+	// New target from the current value, keeping the velocity. False if the handle is not valid or finished
+	bool Retarget( const float fTarget, const float fDuration ) const;
+	bool Retarget( const hkvVec2& v2Target, const float fDuration ) const;
+	bool Retarget( const VColorRef& tTarget, const float fDuration ) const;
+	// Only valid until the tween is released, do not keep it
+	EasingAnimation* Get() const;
+
+	bool operator==( const GUITweenHandle& tOther ) const { return m_iSlot == tOther.m_iSlot && m_uiGeneration == tOther.m_uiGeneration; }
+	bool operator!=( const GUITweenHandle& tOther ) const { return !( *this == tOther ); }
+
+	int m_iSlot;
+	unsigned int m_uiGeneration;
+};
+
+
+/*
+	Pool of every easing animation, owned by GUIAnimationManager. Released slots go to a free list and their
+	tween object is reused, so starting a tween does not allocate once the pool is warm.
+*/
+class GUITweenRegistry
+{
+public:
+	GUITweenRegistry();
+	~GUITweenRegistry();
+
+	void Reserve( const unsigned int uiNumTweens );
+	int Acquire();
+	void Release( const int iSlot );
+
+	EasingAnimation* GetTween( const int iSlot ) const { return m_aSlots.GetDataPtr()[iSlot].m_pTween; }
+	EasingAnimation* Resolve( const GUITweenHandle& tHandle ) const;
+	GUITweenHandle GetHandle( const int iSlot ) const { return GUITweenHandle( iSlot, m_aSlots.GetDataPtr()[iSlot].m_uiGeneration ); }
+
+	unsigned int GetNumAlive() const { return m_uiNumAlive; }
+	unsigned int GetNumSlots() const { return m_uiNumSlots; }
+
+private:
+	struct Slot
+	{
+		Slot() : m_pTween(0), m_uiGeneration(1), m_iNextFree(-1), m_bAlive(false) {}
+
+		EasingAnimation* m_pTween;
+		unsigned int m_uiGeneration;
+		int m_iNextFree;
+		bool m_bAlive;
+	};
+
+	int AddSlot();
+
+	DynArray_cl<Slot> m_aSlots;
+	unsigned int m_uiNumSlots;
+	int m_iFirstFree;
+	unsigned int m_uiNumAlive;
+};
+
+
+#endif // GUITWEENREGISTRY_H_INCLUDED
@@ -0,0 +1,227 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIVirtualList.h"
+#include "GUIAnimationManager.h"
+
+
+#define DRAG_VELOCITY_SMOOTHING 0.5f
+
+
+GUIVirtualList::GUIVirtualList( GUIAnimation* pHost, const float fRowHeight, const float fViewportHeight )
+{
+	m_pHost = pHost;
+	m_aRows.Init(0);
+	m_aRowItems.Init(-1);
+	m_uiNumRows = 0;
+	m_uiNumItems = 0;
+	m_fRowHeight = hkvMath::Max( fRowHeight, 1.f );
+	m_fViewportHeight = fViewportHeight;
+	if ( m_fViewportHeight <= 0.f )
+	{ // Whole host, or screen
+		float fHostWidth;
+		if ( pHost && pHost->GetTexture() ) pHost->GetTexture()->GetTargetSize( fHostWidth, m_fViewportHeight );
+		else m_fViewportHeight = static_cast<float>(Vision::Video.GetYRes());
+	}
+
+	m_uiScrollItem = 0;
+	m_fScrollRemainder = 0.f;
+	m_fVelocity = 0.f;
+	m_fDeceleration = GUI_VLIST_DEFAULT_DECELERATION;
+	m_bDragging = false;
+	m_fDragPixels = 0.f;
+	m_fDragVelocity = 0.f;
+	m_bLayoutDirty = true;
+
+	m_pfBindCallback = 0;
+	m_pUserData = 0;
+	m_uiLastBound = 0;
+}
+
+/*
+	Rows are deleted by GUIAnimationManager::DestroyVirtualList, or with every other element on shutdown
+*/
+GUIVirtualList::~GUIVirtualList()
+{
+	m_aRows.Reset();
+	m_aRowItems.Reset();
+	m_uiNumRows = 0;
+}
+
+void GUIVirtualList::SetRows( GUIAnimation** ppRows, const unsigned int uiNumRows )
+{
+	m_aRows.EnsureSize( uiNumRows );
+	m_aRowItems.EnsureSize( uiNumRows );
+	for ( unsigned int i = 0; i < uiNumRows; i++ )
+	{
+		m_aRows[i] = ppRows[i];
+		m_aRowItems[i] = -1;
+	}
+	m_uiNumRows = uiNumRows;
+	m_bLayoutDirty = true;
+}
+
+void GUIVirtualList::SetNumItems( const unsigned int uiNumItems )
+{
+	m_uiNumItems = uiNumItems;
+	SetScroll( m_uiScrollItem, m_fScrollRemainder ); // Clamp to the new content
+	m_bLayoutDirty = true;
+}
+
+void GUIVirtualList::Refresh()
+{
+	for ( unsigned int i = 0; i < m_uiNumRows; i++ )
+		m_aRowItems[i] = -1;
+	m_bLayoutDirty = true;
+}
+
+void GUIVirtualList::RefreshItem( const unsigned int uiItemIndex )
+{
+	if ( m_uiNumRows == 0 ) return;
+	const unsigned int uiRow = uiItemIndex % m_uiNumRows;
+	if ( m_aRowItems[uiRow] != static_cast<int>(uiItemIndex) ) return;
+	m_aRowItems[uiRow] = -1;
+	m_bLayoutDirty = true;
+}
+
+float GUIVirtualList::GetMaxScrollOffset() const
+{
+	unsigned int uiMaxItem;
+	float fMaxRemainder;
+	GetMaxScroll( uiMaxItem, fMaxRemainder );
+	return uiMaxItem * m_fRowHeight + fMaxRemainder;
+}
+
+/*
+	Last item shown at the viewport bottom, in whole rows plus a remainder
+*/
+void GUIVirtualList::GetMaxScroll( unsigned int& uiItem, float& fRemainder ) const
+{
+	const unsigned int uiViewportRows = static_cast<unsigned int>( m_fViewportHeight / m_fRowHeight );
+	const float fViewportRest = m_fViewportHeight - uiViewportRows * m_fRowHeight;
+	uiItem = 0;
+	fRemainder = 0.f;
+	if ( m_uiNumItems <= uiViewportRows ) return;
+	if ( fViewportRest > 0.f )
+	{
+		uiItem = m_uiNumItems - uiViewportRows - 1;
+		fRemainder = m_fRowHeight - fViewportRest;
+	}
+	else
+	{
+		uiItem = m_uiNumItems - uiViewportRows;
+	}
+}
+
+/*
+	Whole rows of the remainder are moved to the item index, then the position is clamped to the content
+*/
+void GUIVirtualList::SetScroll( unsigned int uiItem, float fRemainder )
+{
+	const float fRows = hkvMath::floor( fRemainder / m_fRowHeight );
+	fRemainder = hkvMath::clamp( fRemainder - fRows * m_fRowHeight, 0.f, m_fRowHeight );
+	if ( fRemainder >= m_fRowHeight )
+	{ // Rounded up from just below zero
+		fRemainder = 0.f;
+		uiItem++;
+	}
+	if ( fRows >= 0.f ) uiItem += static_cast<unsigned int>( hkvMath::Min( fRows, static_cast<float>(m_uiNumItems) ) );
+	else if ( -fRows > uiItem ) { uiItem = 0; fRemainder = 0.f; } // Before the first item
+	else uiItem -= static_cast<unsigned int>( -fRows );
+
+	unsigned int uiMaxItem;
+	float fMaxRemainder;
+	GetMaxScroll( uiMaxItem, fMaxRemainder );
+	if ( uiItem > uiMaxItem || ( uiItem == uiMaxItem && fRemainder > fMaxRemainder ) )
+	{
+		uiItem = uiMaxItem;
+		fRemainder = fMaxRemainder;
+	}
+
+	if ( uiItem == m_uiScrollItem && fRemainder == m_fScrollRemainder ) return;
+	m_uiScrollItem = uiItem;
+	m_fScrollRemainder = fRemainder;
+	m_bLayoutDirty = true;
+}
+
+void GUIVirtualList::BeginDrag()
+{
+	m_bDragging = true;
+	m_fVelocity = 0.f;
+	m_fDragPixels = 0.f;
+	m_fDragVelocity = 0.f;
+}
+
+void GUIVirtualList::EndDrag()
+{
+	if ( !m_bDragging ) return;
+	m_bDragging = false;
+	m_fVelocity = m_fDragVelocity;
+}
+
+GUIAnimation* GUIVirtualList::GetRowForItem( const unsigned int uiItemIndex ) const
+{
+	if ( m_uiNumRows == 0 ) return 0;
+	const unsigned int uiRow = uiItemIndex % m_uiNumRows;
+	return ( m_aRowItems.GetDataPtr()[uiRow] == static_cast<int>(uiItemIndex) ) ? m_aRows.GetDataPtr()[uiRow] : 0;
+}
+
+void GUIVirtualList::OnRowDestroyed( GUIAnimation* pRow )
+{
+	for ( unsigned int i = 0; i < m_uiNumRows; i++ )
+		if ( m_aRows[i] == pRow ) m_aRows[i] = 0;
+}
+
+void GUIVirtualList::Update( const float fDeltaTime )
+{
+	if ( m_bDragging )
+	{ // Release speed
+		if ( fDeltaTime > 0.f ) m_fDragVelocity = hkvMath::interpolate( m_fDragVelocity, m_fDragPixels / fDeltaTime, DRAG_VELOCITY_SMOOTHING );
+		m_fDragPixels = 0.f;
+	}
+	else if ( m_fVelocity != 0.f )
+	{ // Momentum, stops at the content ends
+		const unsigned int uiPrevItem = m_uiScrollItem;
+		const float fPrevRemainder = m_fScrollRemainder;
+		ScrollBy( m_fVelocity * fDeltaTime );
+		m_fVelocity *= hkvMath::exp( -m_fDeceleration * fDeltaTime );
+		const bool bStuck = ( m_uiScrollItem == uiPrevItem && m_fScrollRemainder == fPrevRemainder );
+		if ( bStuck || hkvMath::Abs( m_fVelocity ) < GUI_VLIST_MIN_VELOCITY ) m_fVelocity = 0.f;
+	}
+
+	m_uiLastBound = 0;
+	if ( m_bLayoutDirty ) Layout();
+}
+
+/*
+	Visits the rows once: item first + k goes to row (first + k) % rows
+*/
+void GUIVirtualList::Layout()
+{
+	m_bLayoutDirty = false;
+	if ( m_uiNumRows == 0 ) return;
+
+	const unsigned int uiFirst = m_uiScrollItem;
+	const float fFirstY = -m_fScrollRemainder; // Within one row, exact whatever the item index
+	for ( unsigned int k = 0; k < m_uiNumRows; k++ )
+	{
+		const unsigned int uiItem = uiFirst + k;
+		const unsigned int uiRow = uiItem % m_uiNumRows;
+		GUIAnimation* pRow = m_aRows[uiRow];
+		if ( !pRow ) continue;
+
+		if ( uiItem >= m_uiNumItems )
+		{ // Past the last item
+			if ( m_aRowItems[uiRow] != -1 || pRow->IsVisible() ) pRow->SetVisible( false );
+			m_aRowItems[uiRow] = -1;
+			continue;
+		}
+
+		if ( m_aRowItems[uiRow] != static_cast<int>(uiItem) )
+		{
+			m_aRowItems[uiRow] = static_cast<int>(uiItem);
+			if ( !pRow->IsVisible() ) pRow->SetVisible( true );
+			if ( m_pfBindCallback ) m_pfBindCallback( this, pRow, uiItem );
+			m_uiLastBound++;
+		}
+		pRow->PixelPositionFromTopLeft( fFirstY + k * m_fRowHeight, 0.f );
+	}
+}
@@ -0,0 +1,103 @@
+#ifndef GUIVIRTUALLIST_H_INCLUDED
+#define GUIVIRTUALLIST_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUIAnimation.h"
+
+
+#define GUI_VLIST_DEFAULT_DECELERATION 4.f // Velocity lost per second, exponential
+#define GUI_VLIST_MIN_VELOCITY 5.f // Pixels per second under which momentum stops
+
+
+class GUIVirtualList;
+typedef void (*pfGUIVirtualListBindCallback)(GUIVirtualList* pSender, GUIAnimation* pRow, const unsigned int uiItemIndex);
+
+
+/*
+	Vertical list of any number of items backed by a fixed set of row elements, as many as fit in the viewport plus one.
+	Item j is always shown by row j % rows, so scrolling only rebinds the rows whose item changed (bind callback) and
+	repositions the rest: the per-frame cost depends on the viewport, not on the number of items.
+	Rows are created from a template, parented to the host and placed in pixels from its top left corner.
+	Scrolling is immediate (SetScrollOffset, ScrollBy, drag) or driven by momentum (Fling, EndDrag) on the manager
+	clock, using the host time group. Created and owned by GUIAnimationManager.
+*/
+class GUIVirtualList
+{
+	friend class GUIAnimationManager;
+
+public:
+	void SetBindCallback( pfGUIVirtualListBindCallback pfCallback ) { m_pfBindCallback = pfCallback; Refresh(); }
+	void SetUserData( void* pUserData ) { m_pUserData = pUserData; }
+	void* GetUserData() const { return m_pUserData; }
+
+	void SetNumItems( const unsigned int uiNumItems );
+	unsigned int GetNumItems() const { return m_uiNumItems; }
+	// Rebinds every shown row on the next update, after the data changed
+	void Refresh();
+	void RefreshItem( const unsigned int uiItemIndex );
+
+	// Offset in pixels of the viewport top from the first item top, clamped to the content. Kept as the first visible
+	// item plus the pixels scrolled past it, so scrolling stays exact on any number of items
+	void SetScrollOffset( const float fScrollOffset ) { SetScroll( 0, fScrollOffset ); }
+	void ScrollBy( const float fPixels ) { SetScroll( m_uiScrollItem, m_fScrollRemainder + fPixels ); }
+	void ScrollToItem( const unsigned int uiItemIndex ) { SetScroll( uiItemIndex, 0.f ); }
+	// Rounded to float precision on long lists
+	float GetScrollOffset() const { return m_uiScrollItem * m_fRowHeight + m_fScrollRemainder; }
+	float GetMaxScrollOffset() const;
+	float GetScrollRemainder() const { return m_fScrollRemainder; }
+	// Momentum in pixels per second
+	void Fling( const float fVelocity ) { m_fVelocity = fVelocity; }
+	void StopScrolling() { m_fVelocity = 0.f; }
+	bool IsScrolling() const { return m_fVelocity != 0.f || m_bDragging; }
+	void SetDeceleration( const float fDeceleration ) { m_fDeceleration = hkvMath::Max( fDeceleration, 0.f ); }
+	// Drag follows the pointer, the release flings with the drag speed
+	void BeginDrag();
+	void Drag( const float fPixels ) { ScrollBy( fPixels ); m_fDragPixels += fPixels; }
+	void EndDrag();
+
+	unsigned int GetFirstVisibleItem() const { return m_uiScrollItem; }
+	unsigned int GetNumRows() const { return m_uiNumRows; }
+	GUIAnimation* GetRow( const unsigned int uiRow ) const { return m_aRows.GetDataPtr()[uiRow]; }
+	// Row showing the item, null if not materialized
+	GUIAnimation* GetRowForItem( const unsigned int uiItemIndex ) const;
+	float GetRowHeight() const { return m_fRowHeight; }
+	float GetViewportHeight() const { return m_fViewportHeight; }
+	// Rows bound by the last update
+	unsigned int GetLastBound() const { return m_uiLastBound; }
+
+private:
+	GUIVirtualList( GUIAnimation* pHost, const float fRowHeight, const float fViewportHeight );
+	~GUIVirtualList();
+
+	void SetRows( GUIAnimation** ppRows, const unsigned int uiNumRows );
+	void SetScroll( unsigned int uiItem, float fRemainder );
+	void GetMaxScroll( unsigned int& uiItem, float& fRemainder ) const;
+	void Update( const float fDeltaTime );
+	void Layout();
+	void OnHostDestroyed() { m_pHost = 0; }
+	void OnRowDestroyed( GUIAnimation* pRow );
+
+	GUIAnimation* m_pHost;
+	DynArray_cl<GUIAnimation*> m_aRows;
+	DynArray_cl<int> m_aRowItems; // Item bound to each row, -1 if none
+	unsigned int m_uiNumRows;
+	unsigned int m_uiNumItems;
+	float m_fRowHeight;
+	float m_fViewportHeight;
+
+	unsigned int m_uiScrollItem; // First visible item
+	float m_fScrollRemainder; // Pixels of it above the viewport, [0, row height)
+	float m_fVelocity;
+	float m_fDeceleration;
+	bool m_bDragging;
+	float m_fDragPixels; // Dragged since the last update
+	float m_fDragVelocity; // Smoothed drag speed
+	bool m_bLayoutDirty;
+
+	pfGUIVirtualListBindCallback m_pfBindCallback;
+	void* m_pUserData;
+	unsigned int m_uiLastBound;
+};
+
+
+#endif // GUIVIRTUALLIST_H_INCLUDED
@@ -0,0 +1,96 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUIBenchmarks.h"
+#include "../GUIAnimationManager.h"
+#include "../GUIEasingCurve.h"
+#include "../GUIVirtualList.h"
+#include <ctime>
+
+
+namespace
+{
+	// Bind callback of a realistic cost: touches the row like a label update would
+	void BindRow( GUIVirtualList* pSender, GUIAnimation* pRow, const unsigned int uiItemIndex )
+	{
+		pRow->SetColor( ( uiItemIndex % 2 ) ? VColorRef( 255, 255, 255, 255 ) : VColorRef( 220, 220, 220, 255 ) );
+	}
+}
+
+
+void GUIBenchmarks::RunAll()
+{
+	// Built-in eases against curves solved into tables
+	Vision::Error.SystemMessage( "GUI bench ease Quartic.EaseOut: %.2f ns", BenchmarkEase( &Easing::Quartic::EaseOut ) );
+	Vision::Error.SystemMessage( "GUI bench ease Elastic.EaseOut: %.2f ns", BenchmarkEase( &Easing::Elastic::EaseOut ) );
+	Vision::Error.SystemMessage( "GUI bench ease Bounce.EaseOut: %.2f ns", BenchmarkEase( &Easing::Bounce::EaseOut ) );
+	GUIEasingCurve* pBezier = GUIEasingCurve::CreateCubicBezier( 0.25f, 0.1f, 0.25f, 1.f );
+	if ( pBezier )
+	{
+		Vision::Error.SystemMessage( "GUI bench ease cubic-bezier: %.2f ns", BenchmarkEase( pBezier->GetEase() ) );
+		GUIEasingCurve::Destroy( pBezier );
+	}
+	const hkvVec2 av2Keys[] = { hkvVec2( 0.f, 0.f ), hkvVec2( 0.3f, 0.8f ), hkvVec2( 0.7f, 0.9f ), hkvVec2( 1.f, 1.f ) };
+	GUIEasingCurve* pKeyframed = GUIEasingCurve::CreatePiecewise( av2Keys, 4, true );
+	if ( pKeyframed )
+	{
+		Vision::Error.SystemMessage( "GUI bench ease keyframed: %.2f ns", BenchmarkEase( pKeyframed->GetEase() ) );
+		GUIEasingCurve::Destroy( pKeyframed );
+	}
+
+	// Scrolling a long list costs the same per frame as a short one
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	GUIAnimationManager::AnimationTemplate tRow;
+	tRow.m_sSrcTexFilepathWithoutExtension = GUI_TESTS_PATH;
+	tRow.m_sFilename = GUI_TESTS_TEXTURE;
+	tRow.m_bTouchable = false;
+	const unsigned int auiNumItems[] = { 100, GUI_BENCH_LIST_ITEMS };
+	for ( unsigned int i = 0; i < 2; i++ )
+	{
+		GUIVirtualList* pList = tManager.CreateVirtualList( tRow, 0, 40.f, 400.f, auiNumItems[i] );
+		if ( !pList ) continue;
+		pList->SetBindCallback( BindRow );
+		unsigned int uiMaxBound = 0;
+		const float fMicroseconds = BenchmarkVirtualList( pList, GUI_BENCH_LIST_FRAMES, &uiMaxBound );
+		Vision::Error.SystemMessage( "GUI bench list %u items: %.2f us per frame, %u rows bound at most", auiNumItems[i], fMicroseconds, uiMaxBound );
+		tManager.DestroyVirtualList( pList );
+	}
+}
+
+float GUIBenchmarks::BenchmarkEase( const pfEase pfEaseMethod, const unsigned int uiNumCalls )
+{
+	if ( !pfEaseMethod || uiNumCalls == 0 ) return 0.f;
+
+	volatile float fSink = 0.f; // Keeps the calls from being optimized away
+	const float fStep = 1.f / uiNumCalls;
+	const clock_t tStart = clock();
+	for ( unsigned int i = 0; i < uiNumCalls; i++ )
+		fSink = fSink + pfEaseMethod( i * fStep );
+	const clock_t tEnd = clock();
+
+	return static_cast<float>( tEnd - tStart ) / CLOCKS_PER_SEC * 1000000000.f / uiNumCalls;
+}
+
+/*
+	Whole manager updates: the list is updated by the manager, with the rows it repositions and rebinds
+*/
+float GUIBenchmarks::BenchmarkVirtualList( GUIVirtualList* pList, const unsigned int uiNumFrames, unsigned int* puiMaxBound )
+{
+	if ( !pList || uiNumFrames == 0 ) return 0.f;
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	const float fStep = pList->GetMaxScrollOffset() / uiNumFrames;
+	unsigned int uiMaxBound = 0;
+
+	pList->StopScrolling();
+	pList->SetScrollOffset( 0.f );
+	tManager.Update( 0.f ); // Rows bound for the top, not measured
+	const clock_t tStart = clock();
+	for ( unsigned int i = 0; i < uiNumFrames; i++ )
+	{
+		pList->ScrollBy( fStep );
+		tManager.Update( 0.f );
+		uiMaxBound = hkvMath::Max( uiMaxBound, pList->GetLastBound() );
+	}
+	const float fMicroseconds = static_cast<float>( clock() - tStart ) * 1000000.f / CLOCKS_PER_SEC;
+
+	if ( puiMaxBound ) *puiMaxBound = uiMaxBound;
+	return fMicroseconds / uiNumFrames;
+}
@@ -0,0 +1,34 @@
+#ifndef GUIBENCHMARKS_H_INCLUDED
+#define GUIBENCHMARKS_H_INCLUDED
+
+#include "GlobalTypes.h"
+#include "GUITests.h"
+#include "../GUIAnimation.h"
+
+
+#define GUI_BENCH_EASE_CALLS 1000000
+#define GUI_BENCH_LIST_ITEMS 100000
+#define GUI_BENCH_LIST_FRAMES 1000
+
+
+class GUIVirtualList;
+
+
+/*
+	Timings of the GUI runtime, kept out of the runtime classes. CPU time measured with clock(), like the layout build
+	time, so compare runs of the same build on the same device. Run headless with the engine up, results are reported
+	with Vision::Error.SystemMessage. Uses the test texture of GUITests for the list rows.
+*/
+namespace GUIBenchmarks
+{
+	void RunAll();
+
+	// Average cost of an ease call in nanoseconds over uiNumCalls calls spread on 0..1
+	float BenchmarkEase( const pfEase pfEaseMethod, const unsigned int uiNumCalls = GUI_BENCH_EASE_CALLS );
+	// Scrolls the list from top to bottom in uiNumFrames fixed steps, updating it each step. Average update time in
+	// microseconds per frame; the most rows bound in a single frame is written to puiMaxBound (optional)
+	float BenchmarkVirtualList( GUIVirtualList* pList, const unsigned int uiNumFrames = GUI_BENCH_LIST_FRAMES, unsigned int* puiMaxBound = 0 );
+}
+
+
+#endif // GUIBENCHMARKS_H_INCLUDED
@@ -0,0 +1,365 @@
+#include "CutshumotoPluginPCH.h"
+#include "GUITests.h"
+#include "../GUIAnimationManager.h"
+#include "../GUIClock.h"
+#include "../GUITweenRegistry.h"
+#include "../GUIAnimClip.h"
+#include "../GUIContainer.h"
+#include "../GUITextureCache.h"
+#include "../GUISpriteBatch.h"
+#include <cstring>
+
+
+#define GUI_CHECK( bCondition ) Check( ( bCondition ), #bCondition, __FILE__, __LINE__, uiNumFailed )
+
+
+namespace
+{
+	bool Check( const bool bCondition, const char* pcExpression, const char* pcFile, const int iLine, unsigned int& uiNumFailed )
+	{
+		if ( bCondition ) return true;
+		Vision::Error.Warning( "GUI test failed: %s (%s:%d)", pcExpression, pcFile, iLine );
+		uiNumFailed++;
+		return false;
+	}
+
+	bool IsNear( const float fValue, const float fExpected, const float fEpsilon = 0.0001f )
+	{
+		return hkvMath::Abs( fValue - fExpected ) <= fEpsilon;
+	}
+
+	bool WriteTestFile( const std::string& sFilepath, const char* pcContent )
+	{
+		IVFileOutStream* pOut = Vision::File.Create( sFilepath.c_str() );
+		if ( !pOut ) return false;
+		const size_t uiSize = strlen( pcContent );
+		const bool bWritten = pOut->Write( pcContent, uiSize ) == uiSize;
+		pOut->Close();
+		return bWritten;
+	}
+
+	GUIAnimation* CreateTestElement( const char* pcTexture = GUI_TESTS_TEXTURE )
+	{
+		return GUIAnimationManager::Instance().CreateAnimation( GUI_TESTS_PATH, pcTexture, 0, 0, 0, static_cast<eGUIAnimID>(0) );
+	}
+
+	void DestroyTestElement( GUIAnimation* pAnim )
+	{
+		if ( !pAnim ) return;
+		GUIAnimationManager::Instance().RemoveAnimation( pAnim );
+		delete pAnim;
+	}
+}
+
+
+unsigned int GUITests::RunAll()
+{
+	unsigned int uiNumFailed = 0;
+	uiNumFailed += TestClock();
+	uiNumFailed += TestTweenFastForward();
+	uiNumFailed += TestTweenRegistry();
+	uiNumFailed += TestAnimClipRoundTrip();
+	uiNumFailed += TestContainerReflow();
+	uiNumFailed += TestTextureCache();
+	uiNumFailed += TestSpriteBatchHeadless();
+	if ( uiNumFailed == 0 ) Vision::Error.SystemMessage( "GUI tests passed" );
+	else Vision::Error.Warning( "GUI tests: %u failed checks", uiNumFailed );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestClock()
+{
+	unsigned int uiNumFailed = 0;
+	GUIClock tClock;
+
+	// Scaled time is fast-forwarded, real time is not
+	tClock.SetTimeScale( 4.f );
+	for ( unsigned int i = 0; i < 10; i++ )
+		tClock.Advance( 0.1f );
+	GUI_CHECK( IsNear( tClock.GetRealTime(), 1.f ) );
+	GUI_CHECK( IsNear( tClock.GetTime(), 4.f, 0.001f ) );
+	GUI_CHECK( IsNear( tClock.GetDeltaTime(), 0.4f ) );
+
+	// Paused group stands still, the others keep their own scale
+	tClock.SetGroupPaused( 1, true );
+	tClock.SetGroupTimeScale( 2, 0.5f );
+	const float fGroup1Time = tClock.GetTime( 1 );
+	const float fGroup2Time = tClock.GetTime( 2 );
+	tClock.Advance( 0.5f );
+	GUI_CHECK( tClock.GetTime( 1 ) == fGroup1Time );
+	GUI_CHECK( tClock.GetDeltaTime( 1 ) == 0.f );
+	GUI_CHECK( IsNear( tClock.GetTime( 2 ) - fGroup2Time, 1.f ) );
+
+	// Global pause
+	tClock.SetPaused( true );
+	const float fTime = tClock.GetTime();
+	tClock.Advance( 1.f );
+	GUI_CHECK( tClock.GetTime() == fTime );
+	GUI_CHECK( IsNear( tClock.GetRealDeltaTime(), 1.f ) );
+
+	// Fixed step: whole steps only, the remainder carried to the next advance (steps exact in binary)
+	GUIClock tStepped;
+	tStepped.SetFixedTimeStep( 0.25f );
+	tStepped.Advance( 0.625f );
+	GUI_CHECK( tStepped.GetStepsLastAdvance() == 2 );
+	GUI_CHECK( tStepped.GetTime() == 0.5f );
+	tStepped.Advance( 0.125f );
+	GUI_CHECK( tStepped.GetStepsLastAdvance() == 1 );
+	GUI_CHECK( tStepped.GetTime() == 0.75f );
+	tStepped.Advance( 0.f );
+	GUI_CHECK( tStepped.GetStepsLastAdvance() == 0 );
+
+	// Same deltas, same times
+	GUIClock tReplay;
+	tReplay.SetFixedTimeStep( 0.25f );
+	tReplay.Advance( 0.625f );
+	tReplay.Advance( 0.125f );
+	GUI_CHECK( tReplay.GetTime() == tStepped.GetTime() );
+	GUI_CHECK( tReplay.GetRealTime() == tStepped.GetRealTime() );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestTweenFastForward()
+{
+	unsigned int uiNumFailed = 0;
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	GUIClock& tClock = tManager.GetClock();
+	const float fPrevTimeScale = tClock.GetTimeScale();
+
+	GUIAnimation* pAnim = CreateTestElement();
+	if ( !GUI_CHECK( pAnim != 0 ) ) return uiNumFailed;
+	pAnim->SetColor( VColorRef( 255, 255, 255, 255 ) );
+
+	// One second fade stepped with the deltas given to Update
+	const GUITweenHandle tHandle = pAnim->AlphaTo( 0.f, 1.f, 0.f, &Easing::Linear::EaseIn );
+	GUI_CHECK( tHandle.IsValid() );
+	tManager.Update( 0.f ); // Start frame
+	tManager.Update( 0.25f );
+	tManager.Update( 0.25f );
+	GUI_CHECK( hkvMath::Abs( static_cast<float>( pAnim->GetTexture()->GetColor().a ) - 127.5f ) <= 2.f );
+	GUI_CHECK( !tHandle.IsFinished() );
+
+	// Twice as fast: the second half takes a quarter second
+	tClock.SetTimeScale( 2.f );
+	tManager.Update( 0.25f );
+	GUI_CHECK( pAnim->GetTexture()->GetColor().a == 0 );
+	GUI_CHECK( tHandle.IsFinished() );
+
+	tClock.SetTimeScale( fPrevTimeScale );
+	DestroyTestElement( pAnim );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestTweenRegistry()
+{
+	unsigned int uiNumFailed = 0;
+	GUITweenRegistry tRegistry;
+
+	const int iSlot = tRegistry.Acquire();
+	const GUITweenHandle tHandle = tRegistry.GetHandle( iSlot );
+	GUI_CHECK( tRegistry.Resolve( tHandle ) != 0 );
+	GUI_CHECK( tRegistry.GetNumAlive() == 1 );
+
+	// Released slot is reused under a new generation, the old handle stops resolving
+	tRegistry.Release( iSlot );
+	GUI_CHECK( tRegistry.Resolve( tHandle ) == 0 );
+	const int iReused = tRegistry.Acquire();
+	const GUITweenHandle tReusedHandle = tRegistry.GetHandle( iReused );
+	GUI_CHECK( iReused == iSlot );
+	GUI_CHECK( tReusedHandle.m_uiGeneration != tHandle.m_uiGeneration );
+	GUI_CHECK( tRegistry.Resolve( tHandle ) == 0 );
+	GUI_CHECK( tRegistry.Resolve( tReusedHandle ) == tRegistry.GetTween( iReused ) );
+	// No new slot once warm
+	GUI_CHECK( tRegistry.GetNumSlots() == 1 );
+
+	// Releasing twice does not bump the generation again nor free the slot twice
+	tRegistry.Release( iReused );
+	tRegistry.Release( iReused );
+	GUI_CHECK( tRegistry.GetNumAlive() == 0 );
+	const int iFirst = tRegistry.Acquire();
+	const int iSecond = tRegistry.Acquire();
+	GUI_CHECK( iFirst != iSecond );
+	GUI_CHECK( tRegistry.GetNumSlots() == 2 );
+	GUI_CHECK( tRegistry.Resolve( GUITweenHandle() ) == 0 );
+	tRegistry.Release( iFirst );
+	tRegistry.Release( iSecond );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestAnimClipRoundTrip()
+{
+	unsigned int uiNumFailed = 0;
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+	const std::string sPath = GUI_TESTS_PATH;
+
+	const char* pcClip =
+		"{ \"tracks\": [ { \"property\": \"alpha\", \"keys\": [ { \"time\": 0, \"value\": 0 }, { \"time\": 0.3, \"value\": 255, \"ease\": \"Quartic.EaseOut\" } ] },"
+		"              { \"property\": \"position\", \"keys\": [ { \"time\": 0.1, \"value\": [0.5, 1.2] }, { \"time\": 0.4, \"value\": [0.5, 0.5] } ] } ] }";
+	if ( !GUI_CHECK( WriteTestFile( sPath + "roundtrip.json", pcClip ) ) ) return uiNumFailed;
+
+	const GUIAnimClip* pClip = tManager.LoadAnimClip( "roundtrip.json", sPath );
+	if ( !GUI_CHECK( pClip != 0 ) ) return uiNumFailed;
+	GUI_CHECK( pClip->GetNumSegments() == 2 );
+	GUI_CHECK( IsNear( pClip->GetDuration(), 0.4f ) );
+
+	// Compiled form decodes to the same segments
+	if ( !GUI_CHECK( pClip->SaveBinary( sPath + "roundtrip" GUIANIMCLIP_BINARY_EXTENSION ) ) ) return uiNumFailed;
+	const GUIAnimClip* pBinary = tManager.LoadAnimClip( "roundtrip" GUIANIMCLIP_BINARY_EXTENSION, sPath );
+	if ( !GUI_CHECK( pBinary != 0 ) ) return uiNumFailed;
+	GUI_CHECK( pBinary->GetNumSegments() == pClip->GetNumSegments() );
+	GUI_CHECK( pBinary->GetDuration() == pClip->GetDuration() );
+	for ( unsigned int i = 0; i < hkvMath::Min( pClip->GetNumSegments(), pBinary->GetNumSegments() ); i++ )
+	{
+		const GUIAnimClip::Segment& tJSON = pClip->GetSegment( i );
+		const GUIAnimClip::Segment& tBinary = pBinary->GetSegment( i );
+		GUI_CHECK( tBinary.m_eProperty == tJSON.m_eProperty );
+		GUI_CHECK( tBinary.m_fStartTime == tJSON.m_fStartTime );
+		GUI_CHECK( tBinary.m_fDuration == tJSON.m_fDuration );
+		GUI_CHECK( memcmp( &tBinary.m_v4Start, &tJSON.m_v4Start, sizeof(hkvVec4) ) == 0 );
+		GUI_CHECK( memcmp( &tBinary.m_v4Target, &tJSON.m_v4Target, sizeof(hkvVec4) ) == 0 );
+		GUI_CHECK( tBinary.m_uiEase == tJSON.m_uiEase );
+		GUI_CHECK( tBinary.m_pfEase == tJSON.m_pfEase );
+	}
+
+	// Malformed clips are rejected as a whole
+	GUI_CHECK( WriteTestFile( sPath + "unordered.json", "{ \"tracks\": [ { \"property\": \"alpha\", \"keys\": [ { \"time\": 0.5, \"value\": 0 }, { \"time\": 0.2, \"value\": 255 } ] } ] }" ) );
+	GUI_CHECK( tManager.LoadAnimClip( "unordered.json", sPath ) == 0 );
+	GUI_CHECK( WriteTestFile( sPath + "unknown_ease.json", "{ \"tracks\": [ { \"property\": \"alpha\", \"keys\": [ { \"time\": 0, \"value\": 0 }, { \"time\": 1, \"value\": 255, \"ease\": \"Wobbly\" } ] } ] }" ) );
+	GUI_CHECK( tManager.LoadAnimClip( "unknown_ease.json", sPath ) == 0 );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestContainerReflow()
+{
+	unsigned int uiNumFailed = 0;
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+
+	GUIAnimation* apItems[3];
+	for ( unsigned int i = 0; i < 3; i++ )
+	{
+		apItems[i] = CreateTestElement();
+		if ( apItems[i] ) apItems[i]->SetSize( 100.f, 40.f );
+	}
+	GUIContainer* pContainer = tManager.CreateContainer( GCT_VERTICAL_STACK, 0 );
+	if ( GUI_CHECK( apItems[0] && apItems[1] && apItems[2] && pContainer ) )
+	{
+		pContainer->SetSpacing( 0.f, 10.f );
+		for ( unsigned int i = 0; i < 3; i++ )
+			pContainer->Add( apItems[i] );
+		pContainer->Relayout();
+		GUI_CHECK( pContainer->GetLastVisited() == 3 );
+		GUI_CHECK( pContainer->GetLastMoved() == 3 );
+		GUI_CHECK( IsNear( pContainer->GetContentHeight(), 140.f ) );
+		GUI_CHECK( !pContainer->IsDirty() );
+
+		// Resizing the middle item relayouts from it: the first one is not visited, only the last one moves
+		apItems[1]->SetSize( 100.f, 80.f );
+		GUI_CHECK( pContainer->IsDirty() );
+		pContainer->Relayout();
+		GUI_CHECK( pContainer->GetLastVisited() == 2 );
+		GUI_CHECK( pContainer->GetLastMoved() == 1 );
+		GUI_CHECK( IsNear( pContainer->GetContentHeight(), 180.f ) );
+
+		// Same size again is not a change
+		apItems[1]->SetSize( 100.f, 80.f );
+		GUI_CHECK( !pContainer->IsDirty() );
+
+		// Removing the first item moves every item after it
+		pContainer->Remove( apItems[0] );
+		pContainer->Relayout();
+		GUI_CHECK( pContainer->GetNumItems() == 2 );
+		GUI_CHECK( pContainer->GetLastMoved() == 2 );
+		GUI_CHECK( IsNear( pContainer->GetContentHeight(), 130.f ) );
+	}
+
+	if ( pContainer ) tManager.DestroyContainer( pContainer );
+	for ( unsigned int i = 0; i < 3; i++ )
+		DestroyTestElement( apItems[i] );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestTextureCache()
+{
+	unsigned int uiNumFailed = 0;
+	GUIAnimationManager& tManager = GUIAnimationManager::Instance();
+
+	GUIAnimation* pAnim = CreateTestElement();
+	if ( !GUI_CHECK( pAnim != 0 && pAnim->GetTexture()->GetTextureObject() != 0 ) )
+	{
+		DestroyTestElement( pAnim );
+		return uiNumFailed;
+	}
+	const VTextureObject* pTexture = pAnim->GetTexture()->GetTextureObject();
+	const std::map< const VTextureObject*, GUITextureCache::Entry >& hEntries = tManager.GetTextureCache().GetEntries();
+	std::map< const VTextureObject*, GUITextureCache::Entry >::const_iterator it = hEntries.find( pTexture );
+	if ( !GUI_CHECK( it != hEntries.end() ) )
+	{
+		DestroyTestElement( pAnim );
+		return uiNumFailed;
+	}
+	const GUITextureCache::Entry& tEntry = it->second;
+	GUI_CHECK( tEntry.m_uiNumElements >= 1 );
+	GUI_CHECK( tEntry.m_bResident );
+
+	// Visible: kept
+	tManager.EvictUnusedTextures();
+	GUI_CHECK( tEntry.m_bResident );
+
+	// Hidden: evicted without a cap, loaded back as soon as it is shown again, before the next draw
+	pAnim->SetVisible( false );
+	tManager.EvictUnusedTextures();
+	const bool bEvicted = !tEntry.m_bResident;
+	if ( tEntry.m_uiNumVisible == 0 ) GUI_CHECK( bEvicted ); // Another visible element may share the texture
+	const unsigned int uiNumReloads = tManager.GetTextureCache().GetStats().m_uiNumReloads;
+	pAnim->SetVisible( true );
+	GUI_CHECK( tEntry.m_bResident );
+	GUI_CHECK( pTexture->IsLoaded() );
+	GUI_CHECK( tManager.GetTextureCache().GetStats().m_uiNumReloads == uiNumReloads + ( bEvicted ? 1 : 0 ) );
+
+	// Released with its last element
+	const unsigned int uiNumElements = tEntry.m_uiNumElements;
+	DestroyTestElement( pAnim );
+	if ( uiNumElements == 1 ) GUI_CHECK( tManager.GetTextureCache().GetEntries().find( pTexture ) == tManager.GetTextureCache().GetEntries().end() );
+	return uiNumFailed;
+}
+
+unsigned int GUITests::TestSpriteBatchHeadless()
+{
+	unsigned int uiNumFailed = 0;
+	VTextureObjectPtr spPage0 = Vision::TextureManager.Load2DTexture( GUI_TESTS_PATH GUI_TESTS_TEXTURE );
+	VTextureObjectPtr spPage1 = Vision::TextureManager.Load2DTexture( GUI_TESTS_PATH GUI_TESTS_TEXTURE_2 );
+	VTextureObject* pPage0 = spPage0;
+	VTextureObject* pPage1 = spPage1;
+	if ( !GUI_CHECK( pPage0 && pPage1 && pPage0 != pPage1 ) ) return uiNumFailed;
+
+	GUISpriteBatch tBatch;
+	tBatch.SetHeadless( true );
+	const VColorRef tWhite( 255, 255, 255, 255 );
+
+	// HUD of one atlas page: a single draw whatever the number of sprites
+	tBatch.Begin();
+	for ( unsigned int i = 0; i < 150; i++ )
+		tBatch.AddQuad( pPage0, GAO_MIDDLE, i * 4.f, 0.f, 4.f, 4.f, 0.f, 0.f, 1.f, 1.f, tWhite );
+	tBatch.End();
+	GUI_CHECK( tBatch.GetStats().m_uiQuads == 150 );
+	GUI_CHECK( tBatch.GetStats().m_uiBatches == 1 );
+
+	// Two pages interleaved in the same order are grouped: one draw per page
+	tBatch.Begin();
+	for ( unsigned int i = 0; i < 10; i++ )
+		tBatch.AddQuad( ( i % 2 ) ? pPage1 : pPage0, GAO_MIDDLE, i * 4.f, 0.f, 4.f, 4.f, 0.f, 0.f, 1.f, 1.f, tWhite );
+	tBatch.End();
+	GUI_CHECK( tBatch.GetStats().m_uiQuads == 10 );
+	GUI_CHECK( tBatch.GetStats().m_uiBatches == 2 );
+
+	// Clipped out quads are not drawn
+	tBatch.Begin();
+	tBatch.SetClipRect( 0.f, 0.f, 10.f, 10.f );
+	tBatch.AddQuad( pPage0, GAO_MIDDLE, 2.f, 2.f, 4.f, 4.f, 0.f, 0.f, 1.f, 1.f, tWhite );
+	tBatch.AddQuad( pPage0, GAO_MIDDLE, 50.f, 50.f, 4.f, 4.f, 0.f, 0.f, 1.f, 1.f, tWhite );
+	tBatch.ClearClipRect();
+	tBatch.End();
+	GUI_CHECK( tBatch.GetStats().m_uiQuads == 1 );
+	GUI_CHECK( tBatch.GetStats().m_uiClippedOut == 1 );
+	return uiNumFailed;
+}
@@ -0,0 +1,36 @@
+#ifndef GUITESTS_H_INCLUDED
+#define GUITESTS_H_INCLUDED
+
+#include "GlobalTypes.h"
+
+
+#define GUI_TESTS_PATH "GUI/Tests/" // Data directory of the test files, written there when needed
+#define GUI_TESTS_TEXTURE "white.png" // Small standalone textures (SD tier), two pages for the batch counts
+#define GUI_TESTS_TEXTURE_2 "black.png"
+
+
+/*
+	Behavior tests of the GUI runtime, run headless (nothing is drawn, no input) inside an app with the engine up,
+	e.g. from a debug menu or the plugin startup of a test build. They use the manager singleton and create and delete
+	their own elements, so run them before the first screen is built. Failed checks are reported with
+	Vision::Error.Warning (expression, file and line).
+	Covered: clock fast-forward, pause and fixed step, tweens driven by the manager clock, tween handle generations,
+	clip JSON to binary round trip and malformed clips, container reflow from the changed item, texture eviction and
+	reload on show, headless batch counts.
+*/
+namespace GUITests
+{
+	// Number of failed checks, 0 when everything passed
+	unsigned int RunAll();
+
+	unsigned int TestClock();
+	unsigned int TestTweenFastForward();
+	unsigned int TestTweenRegistry();
+	unsigned int TestAnimClipRoundTrip();
+	unsigned int TestContainerReflow();
+	unsigned int TestTextureCache();
+	unsigned int TestSpriteBatchHeadless();
+}
+
+
+#endif // GUITESTS_H_INCLUDED